@@ -1,1856 +1,11337 @@
-/***    MM.C - Master Mind Game
- *
- *      (c) 1991, Benjamin W. Slivka
- *
- *      MasterMind is a game (c) 1981 Pressman Toy Corporation,
- *      200 Fifth Avenue, New York, NY  10010.
- *
- *      The object of MasterMind is to guess a secret code consisting of
- *      a series of 4 colored pegs.  Each guess results in feedback which
- *      should narrow down the possible code values.  Using this feedback,
- *      the player will (with suitable application of logic) be able to
- *      deduce the computer's code.
- *
- *      To begin, the computer builds a code of 4 colored pegs.  For
- *      example: red, white, green, yellow.  The color and order of the
- *      pegs make up the code.
- *
- *      The player then builds a guess of 4 colored pegs, and asks the
- *      computer for feedback on the guess.  The computer reports the number
- *      of pegs in the guess which match the code:
- *          (1) in both color and position, and
- *          (2) in color only
- *
- *      Any pegs counted for (1) are not eligible to be counted for (2).
- *
- *
- *      Visual Layout of Game Window
- *      ============================
- *
- *      +-+-----------------------------------------------+-+
- *      |=|                 Master Mind                   |V|
- *      +-+-----------------------------------------------+-+
- *      | Options Help                                      |
- *      +---------------------------------------------------+
- *      |            ^                                      |
- *      | cxBorder   +-- cyBorder                           |
- *      | |          V                                      |
- *      | | +---------------------------+ ^                 |
- *      | | |                           | |                 |
- *      |<+>|  Well Area                | +- cyWell         |
- *      |   |                           | |                 |
- *      |   +---------------------------+ V                 |
- *      |      ^                                   cxBorder |
- *      |      +-cyWellToMove +cxMoveToResult             | |
- *      |      V              |                           | |
- *      |     +-------------+ | +-----+ |    /----------\ | |
- *      |     |          ^  |<+>|     | |    | New Game |<+>|
- *      |     |          |  |   |     | |    \----------/   |
- *      |     |          |  |   |  R  | |                   |
- *      |     |  Move    |  |   |  e  | |    /----------\   |
- *      |     |  Area    |  |   |  s  | |<+->|  Guess   |   |
- *      |     |          |  |   |  u  |   |  \----------/   |
- *	|     | 	 |  |	|  l  |   |		    |
- *	|     | 	 |  |	|  t  |   cxWellToButton    |
- *	|     | 	 |  |	|     | 		    |
- *	|     | 	 |  |	|  A  |      +----------+   |
- *	|     | 	 |  |	|  r  |      |		|   |
- *	|     |      cyMove |	|  e  |      |		|   |
- *	|     | 	 |  |	|  a  |      |	 Fun	|   |
- *	|     | 	 |  |	|     |      |		|   |
- *	|     | 	 |  |	|     |      |	 Area	|   |
- *	|     | 	 |  |	|     |      |		|   |
- *	|     |<- cxMove -->|	|     |      |		|   |
- *	|     | 	 |  |	|<-+->|      |		|   |
- *	|     | 	 V  |	|  |  |      |		|   |
- *	|     +-------------+	+--|--+      |		|   |
- *	|	^		   |	     |		|   |
- *	|	+--cyMoveToAnswer  cxResult  |		|   |
- *	|	V			     |		|   |
- *	|     +-------------+ \ 	     |		|   |
- *	|     | Answer Area |  +- cyAnswer   |		|   |
- *	|     +-------------+ / 	     +----------+   |
- *	|	 ^					    |
- *	|	 +--cyBorder				    |
- *      |        V                                          |
- *      +---------------------------------------------------+
- *
- *
- *      Visual Layout of Peg Box
- *      ========================
- *          The "Peg Box" is the building block for the "Well Area" and the
- *      "Move Area".  It has room for a "Peg" centered inside the box.
- *
- *
- *          <-- cxPegBox --->
- *        ^ +---------------+
- *        | |               |
- *        | | cxPegOffset   |
- *          | |             | --
- *        c | |   -----     |  ^
- *        y | |  /     \    |  |
- *        P | | /       \   |  |
- *        e | | |  Peg  |   |  +-- cyPeg
- *        g |<->|       |   |  |
- *        B |   \       /   |  |
- *        o |    \     /    |  |
- *        x |     -----     |  V
- *          |       ^       | --
- *        | |       +-- cyPegOffset
- *        | |       V       |
- *        V +---------------+
- *             |         |
- *             |<---+--->|
- *                  |
- *
- *                cxPeg
- *
- *
- *      Visual Layout of Pin Box
- *      ========================
- *          The "Pin Box" is the building block for the "Result Area".
- *      It has room for up to 4 Pins grouped around the center of the box,
- *      so that Pins in one pin box do not blend visually with the pins of
- *      an adjacent Pin Box.
- *
- *
- *          <---- cxPinBox --->
- *        ^ +-----------------+
- *        | |     ^           |
- *        | |     +- cyPinOffset
- *          |     V           |
- *        c |    /-\  /-\     |
- *        y |    \-/  \-/     |
- *        P |            ^+cyPinSpace
- *        i |            V    | --
- *        n |    /-\  /-\     |  ^--cyPin
- *        B |<+->\-/  \-/     |  V
- *        o | |     <>        | --
- *        x | |      +cxPinSpace
- *          | |               |
- *        | | cxPinOffset     |
- *        | |                 |
- *        V +-----------------+
- *                   |   |
- *                   |<+>|
- *                     |
- *
- *                   cxPin
- *
- *
- *      Algorithmic Relationship Between Dimensions
- *      ===========================================
- *
- *      nPeg = 4 = number of pegs in a guess
- *      nColor = 6 = number of different colored pegs
- *
- *      cxPegBox = x width of a Peg Box
- *      cyPegBox = y width of a Peg Box
- *      cxPeg    = x width of a Peg
- *      cyPeg    = y width of a Peg
- *      cxPegOffset = x distance between edge of Peg Box and Peg
- *      cyPegOffset = y distance between edge of Peg Box and Peg
- *
- *      cxMove = nPeg * cxPegBox = x width of Move Area
- *      cyMove = maxMove * cyPegBox = y height of Move Area
- *      cxResult = x width of Result Area
- *      cyResult = cyMove = y height of Result Area
- *      cxWell = cxPegBox = x width of Well Area
- *      cyWell = nColor * cyPegBox = y height of Well Area
- *      cyBorder = y width of top and bottom border
- *      cxBorder = x width of left and right border
- *      cxButton = width of widest button (computed at run-time)
- *
- *      cxMoveToResult = cxWell - (cxMove + cxResult) = x width between
- *                                                       Move and Result Areas
- *      cxWellToButton = x width between Well Area and Buttons
- *
- *      cyWellToMove = y height between Well and Move Areas
- *
- *      cxClient = 2*cxBorder + cxWell + cxWellToButton + cxButton
- *               = x width of client area
- *
- *	cyClient = 2*cyBorder + cyWell + cyWellToMove + cyMove +
- *		      cyMoveToAnswer + cyAnswer
- *               = y height of client area
- *
- *
- *      Notes:
- *
- *      (1) The Well Area is positioned over the Move and Result Areas
- *      (2) The Move and Result Areas are centered under the Well Area
- *      (2) The Buttons are postioned to the right of the Result Area
- *
- *      "Peg Box" - The bounding rectangle of a "Peg".  This is used to
- *              to lay out the "Move Area" and "Well Area".
- *
- *      "Well Area" - The area where one peg of each color is displayed.  The
- *              user drags a peg from this "well" into the "Move Area", and
- *              over the "Active Row" to place a peg for a "Guess".
- *
- *      "Move Area" - The area where the player builds Guesses.
- *
- *      "Result Area" - The area where the results of a players guesses are
- *              displayed.  A *black* "Pin" is displayed for each Peg in the
- *              Guess that matches a Peg in the computer's "Goal" in both
- *              color and position.  A *white* Pin is displayed for each Peg
- *              in the Guess that matches a Peg in the computer's Goal in
- *              color only.
- *
- *	"Fun Area" - The area where visual indication of game won/lost occurs.
- *
- *	"Answer Area" - The area where the computer code is revealed.
- *
- *
- *      Performance Notes
- *      =================
- *      (1) We create a Memory DC to hold a bitmap that contains images of
- *          each peg, the peg hole, and all combinations of pin results.
- *          Then, when painting the board, we do a BitBlt(...,SRC_COPY,...)
- *          from the memory DC to the the screen DC!
- *
- *          Since we cleverly made <cxPegBox,cyPegBox> be the same size as
- *          <cxPinBox,cyPinBox>, all we need is (conceptually) an array of
- *          images of this size in a single bitmap.
- *
- *          We need to construct the following images in the bitmap:
- *
- *          Count   Description of Image(s)
- *          ------  --------------------------------------------------------
- *          nColor  Colored Pegs
- *          1       Peg Hole
- *          15      All possible Result Pin patterns (see below)
- *
- *          Result Pin Patterns
- *          -------------------
- *              The tricky thing here is to pack these images tightly into
- *          the bitmap, so we need a mapping from (cPos,cClr) to [0..14]:
- *
- *               i  Pos  Clr
- *              --- ---  ---
- *               0   0    0
- *               1   0    1
- *               2   0    2
- *               3   0    3
- *               4   0    4
- *               5   1    0
- *               6   1    1
- *               7   1    2
- *               8   1    3
- *               9   2    0
- *              10   2    1
- *              11   2    2
- *              12   3    0
- *              13   3    1
- *              14   4    0
- *
- *          The solution is a two-dimensional array, mpResultToLibrary,
- *          indexed by cPos and cClr.  We build this array as we build
- *          the images in the image bitmap.  For valid combinations, we
- *          store the index of the image in the Bitmap into the array.
- *          For invalid combinations, the array entry is set to -1.
- *
- *      (2) A Performance vs. Size Tradeoff in the organization of the
- *          Image Library Bitmap.
- *
- *          We can either construct this as a horizontal vector of images,
- *          or a vertical vector of images.
- *
- *          A horizontal organization is likely to consume less memory, since
- *          the bitmap will (we presume) only waste space at the end of a
- *          row -- and there will only be *cxPegBox* rows.  However, this
- *          is could lead to non-byte-aligned BitBlts, which are slower.
- *
- *          A vertical organization, on the other hand, ensures that at least
- *          the source bitmap is aligned on a byte boundary.  The cost is that
- *          we may waste some bytes at the end of each pixel row.  Since we
- *          are using BitBlt for speed, we will continue to follow that maxim
- *          here.
- */
-
-#include <windows.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#include "mm.h"
-
-
-/**************
- *** Macros *****************************************************************
- **************/
-
-#define MIR(x)  MAKEINTRESOURCE(x)  // Make DialogBox lines shorter
-
-#define AssertMsg(x)        // BUGBUG - Enable this for DEBUG build
-
-
-/*****************
- *** Constants **************************************************************
- *****************/
-
-#define cbMaxString   100       // Length of longest string resource
-
-#define nColor          6       // Number of colors
-#define nPeg            4       // Number of pegs per move
-#define maxMove        10       // Maximum number of moves
-
-#define nPin            2       // Number of result pin colors
-
-#define cxPegBox       24               // x width of a Peg Box
-#define cyPegBox       24               // y height of a Peg Box
-
-#define cxPeg          16               // x width of a Peg
-#define cyPeg          16               // y height of a Peg
-
-#define cxPegOffset ((cxPegBox-cxPeg)/2) // x offset of Peg in Peg Box
-#define cyPegOffset ((cyPegBox-cyPeg)/2) // y offset of Peg in Peg Box
-
-#define cxPegHole       8               // x width of a Peg Hole
-#define cyPegHole       8               // y height of a Peg Hole
-
-#define cxPegHoleOffset ((cxPegBox-cxPegHole)/2) // x offset of Peg Hole
-#define cyPegHoleOffset ((cyPegBox-cyPegHole)/2) // y offset of Peg Hole
-
-#define cxPinBox    (cxPegBox)          // x width of a Pin Box
-#define cyPinBox    (cyPegBox)          // y width of a Pin Box
-
-#define cxPin           6               // x width of a Pin
-#define cyPin           6               // y width of a Pin
-
-#define cxPinSpace  (cxPin/2)           // x distance between Pins in Pin Box
-#define cyPinSpace  (cyPin/2)           // y distance between Pins in Pin Box
-
-#define cxPinOffset ((cxPinBox-2*cxPin-cxPinSpace)/2) // x offset of Pin
-#define cyPinOffset ((cyPinBox-2*cyPin-cyPinSpace)/2) // y offset of Pin
-
-
-#define cxImageBoxOffset  1         // x border around image
-#define cyImageBoxOffset  1         // y border around image
-
-#define cxImageBox  (cxPegBox - 2*cxImageBoxOffset)
-#define cyImageBox  (cyPegBox - 2*cyImageBoxOffset)
-
-#define nLibraryImage (nColor+1+15) // Colors + Peg Hole + Result Pin Patterns
-				    // See "Performance Notes (1)" above.
-#define cxLibrary   (cxImageBox)          // Width of Image Library Bitmap
-#define cyLibrary   (cyImageBox*nLibraryImage) // Height of Image Library Bitmap
-
-
-#define cxMove      (nPeg*cxPegBox)     // x width of Move Area
-#define cyMove      (maxMove*cyPegBox)  // y height of Move Area
-
-#define cyBorder        8               // y width of client border
-#define cxBorder        8               // x width of client border
-
-#define cxResult    (cxPinBox)          // x width of Result Area
-#define cyResult    (cyMove)            // y height of Result Area
-
-#define cxWell      (nColor*cxPegBox)   // x width of Well Area
-#define cyWell      (cyPegBox)          // y height of Well Area
-
-#define cxMoveToResult    8             // x width between Move and Result Area
-#define cxWellToButton    8             // x width between Result Area & Buttons
-
-#define cyWellToMove      8             // y height between Well and Move Area
-#define cyMoveToAnswer	  8		// y height between Move and Answer Area
-
-#define xWell   (cxBorder)              // x left of Well Area
-#define xMove   (xWell + (cxWell - (cxMove+cxResult+cxMoveToResult))/2)
-#define xResult (xMove+cxMove+cxMoveToResult) // x left of Result Area
-#define xButton (xWell+cxWell+cxWellToButton) // x left of Buttons
-
-#define yWell   (cyBorder)              // y top of Well Area
-#define yMove   (yWell+cyWell+cyWellToMove)  // y top of Move Area
-#define yResult (yMove)                 // y top of Result Area
-#define yButton (cyBorder)              // y top of Buttons
-
-#define xAnswer  (xMove)
-#define yAnswer  (yMove + cyMove + cyMoveToAnswer)
-#define cxAnswer (cxMove)
-#define cyAnswer (cyPegBox)
-
-/*
- *  Rectangle to bound cursor while dragging a peg
- */
-#define xCursorLeft     xWell
-#define yCursorTop      yWell
-#define xCursorRight    (xWell+cxWell)
-#define yCursorBottom   (yMove+cyMove)
-
-
-/************************
- *** Type Definitions *******************************************************
- ************************/
-
-typedef int PEG; /* peg */  // Peg value
-#define PEG_BLANK   (nColor)    // PEG color of empty peg box
-
-
-typedef PEG GUESS[nPeg]; /* guess */
-
-typedef struct _MOVE {  /* mv */
-    GUESS   guess;          // The guess
-    int     cPosition;      // Pegs that match both position and color
-    int     cColor;         // Pegs that match color but not position
-} MOVE, *PMOVE;
-
-typedef struct _GLOBAL { /* g */  // Global Variables
-    HWND    hwnd;               // Client window
-    int     cxMain;		// X width of main window
-    int     cyMain;		// Y width of main window
-    int     cxClient;           // X width of client area of window
-    int     cyClient;           // Y width of client area of window
-    int     cxButton;           // X width of widest button
-    int     cyButton;           // Y height of tallest button
-    int     cyButtonSpace;      // Y separation between buttons
-    int     xFun;		// X of Fun area
-    int     yFun;		// Y of Fun area
-    int     cxFun;		// X width of Fun area
-    int     cyFun;		// Y height of Fun area
-    GUESS   guessCode;          // The code
-    int     iMove;              // Current move index
-    PEG     pegMove;            // Peg value being dragged
-    MOVE    amove[maxMove];     // The game history
-    HANDLE  hInstance;          // App instance handle
-    FARPROC lpfnAboutDlgProc;   // About DlgProc instance function pointer
-    BOOL    fGameOver;		// TRUE => current game is over
-    BOOL    fGameWon;		// TRUE => player won current game
-    BOOL    fGuessAllowed;	// TRUE => guess button enabled
-    HDC     hdcLibrary;         // HDC for Image Library
-    HBITMAP hbmLibrary;         // HBM for Image Library
-    HCURSOR hcurCurrent;        // Current cursor
-    HCURSOR hcurDefault;        // Default cursor
-    HCURSOR hcurOverWell;       // Cursor when over Well, but not dragging
-    HCURSOR hcurDrag;           // Cursor during Drag
-    HCURSOR hcurDragOver;       // Cursor at Drag Over Move row in Move Area
-    HFONT   hfntButton; 	// Button font
-} GLOBAL,*PGLOBAL;
-
-
-// Where is the Mouse?
-typedef enum {WH_NOTOURS,WH_WELL, WH_MOVE} WHERE; /* wh */
-
-
-// BUTTON - Information used to create a button in the client area.
-typedef struct tagButtonDescription { /* btn */
-    int     ids;    // String ID in resource file
-    int     idc;    // Command ID
-    long    style;  // Button Style
-    HWND    hwnd;   // Button window handle
-} BUTTON, *PBUTTON;
-
-
-/*****************
- *** Variables **************************************************************
- *****************/
-
-GLOBAL g;   // Globals
-
-DWORD   clrPeg[nColor] = {  // Maps PEG value to screen color
-    CLR_BLACK,
-    CLR_BLUE,
-    CLR_GREEN,
-    CLR_YELLOW,
-    CLR_RED,
-    CLR_WHITE,
-    };
-
-// Brush indicies for painting pins
-int aPinColor[nPin] = {
-    BLACK_BRUSH,    // Match Position and Color
-    WHITE_BRUSH,    // Match Color but not Position
-};
-
-// Client-Area button definitions
-BUTTON abutton[] = {
-  /* string id     control ID    style          hwnd */
-  /* ---------     ------------  -------------  ---- */
-    {IDS_NEW_GAME, IDC_NEW_GAME, BS_PUSHBUTTON, NULL},
-    {IDS_GUESS,    IDC_GUESS   , BS_PUSHBUTTON, NULL},
-};
-#define nButton (sizeof(abutton)/sizeof(BUTTON))
-
-// Button indicies
-#define iButtonNewGame  0
-#define iButtonGuess    1
-
-
-// mpResultToImage - This array is used to find the index in the Image
-//      Library Bitmap of a particular Result.  The first index is the
-//      cPosition, the second index is the cColor.
-//
-//      CreateImageLibrary initializes this array.
-
-int mpResultToLibrary[nPeg+1][nPeg+1];
-
-
-/***************************
- *** Function Prototypes ****************************************************
- ***************************/
-
-int PASCAL WinMain(HANDLE hInstance,
-		   HANDLE hPrevInstance,
-		   LPSTR lpszCmdLine,
-		   int nCmdShow);
-
-BOOL FAR PASCAL AboutDlgProc(HWND hDlg,UINT msg,UINT wParam,LONG lParam);
-long FAR PASCAL WndProc(HWND hDlg,UINT msg,UINT wParam,LONG lParam);
-
-BOOL   BeginMM(HANDLE hInstance,HANDLE hPrevInstance);
-VOID   CreateButtons(HWND hwnd);
-VOID   CreateImageLibrary(HDC hdcDisplay);
-VOID   DestroyButtons(VOID);
-VOID   DoCommand(HWND hwnd,UINT wParam,LONG lParam);
-BOOL   DoMouse(HWND hwnd,UINT msg,UINT wParam,LONG lParam);
-VOID   EndMM(VOID);
-VOID   EraseForNewGame(HWND hwnd);
-VOID   FastSetCursor(HCURSOR hcur);
-BOOL   MouseInArea(int xM,int yM,int x,int y,int cx,int cy);
-VOID   NewGame(VOID);
-BOOL   QueryResignGame(HWND hwnd);
-VOID   PaintAnswer(HWND hwnd);
-VOID   PaintAnswerSub(HDC hdc);
-VOID   PaintBoard(HDC hdc);
-VOID   PaintHolesForPegs(HWND hwnd);
-VOID   PaintLibrary(HDC hdc, int x, int y, int iLibrary);
-VOID   PaintPeg(HWND hwnd, int ix, int iy);
-VOID   PaintPegSub(HWND hwnd, int ix, int iy);
-VOID   PaintResult(HWND hwnd);
-VOID   PaintResultSub(HDC hdc, int iMove);
-VOID   PickCode(VOID);
-VOID   PlayerLost(HWND hwnd);
-VOID   PlayerLostSub(HDC hdc);
-VOID   PlayerTextOut(HDC hdc, char *psz);
-VOID   PlayerWon(HWND hwnd);
-VOID   PlayerWonSub(HDC hdc);
-VOID   Randomize(VOID);
-VOID   ReleaseMouse(VOID);
-VOID   SetMouse(HWND hwnd);
-BOOL   TestGuess(VOID);
-
-
-/***************
- *** WinMain ****************************************************************
- ***************/
-
-int PASCAL WinMain(HANDLE hInstance,
-		   HANDLE hPrevInstance,
-		   LPSTR lpszCmdLine,
-		   int nCmdShow)
-{
-    MSG         msg;
-
-    if (!BeginMM(hInstance,hPrevInstance))
-	exit(1);
-
-    //  Show window
-
-    ShowWindow(g.hwnd,nCmdShow);
-    UpdateWindow(g.hwnd);
-
-    while(GetMessage(&msg,NULL,0,0))
-	{
-	TranslateMessage(&msg);
-	DispatchMessage(&msg);
-	}
-
-    EndMM();
-
-    return msg.wParam;
-}
-
-
-/************************************************
- *** Functions - Listed in Alphabetical Order *******************************
- ************************************************/
-
-/***    AboutDlgProc - About Dialog Box Procedure
- *
- */
-BOOL FAR PASCAL AboutDlgProc(HWND hdlg,UINT msg,UINT wParam,LONG lParam)
-{
-    switch (msg)
-	{
-	case WM_INITDIALOG:
-	    return TRUE;
-
-	case WM_COMMAND:
-	    switch (wParam)
-		{
-		case IDOK:
-		case IDCANCEL:
-		    EndDialog(hdlg, 0);
-		    return TRUE;
-		}
-	    break;
-	}
-    return FALSE;
-}
-
-
-/***    BeginMM - Initialize MasterMind
- *
- */
-BOOL BeginMM(HANDLE hInstance,HANDLE hPrevInstance)
-{
-    char        ach[cbMaxString];
-    int         cch;
-    int         cchButton;
-    int         cxChar;
-    int         cyChar;
-    HDC         hdc;
-    HFONT	hfnt;
-    int         i;
-    long        lStyle;
-    static char szAppName [] = "MastMind";
-    TEXTMETRIC  tm;
-    WNDCLASS    wndclass;
-
-    // Randomize number generator
-    Randomize();
-
-    // Save hInstance
-    g.hInstance = hInstance;
-
-    // Load Cursors
-
-    g.hcurDefault  = LoadCursor(NULL,IDC_ARROW);
-    g.hcurCurrent  = g.hcurDefault;  // Assume current is default
-    g.hcurOverWell = LoadCursor(g.hInstance,MIR(CUR_OVER_WELL));
-    g.hcurDrag     = LoadCursor(g.hInstance,MIR(CUR_DRAG));
-    g.hcurDragOver = LoadCursor(g.hInstance,MIR(CUR_DRAG_OVER));
-
-    // Register window class, if necessary
-    if (!hPrevInstance)
-	{
-	wndclass.style	       = CS_DBLCLKS;
-	wndclass.lpfnWndProc   = WndProc;
-	wndclass.cbClsExtra    = 0;
-	wndclass.cbWndExtra    = 0;
-	wndclass.hInstance     = g.hInstance;
-	wndclass.hIcon         = LoadIcon(hInstance, szAppName);
-	wndclass.hCursor       = NULL;  // We want total control of cursor
-	wndclass.hbrBackground = COLOR_APPWORKSPACE+1;
-	wndclass.lpszMenuName  = szAppName;
-	wndclass.lpszClassName = szAppName;
-
-	RegisterClass(&wndclass);
-	}
-
-    // Get system font metrics (to size buttons)
-    hdc = CreateDC("DISPLAY",NULL,NULL,NULL);
-
-    // Create Image Library DC and Bitmap
-
-    CreateImageLibrary(hdc);
-
-    // Get button font
-
-    g.hfntButton = GetStockObject(SYSTEM_FONT);
-
-    if (g.hfntButton == 0) {
-	// BUGBUG bens 01-Jul-1991 Create Font failed
-    }
-
-    // Get Font Metrics for sizing buttons
-
-    hfnt = SelectObject(hdc,g.hfntButton);
-    GetTextMetrics(hdc, &tm);
-    cxChar = tm.tmAveCharWidth;
-    cyChar = tm.tmHeight + tm.tmExternalLeading;
-
-    // Done with Display DC
-
-    SelectObject(hdc,hfnt);         // Restore original font
-    DeleteDC(hdc);
-
-
-    // Compute button dimensions
-
-    cchButton = 0;
-    for (i=0; i<nButton; i++) { // Get length of longest string
-	cch = LoadString(g.hInstance,abutton[i].ids,ach,sizeof(ach));
-	cchButton = max(cch,cchButton);
-    }
-
-    g.cxButton = (cchButton+4)*cxChar; // Give 2 char room on either side
-    g.cyButton = (7 * cyChar) / 4;  // BUGBUG - Magic number from petzold ex.
-    g.cyButtonSpace = g.cyButton/2;     // Button Spacing
-
-
-    // Compute size of client area and main window
-
-    g.cxClient = 2*cxBorder + cxWell + cxWellToButton + g.cxButton;
-
-    g.cyClient = 2*cyBorder + cyWell +
-		   cyWellToMove + cyMove +
-		   cyMoveToAnswer + cyAnswer;
-
-    g.cxMain   = g.cxClient +
-		 GetSystemMetrics(SM_CXBORDER);
-
-    g.cyMain   = g.cyClient +
-		 GetSystemMetrics(SM_CYBORDER) +
-		 GetSystemMetrics(SM_CYCAPTION) +
-		 GetSystemMetrics(SM_CYMENU);
-
-
-    // Compute Fun area dimensions
-
-    g.xFun  = xButton;
-    g.yFun  = yButton + 2*(g.cyButton+g.cyButtonSpace);
-    g.cxFun = g.cxButton;
-    g.cyFun = g.cyClient - (g.yFun+cyBorder);
-
-
-    // Create main window
-
-    LoadString(g.hInstance,IDS_APP_TITLE,ach,sizeof(ach));
-    lStyle = WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX;
-    g.hwnd = CreateWindow(
-		szAppName,          // Window class
-		ach,                // Window Title
-		lStyle,             // Window Style
-		CW_USEDEFAULT,      // Left edge of window
-		CW_USEDEFAULT,      // Top edge of window
-		g.cxMain,	    // Width of window
-		g.cyMain,	    // Height of window
-		NULL,               // Parent window
-		NULL,               // Control ID
-		hInstance,          // App instance
-		NULL                // lpCreateStruct
-	     );
-
-    // Create dialog procedure instance(s)
-    g.lpfnAboutDlgProc = MakeProcInstance(AboutDlgProc,g.hInstance);
-
-    return TRUE;
-}
-
-
-/***    CreateButtons - Create buttons in client area
- *
- */
-VOID CreateButtons(HWND hwnd)
-{
-    char        ach[cbMaxString];
-    HFONT	hfnt;
-    int         i;
-    long        lStyle;
-    int         x,y;
-
-    hfnt = GetStockObject(ANSI_VAR_FONT);   // Font for button text
-
-    x = xButton;
-    y = yButton;
-
-    for (i=0; i<nButton; i++) {
-	LoadString(g.hInstance,abutton[i].ids,ach,sizeof(ach));
-	lStyle = WS_CHILD | abutton[i].style;
-	abutton[i].hwnd = CreateWindow(
-	    "button",           // Window class
-	    ach,                // Button text
-	    lStyle,             // Button style;
-	    x,                  // Left edge of button
-	    y,                  // Top edge of button
-	    g.cxButton,         // Width of button
-	    g.cyButton,         // Height of button
-	    hwnd,               // Parent window (gets BM_ messages)
-	    abutton[i].idc,     // Button Control ID
-	    g.hInstance,        // App instance
-	    NULL);              // lpCreateStruct
-	y += (g.cyButton + g.cyButtonSpace);  // Advance button position
-
-	// Set button font
-	SendMessage(abutton[i].hwnd,WM_SETFONT,g.hfntButton,FALSE);
-
-	// Show button
-	ShowWindow(abutton[i].hwnd,SW_SHOWNORMAL);
-    }
-}
-
-
-/***    CreateImageLibrary - Create bitmap with all peg and pin images
- *
- *      Entry
- *          hdc - Display DC
- */
-VOID CreateImageLibrary(HDC hdcDisplay)
-{
-    int     acPins[2];
-    int     cPinsPainted;
-    HPEN    hpenSave;
-    HBRUSH  hbrush;
-    HBRUSH  hbrushLast;
-    HBRUSH  hbrushSave;
-    HDC     hdc;
-    int     i;
-    int     iClr;
-    int     iLoop;
-    int     iPinBox;
-    int     iPos;
-    int     x1,y1,x2,y2;
-
-    // Create Image Library Bitmap -- Same color depth as display!
-    g.hbmLibrary = CreateCompatibleBitmap(hdcDisplay,cxLibrary,cyLibrary);
-
-    // Create the memory DC
-    hdc = CreateCompatibleDC(hdcDisplay); // Image Library DC
-    g.hdcLibrary = hdc;                 // Save so we can free it at exit
-
-    SelectObject(hdc,g.hbmLibrary);     // Select bitmap into DC
-
-    // Set desired pen/brush and save default pen/brush
-
-    hpenSave = SelectObject(hdc,GetStockObject(BLACK_PEN));
-    hbrushSave = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
-
-    // Fill bitmap with background color (selected brush above!)
-
-    PatBlt(hdc,0,0,cxLibrary,cyLibrary,PATCOPY);
-
-    // Draw Color Pegs
-
-    x1 = cxPegOffset - cxImageBoxOffset;
-    x2 = x1+cxPeg;
-
-    y1 = cyPegOffset - cyImageBoxOffset;
-    for (i=0; i<nColor; i++) {
-	y2 = y1+cyPeg;
-	hbrush = CreateSolidBrush(clrPeg[i]); // Get brush for peg color
-	hbrushLast = SelectObject(hdc,hbrush);
-	if (i > 0)                      // Have a brush from last iteration
-	    DeleteObject(hbrushLast);   // Delete it!
-	Ellipse(hdc,x1,y1,x2,y2);
-	y1 += cyImageBox;
-    }
-
-    // Now, we have to delete the brush we created in the final iteration.
-    // So, we select in the brush we need for drawing the peg hole, and then
-    // we are able to delete that last brush we created!
-
-    hbrush = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
-    DeleteObject(hbrush);               // Delete brush from final iteration
-
-    //
-    // Draw Peg Hole
-    //
-
-    x1 = cxPegHoleOffset - cxImageBoxOffset;
-    x2 = x1 + cxPegHole;
-
-    y1 = nColor*cyImageBox + cyPegHoleOffset - cyImageBoxOffset;
-    y2 = y1 + cyPegHole;
-
-    Ellipse(hdc,x1,y1,x2,y2);
-
-    //
-    // Draw all valid combinations of Result Pin Patterns
-    //
-
-    iPinBox = nColor + 1;               // Index of first pin box in Library
-    for (iPos=0; iPos<=nPeg; iPos++) {
-	for (iClr=0; iClr<=nPeg; iClr++) {
-	    if ((iPos+iClr) > nPeg) {   // Invalid combination
-		mpResultToLibrary[iPos][iClr] = -1; // No image index
-		continue;               // Do next iteration of for loop!
-	    }
-
-	    mpResultToLibrary[iPos][iClr] = iPinBox; // Set image index
-
-	    acPins[0] = iPos;           // Set count of positions for painting
-	    acPins[1] = iClr;           // Set count of colors for painting
-
-	    cPinsPainted = 0;           // No pins painted in this box, yet
-
-	    x1 = cxPinOffset - cxImageBoxOffset;
-	    y1 = iPinBox*cyImageBox + cyPinOffset - cyImageBoxOffset;
-
-	    // Paint black, then white pins
-	    for (iLoop=0; iLoop<nPin; iLoop++) {
-		// Select color
-		SelectObject(hdc,GetStockObject(aPinColor[iLoop]));
-
-		// Paint pins of this color
-		for (i=0; i<acPins[iLoop]; i++) {
-		    x2 = x1 + cxPin;
-		    y2 = y1 + cyPin;
-		    Ellipse(hdc,x1,y1,x2,y2); // Draw pin
-		    x1 = x2 + cxPinSpace;     // x for second pin
-		    cPinsPainted++;
-		    if (cPinsPainted == 2) {  // Wrap to second row of pins
-			x1 = cxPinOffset - cxImageBoxOffset; // x of third pin
-			y1 = y2 + cyPinSpace; // y for third and fourth pins
-		    }
-		}
-	    }
-	    iPinBox++;                  // Count Result Pin Pattern
-	}
-    }
-
-    //
-    // Set restore original pen/brush
-    //
-
-    SelectObject(hdc,hpenSave);
-    SelectObject(hdc,hbrushSave);
-}
-
-
-/***    DestroyButtons - Destroy buttons in client area
- *
- */
-VOID DestroyButtons()
-{
-    int         i;
-
-    for (i=0; i<nButton; i++) {
-	DestroyWindow(abutton[i].hwnd);
-#ifdef DEBUG
-	abutton[i].hwnd = NULL;
-#endif
-    }
-}
-
-
-/***    DoCommand - Handle COMMAND messages
- *
- */
-VOID DoCommand(HWND hwnd,UINT wParam,LONG lParam)
-{
-    BOOL        f;
-
-    switch (wParam) {
-	case IDM_ABOUT:
-	    DialogBox(g.hInstance,MIR(IDD_ABOUT),hwnd,g.lpfnAboutDlgProc);
-	    return;
-
-	case IDC_GUESS:
-	    f = TestGuess();
-	    PaintResult(hwnd);  // Show result
-
-	    // Disable Guess button
-	    EnableWindow(abutton[iButtonGuess].hwnd,FALSE);
-	    g.fGuessAllowed = FALSE;
-
-	    if (f) {    // Guess is correct
-		PlayerWon(hwnd); // Indicate a win
-
-		// Show answer
-		PaintAnswer(hwnd);
-
-		// Game won, disable play until New Game selected
-		g.fGameOver = TRUE;
-		g.fGameWon = TRUE;
-	    }
-	    else {  // Guess is not correct
-		g.iMove++;  // Advance to next row
-		if (g.iMove >= maxMove) { // Used up all guesses
-
-		    // Reset move index to last row, to keep PaintBoard
-		    // from crashing
-		    g.iMove = maxMove - 1;
-
-		    // Indicate the loss
-		    PlayerLost(hwnd);
-
-		    // Show answer
-		    PaintAnswer(hwnd);
-
-		    // Disable play until New Game selected
-		    g.fGameOver = TRUE;
-		    g.fGameWon = FALSE;
-		}
-		else {  // Player still has more guess(s) to make
-		    PaintHolesForPegs(hwnd); // Show where next moves go
-		}
-	    }
-	    return;
-
-	case IDC_NEW_GAME:
-	    if ( (g.iMove > 0) && (!g.fGameOver) ) { // Is game in progress?
-		// Verify that user wants to resign current game
-		if (QueryResignGame(hwnd)) {
-		    // Yes, user wants to resign.
-
-		    // Indicate loss
-		    PlayerLost(hwnd);
-
-		    // Show answer
-		    PaintAnswer(hwnd);
-
-		    // Disable play until New Game selected
-		    g.fGameOver = TRUE;
-		    g.fGameWon = FALSE;
-		}
-		else // No, user does not want to resign
-		    return; // Ignore command
-	    }
-	    else {  // No game underway, do new game
-		NewGame();  // New game
-		EraseForNewGame(hwnd);
-	    }
-	    return;
-    }
-}
-
-
-/***    DoMouse - Handle mouse messages
- *
- *	Entry
- *	    Mouse message
- *
- *	Exit
- *	    Return TRUE if we handled message
- *	    Return FALSE if caller should handle message
- */
-BOOL DoMouse(HWND hwnd,UINT msg,UINT wParam,LONG lParam)
-{
-    int     i;
-    int     iWell;
-    int     ixMove,iyMove;
-    int     j;
-    WHERE   wh;
-    int     x,y;
-
-    static  BOOL    fDragging=FALSE;    // TRUE ==> Peg being dragged
-    static  int     ixMoveSrc,iyMoveSrc; // Source of copy/drag in Move Area
-    static  PEG     pegColor;           // Color of peg being moved
-    static  WHERE   whSource;           // Where Peg came from during drag
-
-    // Get mouse coordinates
-
-    x = LOWORD(lParam);
-    y = HIWORD(lParam);
-
-    // Figure out where mouse is
-
-    if (MouseInArea(x,y,xWell,yWell,cxWell,cyWell)) {
-	wh = WH_WELL;	// Mouse in Well Area
-	iWell = (x-xWell)/cxPegBox; // Color selected
-    }
-    else if (MouseInArea(x,y,xMove,yMove,cxMove,cyMove)) {
-	wh = WH_MOVE;	// Mouse in Move Area
-	ixMove = (x-xMove)/cxPegBox; // Column selected
-	iyMove = (y-yMove)/cyPegBox; // Row selected
-    }
-    else {
-	wh = WH_NOTOURS;// Mouse is someplace else
-    }
-
-    // Now handle mouse message
-
-    switch (wh) {
-
-    case WH_NOTOURS:
-	switch (msg) {
-	case WM_MOUSEMOVE:
-	    if (fDragging)
-		FastSetCursor(g.hcurDrag);
-	    else
-		FastSetCursor(g.hcurDefault);
-	    return TRUE;
-	    break;
-
-	case WM_LBUTTONUP:
-	    if (fDragging) {
-		fDragging = FALSE;
-		ReleaseMouse();
-		FastSetCursor(g.hcurDefault);
-	    }
-	    else
-		FastSetCursor(g.hcurDefault);
-	    return TRUE;            // We handled message
-	}
-	break;
-
-    case WH_WELL:
-	switch (msg) {
-	case WM_MOUSEMOVE:
-	    if (fDragging)
-		FastSetCursor(g.hcurDrag);
-	    else
-		FastSetCursor(g.hcurOverWell);
-	    return TRUE;
-
-	case WM_LBUTTONDOWN:
-	    pegColor = iWell;           // Record color
-	    fDragging = TRUE;           // Note that we are dragging
-	    whSource = WH_WELL;         // It came from Well Area
-	    SetMouse(hwnd);             // Get that mouse
-	    FastSetCursor(g.hcurDrag);  // Change cursor
-	    return TRUE;                // We handled message
-
-	case WM_LBUTTONUP:
-	    if (fDragging) {
-		fDragging = FALSE;
-		ReleaseMouse();
-	    }
-	    FastSetCursor(g.hcurOverWell);
-	    return TRUE;                // We handled message
-	}
-	break;
-
-    case WH_MOVE:
-	switch (msg) {
-	case WM_MOUSEMOVE:
-	    if (fDragging) {
-		if (iyMove == g.iMove)  // Over possible drop target
-		    FastSetCursor(g.hcurDragOver);
-		else
-		    FastSetCursor(g.hcurDrag);
-	    }
-	    else if (g.amove[iyMove].guess[ixMove] != PEG_BLANK)
-		FastSetCursor(g.hcurOverWell); // Player can move/copy this peg
-	    else
-		FastSetCursor(g.hcurDefault);
-	    return TRUE;
-
-	case WM_LBUTTONDOWN:
-	    pegColor = g.amove[iyMove].guess[ixMove]; // Record color
-	    if (pegColor == PEG_BLANK)  // No peg in that position
-		return TRUE;            // We handled message
-
-	    ixMoveSrc = ixMove;         // Keep track of source of drag/copy
-	    iyMoveSrc = iyMove;
-
-	    fDragging = TRUE;           // We are dragging
-	    whSource = WH_MOVE;         // It came from Move Area
-	    SetMouse(hwnd);             // Get that mouse
-	    FastSetCursor(g.hcurDrag);  // Set cursor
-	    return TRUE;                // We handled message
-
-	case WM_LBUTTONDBLCLK:
-	    if (iyMove == g.iMove) {	// Double Click occured on play row
-		// Check for first move
-		if (g.iMove == 0)	// If this is the first row
-		    return TRUE;	//  Do nothing
-
-		// Copy move down from previous row
-		for (i=0; i<nPeg; i++)
-		    g.amove[iyMove].guess[i] = g.amove[iyMove-1].guess[i];
-
-		// Paint pegs we just moved
-		// BUGBUG 03-Jul-1991 bens Would be faster to create DC once
-		for (i=0; i<nPeg; i++) {
-		    PaintPeg(hwnd,i,g.iMove);
-		}
-
-		// Turn on Guess button
-		EnableWindow(abutton[iButtonGuess].hwnd,TRUE);
-		g.fGuessAllowed = TRUE;
-
-		// NOTE: The button up message will change the cursor, so
-		//	 we do not do it here.
-	    }
-	    return TRUE;
-
-	case WM_LBUTTONUP:
-	    if (fDragging) {
-		fDragging = FALSE;      // No longer dragging
-		ReleaseMouse();
-
-		// Only do move if in active play row
-
-		if (iyMove != g.iMove) { // Drop did not occur on play row
-		    if (g.amove[iyMove].guess[ixMove] != PEG_BLANK)
-			FastSetCursor(g.hcurOverWell); // Move/Copy valid
-		    else
-			FastSetCursor(g.hcurDefault);
-		    return TRUE;        // We handled message
-		}
-
-		j = g.amove[iyMove].guess[ixMove]; // Remember destination
-
-		// Set color of destination
-
-		g.amove[iyMove].guess[ixMove] = pegColor; // dst = src
-		PaintPeg(hwnd,ixMove,iyMove); // Paint Peg
-
-		// See if we have to do a move/exchange
-
-		if (whSource == WH_MOVE) {  // Do Move or Exchange
-		    if (iyMoveSrc == iyMove) {  // Do exchange
-			g.amove[iyMoveSrc].guess[ixMoveSrc] = j; // src = dst
-			PaintPeg(hwnd,ixMoveSrc,iyMoveSrc);
-		    }
-		}
-
-		// Finally, if all pegs are placed, enable Guess button
-		j = 0;
-		for (i=0; i<nPeg; i++) {    // Count number of pegs
-		    if (g.amove[iyMove].guess[i] != PEG_BLANK) {
-			j++;
-		    }
-		}
-		if (j == nPeg) {
-		    EnableWindow(abutton[iButtonGuess].hwnd,TRUE);
-		    g.fGuessAllowed = TRUE;
-		}
-	    }
-	    if (g.amove[iyMove].guess[ixMove] != PEG_BLANK)
-		FastSetCursor(g.hcurOverWell); // Player can move/copy this peg
-	    else
-		FastSetCursor(g.hcurDefault);
-	    return TRUE;                // We handled message
-	}
-	break;
-
-    default:
-	AssertMsg("Unexpected where value.");
-    }
-
-    // We did not handle message
-    return FALSE;
-}
-
-
-/***    EndMM - End MasterMind
- *
- */
-VOID EndMM(VOID)
-{
-    // Free dialog procedure instances
-
-    FreeProcInstance(g.lpfnAboutDlgProc);
-
-    // Free image library DC and Bitmap
-    // BUGBUG - Is it okay to delete DC and then Bitmap?  This is how
-    //          petzold does it.  This is different than everything other
-    //          object selected into a DC, where you must first select
-    //          back in the original object.
-
-    DeleteDC(g.hdcLibrary);
-    DeleteObject(g.hbmLibrary);
-
-    // Free cursors
-
-    // NOTE: Do not free g.hcurDefault -- it is a SYSTEM cursor!
-    DestroyCursor(g.hcurOverWell);
-    DestroyCursor(g.hcurDrag);
-    DestroyCursor(g.hcurDragOver);
-}
-
-
-/***    EraseForNewGame - Erase Result and Move Areas
- *
- */
-VOID EraseForNewGame(HWND hwnd)
-{
-    HBRUSH  hbrush;
-    HDC     hdc;
-    HPEN    hpen;
-    int     ix;
-
-    hdc = GetDC(hwnd);
-
-    // Set desired pen/brush and save default pen/brush
-    hpen = SelectObject(hdc,GetStockObject(BLACK_PEN));
-    hbrush = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
-
-    // Clear Result, Move, and Fun Areas
-    Rectangle(hdc,xResult,yResult,xResult+cxResult,yResult+cyResult);
-    Rectangle(hdc,xMove,yMove,xMove+cxMove,yMove+cyMove);
-    Rectangle(hdc,xAnswer,yAnswer,xAnswer+cxAnswer,yAnswer+cyAnswer);
-    Rectangle(hdc,g.xFun,g.yFun,g.xFun+g.cxFun,g.yFun+g.cyFun);
-
-    // Paint Peg Holes in Move Area for 1st Move
-
-    for (ix=0; ix<nPeg; ix++) {
-	PaintPegSub(hdc,ix,0);
-    }
-
-    // Restore default pen and brush
-    SelectObject(hdc,hpen);
-    SelectObject(hdc,hbrush);
-
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***    FastSetCursor
- *
- *      Only set cursor if current setting is different from new setting.
- */
-VOID FastSetCursor(HCURSOR hcur)
-{
-    if (hcur != g.hcurCurrent) {
-	SetCursor(hcur);
-	g.hcurCurrent = hcur;
-    }
-}
-
-
-/***	MouseInArea - Test if mouse coordinate is in rectangular area
- *
- *	Entry
- *	    xM,yM - mouse coordinate
- *	    x,y   - left upper corner of area
- *	    cx,cy - width and height of area
- *
- *	Exit
- *	    Returns TRUE if coordinate is in area.
- *	    Returns FALSE if coordinate is NOT in area.
- */
-BOOL MouseInArea(int xM,int yM,int x,int y,int cx,int cy)
-{
-    if ((x <= xM) && (xM < (x+cx)) &&
-	(y <= yM) && (yM < (y+cy)) )
-
-	return TRUE;
-    else
-	return FALSE;
-}
-
-
-/***    NewGame - Start a new game
- *
- */
-VOID NewGame(VOID)
-{
-    int ix;
-    int iy;
-
-    g.iMove = 0;
-    for (iy=0; iy<maxMove; iy++) {
-	for (ix=0; ix<nPeg; ix++) {
-	    g.amove[iy].guess[ix] = PEG_BLANK;
-	}
-	g.amove[iy].cPosition = 0;
-	g.amove[iy].cColor = 0;
-    }
-
-    // Pick a new code
-    PickCode();
-
-    // Disable Guess button
-    EnableWindow(abutton[iButtonGuess].hwnd,FALSE);
-    g.fGuessAllowed = FALSE;
-
-    // Game not over
-    g.fGameOver = FALSE;
-    g.fGameWon = FALSE;
-
-}
-
-
-/***	QueryResignGame - See if player wants to resign game
- *
- *	Entry
- *	    hwnd - main window
- *
- *	Exit
- *	    Returns TRUE if player wants to resign.
- *	    Returns FALSE if player does NOT want to resign.
- */
-BOOL QueryResignGame(HWND hwnd)
-{
-    char    achText[cbMaxString];
-    char    achCaption[cbMaxString];
-    int     i;
-
-    LoadString(g.hInstance,IDS_RESIGN,achText,sizeof(achText));
-    LoadString(g.hInstance,IDS_APP_TITLE,achCaption,sizeof(achCaption));
-    i = MessageBox(hwnd,achText,achCaption,MB_ICONQUESTION | MB_YESNO);
-    return (i == IDYES);
-}
-
-
-/***	PaintAnswer - Paint the answer on board
- *
- *      Entry
- *	    hwnd - hwnd of main window
- */
-VOID PaintAnswer(HWND hwnd)
-{
-    HDC     hdc;
-
-    hdc = GetDC(hwnd);
-    PaintAnswerSub(hdc);
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***	PaintAnswerSub - Paint the answer on board
- *
- *      Entry
- *          hdc - DC of client area
- */
-VOID PaintAnswerSub(HDC hdc)
-{
-    int i;
-    int x;
-
-    x = xAnswer;
-    for (i=0; i<nPeg; i++) {
-	PaintLibrary(hdc,x,yAnswer,g.guessCode[i]); // Paint a peg
-	x += cxPegBox;
-    }
-}
-
-
-/***    PaintBoard - Paint the game board
- *
- *      Entry
- *          hdc - DC of client area
- */
-VOID PaintBoard(HDC hdc)
-{
-    HBRUSH  hbrush;
-    HPEN    hpen;
-    int     i,ix,iy;
-    int     x;
-
-    // Set desired pen/brush and save default pen/brush
-
-    hpen = SelectObject(hdc,GetStockObject(BLACK_PEN));
-    hbrush = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
-
-    // Draw Well, Move, Fun, and Result Areas
-
-    Rectangle(hdc,xWell,yWell,xWell+cxWell,yWell+cyWell);
-    Rectangle(hdc,xMove,yMove,xMove+cxMove,yMove+cyMove);
-    Rectangle(hdc,xAnswer,yAnswer,xAnswer+cxAnswer,yAnswer+cyAnswer);
-    Rectangle(hdc,g.xFun,g.yFun,g.xFun+g.cxFun,g.yFun+g.cyFun);
-    Rectangle(hdc,xResult,yResult,xResult+cxResult,yResult+cyResult);
-
-    // Draw pegs in Well Area
-
-    x = xWell;
-    for (i=0; i<nColor; i++) {
-	PaintLibrary(hdc,x,yWell,i);  // Paint a peg
-	x += cxPegBox;
-    }
-
-    // BUGBUG 02-Jul-1991 bens	Assert(g.iMove < maxMove);
-
-    // Paint Moves
-
-    for (iy=0; iy<=g.iMove; iy++) { // Paint pegs in move area
-	for (ix=0; ix<nPeg; ix++) {
-	    PaintPegSub(hdc,ix,iy);
-	}
-    }
-
-    // Paint answer, if appropriate
-
-    if (g.fGameOver) {
-	PaintAnswerSub(hdc);
-	if (g.fGameWon)
-	    PlayerWonSub(hdc);
-	else
-	    PlayerLostSub(hdc);
-    }
-
-
-    // Paint Results
-
-    for (i=0; i<=g.iMove; i++) {
-	PaintResultSub(hdc,i);
-    }
-
-    // Restore default pen and brush
-
-    SelectObject(hdc,hpen);
-    SelectObject(hdc,hbrush);
-}
-
-
-/***    PaintLibrary - Paint an Image from the Image Library
- *
- *      Entry
- *          hdc - Destination of paint
- *          x   - Left
- *          y   - Top
- *          i   - Image index =
- *                  0..nColor-1         : Paint peg of color i
- *                  nColor              : Paint peg hole
- *                  nColor+1..nColor+15 : Paint a Result Pin Pattern
- *                                        (see mpResultToLibrary)
- */
-VOID PaintLibrary(HDC hdc, int x, int y, int iLibrary)
-{
-    BitBlt(hdc,                 // Destination DC
-	   x+cxImageBoxOffset,  // Destination x left
-	   y+cyImageBoxOffset,  // Destination y top
-	   cxImageBox,          // Width of BLT
-	   cyImageBox,          // Height of BLT
-	   g.hdcLibrary,        // Source DC
-	   0,                   // Source x left
-	   iLibrary*cyImageBox, // Source y top
-	   SRCCOPY);            // RasterOp (Copy Src to Dst)
-}
-
-
-/***    PaintHolesForPegs - Paint Peg holes for Next Guess
- *
- */
-VOID PaintHolesForPegs(HWND hwnd)
-{
-    HDC     hdc;
-    int     ix;
-
-    hdc = GetDC(hwnd);
-
-    for (ix=0; ix<nPeg; ix++) {
-	PaintPegSub(hdc,ix,g.iMove);
-    }
-
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***    PaintPeg - Paint a peg in the Move Area
- *
- *      Entry
- *          hwnd = client window
- *          ix   = Column in Move box
- *          iy   = Row in Move box
- */
-VOID PaintPeg(HWND hwnd, int ix, int iy)
-{
-    HDC     hdc;
-
-    hdc = GetDC(hwnd);
-    PaintPegSub(hdc,ix,iy);             // Paint the peg
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***    PaintPegSub - Worker routine to pain a Peg in the Move Area
- *
- *      Entry
- *          hdc = client window
- *          ix  = Column in Move box
- *          iy  = Row in Move box
- */
-VOID PaintPegSub(HDC hdc, int ix, int iy)
-{
-    PEG     peg;
-    int     x,y;
-
-    peg = g.amove[iy].guess[ix];        // Peg value
-
-    x = xMove + ix*cxPegBox;
-    y = yMove + iy*cyPegBox;
-
-    PaintLibrary(hdc,x,y,peg);          // Paint the peg (or peg hole)
-}
-
-
-/***    PaintResult - Paint a the results for a move
- *
- *      Entry
- *          hwnd = client window
- *          g.iMove = move to paint results for
- */
-VOID PaintResult(HWND hwnd)
-{
-    HDC     hdc;
-
-    hdc = GetDC(hwnd);
-    PaintResultSub(hdc,g.iMove);        // Paint the result
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***    PaintResultSub - Worker Routine to paint results for a move
- *
- *      Entry
- *          hdc   = client window DC
- *          iMove = move to paint result for
- *
- *      Exit
- *          returns hbrush of DC at entry.
- */
-VOID PaintResultSub(HDC hdc, int iMove)
-{
-    int     iPos,iClr;
-    int     x,y;
-
-    x = xResult;
-    y = yResult + iMove*cyPinBox;
-
-    iPos = g.amove[iMove].cPosition;
-    iClr = g.amove[iMove].cColor;
-
-    PaintLibrary(hdc,x,y,mpResultToLibrary[iPos][iClr]);
-}
-
-
-/***	Randomize - Initialize random number generator
- *
- */
-VOID Randomize(VOID)
-{
-    int     i;
-    time_t  t;
-
-    time(&t);
-
-    i = (int)(t>>16);
-    srand(i);   // Set seed of random number generator
-}
-
-
-/***    PickCode - Create a new Code
- *
- */
-VOID PickCode(VOID)
-{
-    int     fColor[nColor]; // Keep track of colors already picked
-    int     i;
-    int     j;
-
-    // Zero color flags
-    for (i=0; i<nColor; i++) {
-	fColor[i] = 0;
-    }
-
-    // Loop until we have filled in all the pegs
-    i = 0;
-    while (i < nPeg) {
-	j = rand() % nColor;    // Pick a color
-	if (fColor[j] == 0) {   // Color not already used, use it
-	    g.guessCode[i] = j; // Set peg color
-	    fColor[j] = 1;      // Remember we used this color
-	    i++;                // Get color for next peg
-	}
-    }
-}
-
-
-/***	PlayerLost - Indicate visually that player lost
- *
- */
-VOID PlayerLost(HWND hwnd)
-{
-    HDC     hdc;
-
-    hdc = GetDC(hwnd);
-    PlayerLostSub(hdc);
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***	PlayerLostSub - Indicate visually that player lost
- *
- */
-VOID   PlayerLostSub(HDC hdc)
-{
-    PlayerTextOut(hdc,"Loser!");
-}
-
-
-/***	PlayerTextOut - Indicate win/lose
- *
- */
-VOID PlayerTextOut(HDC hdc, char *psz)
-{
-    HFONT   hfnt;
-    int     nBkMode;
-    int     x,y;
-
-    hfnt = SelectObject(hdc,g.hfntButton);
-    nBkMode = SetBkMode(hdc,TRANSPARENT);
-
-    x = g.xFun + 8; // BUGBUG 02-Jul-1991 bens Hack positioning
-    y = g.yFun + g.cyFun/2;
-
-    TextOut(hdc,x,y,psz,strlen(psz));
-
-    SetBkMode(hdc,nBkMode);	// Restore original background mode
-    SelectObject(hdc,hfnt);	// Restore original font
-}
-
-
-/***	PlayerWon - Indicate visually that player won
- *
- */
-VOID PlayerWon(HWND hwnd)
-{
-    HDC     hdc;
-
-    hdc = GetDC(hwnd);
-    PlayerWonSub(hdc);
-    ReleaseDC(hwnd,hdc);
-}
-
-
-/***	PlayerWonSub - Indicate visually that player won
- *
- */
-VOID   PlayerWonSub(HDC hdc)
-{
-    PlayerTextOut(hdc,"Winner!");
-}
-
-
-/***    ReleaseMouse - Release mouse capture and unrestrict mouse motion
- *
- */
-VOID ReleaseMouse(VOID)
-{
-    ClipCursor(NULL);               // Restore mouse mobility
-    ReleaseCapture();               // Release mouse capture
-}
-
-
-/***    SetMouse - Capture mouse and set ClipCursor area
- *
- *	Entry
- *	    hwnd - window handle of main window
- */
-VOID SetMouse(HWND hwnd)
-{
-    RECT    rc;
-
-    SetCapture(hwnd);               // Capture that mouse
-
-    rc.left   = xCursorLeft;
-    rc.top    = yCursorTop;
-    rc.right  = xCursorRight;
-    rc.bottom = yCursorBottom;
-
-    ClientToScreen(hwnd,(NPPOINT)(&rc)); // Convert left,top coordinates
-    ClientToScreen(hwnd,&(((NPPOINT)(&rc))[1])); // Convert right,bottom
-
-    ClipCursor(&rc);                // Restrict mouse movements
-}
-
-
-/***    TestGuess - Test player guess against code
- *
- *      Entry   g.iMove = move index
- *              g.amove(g.iMove) = player guess
- *              g.guessCode = code
- *
- *      Exit    returns TRUE if guess matches code
- *              else returns FALSE
- *
- *              g.amove[g.iMove].cPosition filled in.
- *              g.amove[g.iMove].cColor filled in.
- */
-BOOL TestGuess(VOID)
-{
-    int cColor = 0;             // Count of color-only matches
-    int codeColors[nColor];     // Count of each color in code
-    int cPosition = 0;          // Count of color-and-position matches
-    int guessColors[nColor];    // Count of each color in player guess
-    int i;
-    int j;
-    int n = g.iMove;            // Current move index
-
-    // Zero color counts
-    for (i=0; i<nColor; i++) {
-	guessColors[i] = 0;
-	codeColors[i] = 0;
-    }
-
-    // Count colors in guess and code
-    for (i=0; i<nPeg; i++) {
-	j = g.amove[n].guess[i];    // peg color
-	guessColors[j]++;           // Count this peg color
-	j = g.guessCode[i];         // peg color
-	codeColors[j]++;            // Count this peg color
-    }
-    
-    // Count exact matches
-    for (i=0; i<nPeg; i++) {
-	j = g.amove[n].guess[i];    // Get guess color
-	if (j == g.guessCode[i]) {  // Exact match!
-	    // Begin Assert
-	    if (guessColors[j] <= 0) {  // counted wrong
-		AssertMsg("Found exact match, but guessColors[] entry <= 0.");
-	    }
-	    if (codeColors[j] <= 0) {   // counted wrong
-		AssertMsg("Found exact match, but codeColors[] entry <= 0.");
-	    }
-	    // End Assert
-	    guessColors[j]--;       // Reduce color count in guess
-	    codeColors[j]--;        // Reduce color count in goal
-	    cPosition++;            // Count exact match
-	}
-    }
-
-    // Count color matches that remain after exact matches
-    for (i=0; i<nColor; i++) {
-	cColor += min(codeColors[i],guessColors[i]);
-    }
-
-    // Store findings
-    g.amove[n].cPosition = cPosition;
-    g.amove[n].cColor    = cColor;
-
-    // If correct postions same as number of pegs, we have a winner
-    return (cPosition == nPeg);
-}
-
-
-/***    WndProc - Main Window Procedure
- *
- */
-long FAR PASCAL WndProc(HWND hwnd,UINT msg,UINT wParam,LONG lParam)
-    {
-    HDC         hdc;
-    PAINTSTRUCT ps;
-
-    switch(msg) {
-	case WM_CREATE:
-	    CreateButtons(hwnd);
-	    NewGame();  // Start a new game
-	    return 0;
-
-	case WM_KEYDOWN:
-	    switch (wParam) {
-		case VK_RETURN:
-		    // See if guess is allowed
-		    if (g.fGuessAllowed) {
-			// Simulate push of Guess button
-			DoCommand(hwnd,IDC_GUESS,0L);
-			return 0;
-		    }
-		    break;
-	    }
-	    break;
-
-	case WM_COMMAND:
-	    DoCommand(hwnd,wParam,lParam);
-	    return 0;
-
-	case WM_RBUTTONDBLCLK:
-	case WM_RBUTTONUP:
-	    // See if guess is allowed
-	    if (g.fGuessAllowed) {
-		// Simulate push of Guess button
-		DoCommand(hwnd,IDC_GUESS,0L);
-		return 0;
-	    }
-	    break;
-
-	case WM_LBUTTONDBLCLK:
-	case WM_LBUTTONDOWN:
-	case WM_LBUTTONUP:
-	case WM_MOUSEMOVE:
-
-	    // If game is over, do not process mouse
-	    if (g.fGameOver)
-		break;	// Let Windows handle the message
-
-	    if (DoMouse(hwnd,msg,wParam,lParam)) // We handled it
-		return TRUE;    // Get out of here
-	    break;  // Let Windows handle the message
-
-	case WM_PAINT:
-	    hdc = BeginPaint(hwnd, &ps);
-	    PaintBoard(hdc);
-	    EndPaint(hwnd,&ps);
-	    return 0;
-
-	case WM_DESTROY:
-	    DestroyButtons();
-	    PostQuitMessage(0);
-	    return 0;
-    }
-    return DefWindowProc(hwnd,msg,wParam,lParam);
-}
+/***    MM.C - Master Mind Game
+ *
+ *      (c) 1991, Benjamin W. Slivka
+ *
+ *      MasterMind is a game (c) 1981 Pressman Toy Corporation,
+ *      200 Fifth Avenue, New York, NY  10010.
+ *
+ *      The object of MasterMind is to guess a secret code consisting of
+ *      a series of 4 colored pegs.  Each guess results in feedback which
+ *      should narrow down the possible code values.  Using this feedback,
+ *      the player will (with suitable application of logic) be able to
+ *      deduce the computer's code.
+ *
+ *      To begin, the computer builds a code of 4 colored pegs.  For
+ *      example: red, white, green, yellow.  The color and order of the
+ *      pegs make up the code.
+ *
+ *      The player then builds a guess of 4 colored pegs, and asks the
+ *      computer for feedback on the guess.  The computer reports the number
+ *      of pegs in the guess which match the code:
+ *          (1) in both color and position, and
+ *          (2) in color only
+ *
+ *      Any pegs counted for (1) are not eligible to be counted for (2).
+ *
+ *
+ *      Visual Layout of Game Window
+ *      ============================
+ *
+ *      +-+-----------------------------------------------+-+
+ *      |=|                 Master Mind                   |V|
+ *      +-+-----------------------------------------------+-+
+ *      | Options Help                                      |
+ *      +---------------------------------------------------+
+ *      |            ^                                      |
+ *      | cxBorder   +-- cyBorder                           |
+ *      | |          V                                      |
+ *      | | +---------------------------+ ^                 |
+ *      | | |                           | |                 |
+ *      |<+>|  Well Area                | +- cyWell         |
+ *      |   |                           | |                 |
+ *      |   +---------------------------+ V                 |
+ *      |      ^                                   cxBorder |
+ *      |      +-cyWellToMove +cxMoveToResult             | |
+ *      |      V              |                           | |
+ *      |     +-------------+ | +-----+ |    /----------\ | |
+ *      |     |          ^  |<+>|     | |    | New Game |<+>|
+ *      |     |          |  |   |     | |    \----------/   |
+ *      |     |          |  |   |  R  | |                   |
+ *      |     |  Move    |  |   |  e  | |    /----------\   |
+ *      |     |  Area    |  |   |  s  | |<+->|  Guess   |   |
+ *      |     |          |  |   |  u  |   |  \----------/   |
+ *	|     | 	 |  |	|  l  |   |		    |
+ *	|     | 	 |  |	|  t  |   cxWellToButton    |
+ *	|     | 	 |  |	|     | 		    |
+ *	|     | 	 |  |	|  A  |      +----------+   |
+ *	|     | 	 |  |	|  r  |      |		|   |
+ *	|     |      cyMove |	|  e  |      |		|   |
+ *	|     | 	 |  |	|  a  |      |	 Fun	|   |
+ *	|     | 	 |  |	|     |      |		|   |
+ *	|     | 	 |  |	|     |      |	 Area	|   |
+ *	|     | 	 |  |	|     |      |		|   |
+ *	|     |<- cxMove -->|	|     |      |		|   |
+ *	|     | 	 |  |	|<-+->|      |		|   |
+ *	|     | 	 V  |	|  |  |      |		|   |
+ *	|     +-------------+	+--|--+      |		|   |
+ *	|	^		   |	     |		|   |
+ *	|	+--cyMoveToAnswer  cxResult  |		|   |
+ *	|	V			     |		|   |
+ *	|     +-------------+ \ 	     |		|   |
+ *	|     | Answer Area |  +- cyAnswer   |		|   |
+ *	|     +-------------+ / 	     +----------+   |
+ *	|	 ^					    |
+ *	|	 +--cyBorder				    |
+ *      |        V                                          |
+ *      +---------------------------------------------------+
+ *
+ *
+ *      Visual Layout of Peg Box
+ *      ========================
+ *          The "Peg Box" is the building block for the "Well Area" and the
+ *      "Move Area".  It has room for a "Peg" centered inside the box.
+ *
+ *
+ *          <-- cxPegBox --->
+ *        ^ +---------------+
+ *        | |               |
+ *        | | cxPegOffset   |
+ *          | |             | --
+ *        c | |   -----     |  ^
+ *        y | |  /     \    |  |
+ *        P | | /       \   |  |
+ *        e | | |  Peg  |   |  +-- cyPeg
+ *        g |<->|       |   |  |
+ *        B |   \       /   |  |
+ *        o |    \     /    |  |
+ *        x |     -----     |  V
+ *          |       ^       | --
+ *        | |       +-- cyPegOffset
+ *        | |       V       |
+ *        V +---------------+
+ *             |         |
+ *             |<---+--->|
+ *                  |
+ *
+ *                cxPeg
+ *
+ *
+ *      Visual Layout of Pin Box
+ *      ========================
+ *          The "Pin Box" is the building block for the "Result Area".
+ *      It has room for up to 4 Pins grouped around the center of the box,
+ *      so that Pins in one pin box do not blend visually with the pins of
+ *      an adjacent Pin Box.
+ *
+ *
+ *          <---- cxPinBox --->
+ *        ^ +-----------------+
+ *        | |     ^           |
+ *        | |     +- cyPinOffset
+ *          |     V           |
+ *        c |    /-\  /-\     |
+ *        y |    \-/  \-/     |
+ *        P |            ^+cyPinSpace
+ *        i |            V    | --
+ *        n |    /-\  /-\     |  ^--cyPin
+ *        B |<+->\-/  \-/     |  V
+ *        o | |     <>        | --
+ *        x | |      +cxPinSpace
+ *          | |               |
+ *        | | cxPinOffset     |
+ *        | |                 |
+ *        V +-----------------+
+ *                   |   |
+ *                   |<+>|
+ *                     |
+ *
+ *                   cxPin
+ *
+ *
+ *      Algorithmic Relationship Between Dimensions
+ *      ===========================================
+ *
+ *      nPeg = 4 = number of pegs in a guess
+ *      nColor = 6 = number of different colored pegs
+ *
+ *      cxPegBox = x width of a Peg Box
+ *      cyPegBox = y width of a Peg Box
+ *      cxPeg    = x width of a Peg
+ *      cyPeg    = y width of a Peg
+ *      cxPegOffset = x distance between edge of Peg Box and Peg
+ *      cyPegOffset = y distance between edge of Peg Box and Peg
+ *
+ *      cxMove = nPeg * cxPegBox = x width of Move Area
+ *      cyMove = maxMove * cyPegBox = y height of Move Area
+ *      cxResult = x width of Result Area
+ *      cyResult = cyMove = y height of Result Area
+ *      cxWell = cxPegBox = x width of Well Area
+ *      cyWell = nColor * cyPegBox = y height of Well Area
+ *      cyBorder = y width of top and bottom border
+ *      cxBorder = x width of left and right border
+ *      cxButton = width of widest button (computed at run-time)
+ *
+ *      cxMoveToResult = cxWell - (cxMove + cxResult) = x width between
+ *                                                       Move and Result Areas
+ *      cxWellToButton = x width between Well Area and Buttons
+ *
+ *      cyWellToMove = y height between Well and Move Areas
+ *
+ *      cxClient = 2*cxBorder + cxWell + cxWellToButton + cxButton
+ *               = x width of client area
+ *
+ *	cyClient = 2*cyBorder + cyWell + cyWellToMove + cyMove +
+ *		      cyMoveToAnswer + cyAnswer
+ *               = y height of client area
+ *
+ *
+ *      Notes:
+ *
+ *      (1) The Well Area is positioned over the Move and Result Areas
+ *      (2) The Move and Result Areas are centered under the Well Area
+ *      (2) The Buttons are postioned to the right of the Result Area
+ *
+ *      "Peg Box" - The bounding rectangle of a "Peg".  This is used to
+ *              to lay out the "Move Area" and "Well Area".
+ *
+ *      "Well Area" - The area where one peg of each color is displayed.  The
+ *              user drags a peg from this "well" into the "Move Area", and
+ *              over the "Active Row" to place a peg for a "Guess".
+ *
+ *      "Move Area" - The area where the player builds Guesses.
+ *
+ *      "Result Area" - The area where the results of a players guesses are
+ *              displayed.  A *black* "Pin" is displayed for each Peg in the
+ *              Guess that matches a Peg in the computer's "Goal" in both
+ *              color and position.  A *white* Pin is displayed for each Peg
+ *              in the Guess that matches a Peg in the computer's Goal in
+ *              color only.
+ *
+ *	"Fun Area" - The area where visual indication of game won/lost occurs.
+ *
+ *	"Answer Area" - The area where the computer code is revealed.
+ *
+ *
+ *      Performance Notes
+ *      =================
+ *      (1) We create a Memory DC to hold a bitmap that contains images of
+ *          each peg, the peg hole, and all combinations of pin results.
+ *          Then, when painting the board, we do a BitBlt(...,SRC_COPY,...)
+ *          from the memory DC to the the screen DC!
+ *
+ *          Since we cleverly made <cxPegBox,cyPegBox> be the same size as
+ *          <cxPinBox,cyPinBox>, all we need is (conceptually) an array of
+ *          images of this size in a single bitmap.
+ *
+ *          We need to construct the following images in the bitmap:
+ *
+ *          Count   Description of Image(s)
+ *          ------  --------------------------------------------------------
+ *          nColor  Colored Pegs
+ *          1       Peg Hole
+ *          15      All possible Result Pin patterns (see below)
+ *
+ *          Result Pin Patterns
+ *          -------------------
+ *              The tricky thing here is to pack these images tightly into
+ *          the bitmap, so we need a mapping from (cPos,cClr) to [0..14]:
+ *
+ *               i  Pos  Clr
+ *              --- ---  ---
+ *               0   0    0
+ *               1   0    1
+ *               2   0    2
+ *               3   0    3
+ *               4   0    4
+ *               5   1    0
+ *               6   1    1
+ *               7   1    2
+ *               8   1    3
+ *               9   2    0
+ *              10   2    1
+ *              11   2    2
+ *              12   3    0
+ *              13   3    1
+ *              14   4    0
+ *
+ *          The solution is a two-dimensional array, mpResultToLibrary,
+ *          indexed by cPos and cClr.  We build this array as we build
+ *          the images in the image bitmap.  For valid combinations, we
+ *          store the index of the image in the Bitmap into the array.
+ *          For invalid combinations, the array entry is set to -1.
+ *
+ *      (2) A Performance vs. Size Tradeoff in the organization of the
+ *          Image Library Bitmap.
+ *
+ *          We can either construct this as a horizontal vector of images,
+ *          or a vertical vector of images.
+ *
+ *          A horizontal organization is likely to consume less memory, since
+ *          the bitmap will (we presume) only waste space at the end of a
+ *          row -- and there will only be *cxPegBox* rows.  However, this
+ *          is could lead to non-byte-aligned BitBlts, which are slower.
+ *
+ *          A vertical organization, on the other hand, ensures that at least
+ *          the source bitmap is aligned on a byte boundary.  The cost is that
+ *          we may waste some bytes at the end of each pixel row.  Since we
+ *          are using BitBlt for speed, we will continue to follow that maxim
+ *          here.
+ *
+ *      (3) Animation and the Move Area Back Buffer.
+ *
+ *          Peg swaps are animated, and the peg being dragged is drawn by us
+ *          rather than by a cursor.  Both are drawn into a Back Buffer the
+ *          size of the Move Area, which is then copied to the screen with a
+ *          single BitBlt, so nothing flickers.  The Back Buffer and its pen
+ *          and brush are created once in BeginMM, so a frame does no GDI
+ *          allocations at all -- it is just BitBlts from the Image Library.
+ *
+ *          Moving pegs ("sprites") are drawn transparently with a peg Mask
+ *          that is the last image in the Image Library:
+ *
+ *              dst ^= peg;  dst &= mask;  dst ^= peg;
+ *
+ *          Outside the peg the mask is white, so dst is left unchanged;
+ *          inside the peg the mask is black, so dst ends up as the peg.
+ *
+ *          Frames are paced by a WM_TIMER that only runs while something is
+ *          moving.  Swaps advance in fixed msFrame ticks of elapsed time, so
+ *          a swap takes the same time even when timer messages are late.
+ *
+ *      (4) Hit Testing.
+ *
+ *          Every WM_MOUSEMOVE has to find which area, column, and row the
+ *          mouse is over.  Rather than testing each area in turn, BeginMM
+ *          builds a Hit Test Map, mpCellToHit, that divides the client area
+ *          into cxHitCell by cyHitCell cells and records the area, column,
+ *          and row for each cell.  DoMouse then does one table lookup.
+ *
+ *          If the layout ever changes at run-time (more pegs, a different
+ *          peg size), call BuildHitMap again after computing the new layout.
+ *
+ *      (5) Latency Instrumentation.
+ *
+ *          Build with /DTIMING to time the interaction loop.  WndProc reads
+ *          the high-resolution counter around each mouse, key, command,
+ *          paint, and animation timer message, and the time from a drag
+ *          mouse move to the frame that shows it.  Each event type keeps a
+ *          histogram of latencies in microseconds, with 4 buckets per power
+ *          of 2, from which we report the count, p50, p99, and max.
+ *
+ *          All of this runs on the one UI thread, so the histograms need no
+ *          locks.  Without /DTIMING the Timing macros are empty, so normal
+ *          builds do not even read the counter.
+ *
+ *          The report is shown by Help/Timing..., and is also written at
+ *          exit to the file named by the MM_TIMING environment variable.
+ *
+ *      (6) Input Recording and Replay.
+ *
+ *          To measure the UI path repeatably, run
+ *
+ *              mastmind /record file
+ *
+ *          and play.  Every input, command, paint, and timer message that
+ *          reaches WndProc is written to file, with its time and the seed
+ *          Randomize used.  Then run
+ *
+ *              mastmind /replay file [report]
+ *
+ *          This plays the same game with the window hidden.  Each message is
+ *          fed straight to WndProc (WM_PAINT goes to PaintBoard), and all
+ *          painting goes to an off-screen bitmap, via GetClientDC.  GetTime
+ *          returns the recorded time, so animation steps exactly as it did.
+ *          The total time, and the average time per event for each message
+ *          type, are written to report, or shown in a message box.
+ *
+ *          The file is text, one message per line after a two line header:
+ *
+ *              MMREPLAY 1
+ *              seed <seed>
+ *              <ms> <msg> <wParam> <lParam>      (msg,wParam,lParam in hex)
+ *
+ *          The answer to "resign this game?" is recorded as a MSG_RESIGN
+ *          line, so the replay does not stop to ask.
+ *
+ *      (7) Solver Engine.
+ *
+ *          The computer side of the game (scoring, and everything built on
+ *          it) works on a BOARD rather than on nPeg and nColor, so it can
+ *          handle boards other than the one we play on.  A BOARD has up to
+ *          maxPegBoard pegs and maxColorBoard colors, with or without
+ *          duplicate colors, and lists every code when there are few
+ *          enough of them.  g.bd is the BOARD for our game.
+ *
+ *          Scoring a guess against a code gives a RESULT, a dense index for
+ *          (cPosition,cColor) numbered the same way as the Result Pin
+ *          Patterns in (1).  There are four ways to score:
+ *
+ *          ScoreCode      - Count colors, the way TestGuess always has.
+ *          ScorePacked    - Score PACKED codes 64 bits at a time.  Pegs are
+ *                           4 bits each, so one XOR compares every peg;
+ *                           color counts are 8 bits each, so a lane-wise
+ *                           min and one multiply sum the color matches.
+ *          Feedback Table - BoardTable stores the RESULT of every (guess,
+ *                           code) pair, for boards small enough.
+ *          ScoreSliced    - Score 64 codes at once, bit-sliced; see (19).
+ *
+ *          mastmind /bench [file] times each of these, plus candidate
+ *          filtering, code generation, and whole-game solves, for several
+ *          board sizes, and writes the results as JSON.  Cache miss counts
+ *          need processor counters Windows does not give us, so they are
+ *          reported as null.
+ *
+ *      (8) Server Mode.
+ *
+ *          mastmind /server [pipe] hosts many games at once for bots and
+ *          other tools, with no window.  Each game is a SESSION, holding
+ *          only what a game needs: the code, the guess count, and whether
+ *          the game is over.  The wire protocol is in MM.H.
+ *
+ *          One thread serves cPipe pipe instances through an I/O
+ *          completion port, so no client waits on another client's I/O.
+ *          Each read takes every whole request the client has sent, and
+ *          all their replies go back in one write.  Nothing after a
+ *          SOP_QUIT is answered.  Each pipe keeps a list of the sessions
+ *          its client started, and ends them all when the client goes
+ *          away, so a client that crashes does not leak sessions.  A pipe
+ *          that cannot take a new client waits msRetry before trying
+ *          again, rather than spinning on the port.
+ *
+ *          ServerBatch answers all the requests from one read.  A run of
+ *          SOP_GUESS requests is scored as a batch by ServerGuesses: the
+ *          guesses are chained together by session (and so by code), then
+ *          each session's chain is scored from one row of the Feedback
+ *          Table, the row for the session's code.  Chaining takes one
+ *          pass, needs no sort, and keeps each session's guesses in the
+ *          order they were sent.  The table is for g.bdServer, where
+ *          colors may repeat, so any guess a client sends is listed, and
+ *          its index is just its pegs read as a number in base nColor:
+ *          no packing and no ranking per guess.  /bench times
+ *          server_batch at about half of server_single, which scores one
+ *          request at a time with ScorePacked.
+ *
+ *          Session ids carry a generation count in their high bits, so an
+ *          id from a finished session is refused rather than reaching
+ *          whoever got its slot next.
+ *
+ *          Sessions come from a POOL, not from malloc.  A POOL hands out
+ *          fixed-size slots from slabs of cSlotSlab slots each.  Slots are
+ *          rounded up to whole cache lines, and slabs start on a cache
+ *          line, so no session shares a line with another.  Freed slots go
+ *          on a free list (the link is kept in the slot itself), so once
+ *          the server has seen its busiest moment, starting and ending
+ *          games does no allocation at all.
+ *
+ *      (9) Tournament.
+ *
+ *          mastmind /tournament plays codebreaker strategies against every
+ *          code on a board (or a seeded sample of them) and ranks them by
+ *          games lost, then average guesses, then worst case, then CPU
+ *          time per move.  The built-in strategies "first" (the first code
+ *          still consistent with the feedback), "minimax" and "propagate"
+ *          always play; the built-in "genetic" plays only when named, as
+ *          its guesses depend on its threads.  Other strategies are
+ *          plugin DLLs written to MMSTRAT.H.
+ *
+ *          Each strategy plays all its games on its own thread, so they
+ *          run in parallel, and GetThreadTimes gives each one's CPU time
+ *          without counting the others.  The referee scores guesses with
+ *          ScorePacked, and a guess with a bad color (or a repeated color,
+ *          when the board has none) loses the game.
+ *
+ *      (10) Adversary.
+ *
+ *          With Options/Adversary checked, the computer does not pick a
+ *          code at NewGame.  It keeps every code still consistent with its
+ *          answers, and answers each guess with the RESULT shared by the
+ *          most of them, so the player learns as little as possible.  The
+ *          code shown at the end is one that fits every answer given.
+ *
+ *          PartitionCodes does the work: one ScorePacked per candidate
+ *          code, counting the candidates for each RESULT and keeping each
+ *          candidate's RESULT, so filtering afterwards needs no scoring.
+ *          The whole set for our game is 360 codes, and even 8x5 (32768
+ *          codes) takes well under a frame.  /tournament /adversary plays
+ *          strategies against the adversary instead of fixed codes.
+ *
+ *      (11) Worst-Case Analysis.
+ *
+ *          mastmind /analyze file plays every strategy against every code
+ *          on a board and keeps the guesses each game took.  The table is
+ *          a file mapped into memory: a short header, then one byte per
+ *          strategy and code, so 10x6 (a million codes) takes a megabyte
+ *          per strategy, and any other tool can map the file and look up
+ *          a code by its index.
+ *
+ *          One worker thread runs per processor.  Workers take cCodeChunk
+ *          codes at a time from a shared counter (InterlockedExchangeAdd),
+ *          so a slow run of codes does not leave the others idle, and
+ *          each worker starts its own copy of every strategy.  The copies
+ *          of "first" and "minimax" share g.tny.bd's code lists, Feedback
+ *          Table and slices (BoardShare) rather than building their own:
+ *          on 10x6 that is 32 MB once instead of once per worker.  Only
+ *          the candidate list and a Feedback File's mapped tiles are kept
+ *          per copy.
+ *
+ *          The table is its own checkpoint.  An entry stays 0 until its
+ *          game is over, so after an interruption, running again with the
+ *          same file, board, and strategies plays only the games still 0.
+ *          Dirty pages belong to the file, not the process, so killing
+ *          mastmind loses nothing; the view is also flushed every
+ *          msCheckpoint ms, so even a crash of Windows loses little.
+ *          Progress goes to a console once a second.
+ *
+ *      (12) Built-in Tables.
+ *
+ *          Everything BoardBegin and BoardTable build for our game (every
+ *          code, every code packed, and the 360x360 Feedback Table), and
+ *          mpResultToLibrary from (1), depend only on the board.  So
+ *          mastmind /gentables writes them out as const arrays in
+ *          MMTABLES.H, which is compiled in.  For any board in abszBuiltIn,
+ *          BoardBegin just points the BOARD at those arrays: startup
+ *          builds nothing, and since the arrays are read-only data in the
+ *          .EXE, every running copy of mastmind shares the same pages.
+ *
+ *          Our game and classic 6x4 with repeated colors are built in.
+ *          6x4 is the board /server scores every guess on (see (8)), and
+ *          its 1296x1296 Feedback Table adds 1.7 MB to the .EXE.  8x4
+ *          would add 16 MB, and 8x5 1 GB, so bigger boards build their
+ *          tables when needed, or use a Feedback File (13).  Add a board
+ *          to abszBuiltIn and run /gentables to build it in too.
+ *
+ *      (13) Feedback Files.
+ *
+ *          A Feedback Table for 8x5 (32768 codes) is 1 GB, too big to
+ *          build in memory, and boards past that are bigger still.
+ *          mastmind /genfeedback [CxP[u]] writes one to disk instead, as
+ *          "mm8x5.mmf" and so on, and BoardTable opens it for any board
+ *          of more than maxCodeTable codes, if it is in the current
+ *          directory.
+ *
+ *          The file is cut into tiles of cGuessTile guesses by cCodeTile
+ *          codes (1 MB), each tile a whole number of allocation units,
+ *          so any tile can be mapped as a view of its own.  A row of a
+ *          tile, one guess against 4096 codes, is one 4K page.  A BOARD
+ *          keeps its cViewFeed most recently used tiles mapped: the rows
+ *          of early guesses, which every game uses, stay mapped and paged
+ *          in, while the address space used stays small even with a
+ *          BOARD per thread.
+ *
+ *          The file is opened with FILE_FLAG_RANDOM_ACCESS, since lookups
+ *          jump about and read-ahead would only push hot pages out.  The
+ *          pages belong to the file cache, so every process and thread
+ *          with the file open shares one copy.  FilterCodesFeed looks up
+ *          a new row only when it crosses into another tile; /bench times
+ *          it as filter_file when a Feedback File is there to use.
+ *
+ *      (14) Partition Counting.
+ *
+ *          Picking a guess by minimax means counting, for each guess
+ *          tried, how the candidates split by RESULT: guesses times
+ *          codes lookups, most of a second per move on 8x5.  Done one
+ *          guess at a time, each guess walks the whole candidate list,
+ *          which falls out of cache long before the next guess starts.
+ *
+ *          PartitionGuesses instead takes cGuessBlock guesses at a time
+ *          and walks the candidates in tiles of cCodeBlock PACKED codes
+ *          (12K), scoring the whole block of guesses against a tile
+ *          before moving on, so the tile and the block's histograms stay
+ *          in L1.  Each thread counts into a histogram of its own and
+ *          copies it to acPart when its block is done, so threads never
+ *          share a cache line while counting.  Blocks are claimed with
+ *          InterlockedExchangeAdd, and threads are started only for jobs
+ *          of cPairThread guess/code pairs or more, where they pay for
+ *          themselves.  /bench times it as partition_blocked against
+ *          partition_single.  The "minimax" built-in strategy uses it
+ *          through ChooseGuess.
+ *
+ *      (15) Hints.
+ *
+ *          Options/Hint fills the play row with a guess.  The best guess
+ *          can take far longer to find than a frame, so HintStart shows
+ *          the first code that fits the moves so far right away, and
+ *          starts HintThread to do better.  HintThread posts MSG_HINT
+ *          with the minimax guess from ChooseGuess (a millisecond or
+ *          so), then searches for a guess sure to win in k guesses, for
+ *          k = 1, 2, ... (iterative deepening), and posts the first it
+ *          finds.  WndProc shows each MSG_HINT as it arrives; the
+ *          message loop is never blocked.
+ *
+ *          HintSolve skips guesses that leave a part with more codes
+ *          than k-1 guesses could be sure of (one code, or one per
+ *          RESULT for each guess left), and tries the rest best minimax
+ *          first; even before the first guess the search takes about
+ *          0.1 second, and later ones take milliseconds.  If it has not
+ *          finished after msHintBudget it gives up, and the minimax hint
+ *          stands.
+ *
+ *          A guess, a new game, or a new hint bumps g.genHint; the
+ *          thread sees that at its next check and quits, and MSG_HINTs
+ *          already posted for the old hint are ignored.  Hints never
+ *          replace pegs the player has moved.  MSG_HINT is recorded, so
+ *          replay shows the same hints without running HintThread.
+ *
+ *      (16) Speculation.
+ *
+ *          While the player looks at a full play row, the computer sits
+ *          idle, and the guess can get only one of cResult RESULTs.  So
+ *          whenever the row is filled (g.fGuessAllowed set), SpecStart
+ *          starts SpecThread, which groups the codes that fit the moves
+ *          so far by the RESULT the row would get, then finds the
+ *          minimax next guess for each group, biggest (most likely)
+ *          group first.  Changing the row starts it over; pushing Guess
+ *          stops it, keeping what it finished.
+ *
+ *          FitCodes then takes the codes that fit after the guess
+ *          straight from g.spec, instead of filtering every code by
+ *          every move, and HintStart shows the speculated guess at once
+ *          rather than waiting for HintThread.  On 6x4u SpecThread
+ *          needs about a millisecond, so it has always finished before
+ *          the player can push Guess.  During replay it runs in line, so
+ *          every replay does the same work.
+ *
+ *      (17) Opening Books.
+ *
+ *          A strategy makes the same first few guesses in every game, and
+ *          they are its dearest: with every code still possible, the
+ *          first "minimax" guess on 8x5 alone scores a billion pairs.
+ *          mastmind /genbook [/board CxP[u]] [/plies n] [strategy] asks
+ *          the strategy once for every guess it could make in the first n
+ *          guesses (3 by default), and writes them to an Opening Book,
+ *          "mm8x5-minimax.mmb" and so on, in the current directory.
+ *
+ *          The book is a tree of BOOKNODEs, breadth first: each node is
+ *          a guess, and the cResult nodes after it, one per RESULT, sit
+ *          together, so finding the next guess is one index per move.
+ *          Books are small (7K for 8x5) and mapped read-only, so their
+ *          pages are shared by every thread and process using them.
+ *
+ *          BeginMM maps the book for our game and pszStratBook, and
+ *          HintStart and SpecThread use it before ChooseGuess.  The
+ *          "minimax" built-in maps its book in StratMinimaxBegin, so a
+ *          tournament or /analyze searches only once a game leaves the
+ *          book: a 20 code 8x5 tournament drops from 15 s to 26 ms, with
+ *          the same guesses.
+ *
+ *      (18) Ranking Codes.
+ *
+ *          BoardBegin lists codes in order, last peg changing fastest, so
+ *          the index of a code is its rank in that order, and RankCode
+ *          works it out from the pegs instead of searching the list.
+ *          With colors repeating it is a number in base cColor.  Without,
+ *          it is a Lehmer code: each peg counts only the colors not used
+ *          by the pegs before it, and is worth the number of ways to fill
+ *          the pegs after it, P(cColor-1-i,cPeg-1-i).  BoardBegin keeps
+ *          those place values in the BOARD, and a used-color mask and
+ *          acBitNibble count the colors skipped, so ranking is a multiply
+ *          and a few lookups per peg.  UnrankCode goes the other way, for
+ *          boards too big to list.
+ *
+ *          With a rank, any move (not just one of our own guesses) can
+ *          use the Feedback Table: StratFirstGuess ranks every move it is
+ *          given, FitCodes ranks the player's guesses, and PlayGame ranks
+ *          a strategy's guess to check it and score it.  /genbook no
+ *          longer searches the list for each guess in the book.
+ *
+ *      (19) Bit-Sliced Scoring.
+ *
+ *          ScorePacked scores one code at a time.  A slice turns cLaneSlice
+ *          (64) codes on their side: for each peg and color there is one
+ *          ULONGLONG, with a bit set for each code having that color on
+ *          that peg.  ScoreSliced then scores a guess against all 64 with
+ *          ANDs, ORs and XORs.  Exact matches are the planes for the
+ *          guess's own colors, added up in a bit-sliced counter.  Color
+ *          matches are, for each color in the guess, the codes having at
+ *          least 1, 2, ... (up to the guess's count) pegs of that color,
+ *          added to a second counter.  Decoding both counters gives, for
+ *          each RESULT, the lanes that get it: a mask, good for
+ *          filtering, and one bit count from a histogram.
+ *
+ *          BoardSlice slices every code on a board, taking a bit per peg
+ *          and color for each code (5 bytes on 8x5, against 24 for
+ *          PACKED), and turns it on for the BOARD.  FilterCodesSliced
+ *          scores whole slices when at least cRunSlice candidates are in
+ *          one, and ScorePacked the stragglers.  PartitionThread slices
+ *          each tile of candidates as it copies it, so any candidate list
+ *          works, and scores every guess in the block against the tile
+ *          cLaneSlice codes at a time.
+ *
+ *          It is for boards too big for a Feedback Table, when there is
+ *          no Feedback File either: /tournament, /analyze and /genbook
+ *          take /sliced to have the built-in strategies use it, and
+ *          /bench times filter_sliced and partition_sliced next to the
+ *          packed and table versions.  Partitions count 1.3 to 1.8 times
+ *          as fast; filtering gains less, as keeping codes is per code
+ *          anyway.  A 20 code 8x5 tournament with no Opening Book takes
+ *          17 s instead of 31 s, with the same guesses.
+ *
+ *      (20) Grouping Codes.
+ *
+ *          GroupCodes reorders a list of codes in place so the codes
+ *          giving each RESULT for a guess are together, the way a
+ *          counting sort would, but without a second array: one
+ *          PartitionCodes pass gives each code's RESULT and each group's
+ *          size, so where each group starts is known, and each code is
+ *          then swapped straight into the next free place in its group.
+ *
+ *          HintSolve used to copy each part of its codes to the level
+ *          below, scanning every code once per RESULT.  Now it groups its
+ *          codes and hands each group down as it lies, so a level needs
+ *          no list of its own and the codes it searches are together in
+ *          memory.  SpecThread groups its codes the same way, without
+ *          borrowing aiGuess to hold them.
+ *
+ *      (21) Code Sets.
+ *
+ *          Everything above lists codes by index, a DWORD each, which is
+ *          fine until a board has too many codes to list at all: 10
+ *          colors and 8 pegs is 10^8 codes, 400 MB as a list and 12.5 MB
+ *          even as a bitmap, for every set of candidates a search keeps.
+ *
+ *          A CODESET splits the code indexes into chunks of cChunkCode
+ *          (64K), and keeps only the chunks with codes in them, each in
+ *          whichever of three forms is smallest for it: a sorted array of
+ *          16-bit offsets (2 bytes a code), a bitmap (8K), or a list of
+ *          runs (4 bytes a run).  Every code is one run per chunk, so the
+ *          full set on 10x8 is 1526 chunks of one run, about 43K; once
+ *          a guess is scored the survivors are runs and bitmaps, and a
+ *          few guesses later a handful of arrays.
+ *
+ *          SetFilter keeps the codes giving a guess's RESULT.  It spreads
+ *          each chunk into a scratch bitmap, and ChunkScore scores it a
+ *          word at a time: a word with at least cRunSlice codes in it is
+ *          sliced and scored with ScoreSliced, a sparser one code by code
+ *          with ScorePacked.  The codes are not listed, so UnrankCode
+ *          gives the pegs of the first code in a run, and NextCode steps
+ *          them on from there, setting only the last peg's plane while
+ *          only it changes, as StreamThread does.  The word for the
+ *          RESULT wanted is stored again in its smallest form.
+ *          SetPartition keeps every RESULT's words instead, splitting a
+ *          set into a set per RESULT for one scoring, and SetAnd
+ *          intersects two sets chunk by chunk without scoring at all: an
+ *          array is checked against the other chunk and stays an array,
+ *          two lists of runs are merged, and anything else is masked as
+ *          a bitmap.  /bench solves 10x8 codes with SetFilter
+ *          (solve_set): about 1.0 s a code, almost all of it scoring the
+ *          10^8 codes against the first guess, where scoring them one at
+ *          a time took 1.7 s; no set takes more than 80K.
+ *
+ *          "first" keeps its candidates in a CODESET on boards with too
+ *          many codes to list but few enough to index (10x8 has 10^8).
+ *          Every game opens with the same guess, so the first game
+ *          splits every code by it with SetPartition, and each game after
+ *          starts from the part for its RESULT with SetAnd: that is a
+ *          set per RESULT kept live for the whole tournament, in place
+ *          of the 10^8 scorings that are most of a game's work.
+ *
+ *      (22) Streaming Codes.
+ *
+ *          A CODESET still walks every code on its first filter, on one
+ *          thread, and keeps what it finds.  Often all that is wanted is
+ *          to see each code that fits the moves so far, once: to count
+ *          them, or take the lowest.  StreamCodes does that without any
+ *          set or list at all.  Threads take cStreamCode code indexes at
+ *          a time from a shared counter, as PartitionGuesses takes
+ *          guesses.  UnrankCode gives the first code of the block and
+ *          NextCode steps on from it, so codes with a color repeated are
+ *          never made on boards where PickCode would not make them.  The
+ *          codes are sliced cCodeBlock at a time and each move is scored
+ *          with ScoreSliced, only against the lanes the moves before it
+ *          left.  The codes of a block that fit go to the caller's
+ *          PFNSTREAM in one call, one thread at a time; blocks finish in
+ *          any order.  A thread needs about 32K for its block and tile,
+ *          however big the board.
+ *
+ *          On one processor a pass over the 10^8 codes of 10x8 takes
+ *          about 1.5 s with a move to fit, and making the codes is most
+ *          of it, so mostly only the last peg's plane is set a lane at a
+ *          time (StreamThread).  /bench checks filter_stream against the
+ *          other filters, and solves the solve_set codes by streaming
+ *          every code past all the moves for each guess and keeping the
+ *          lowest (StreamFirst), the same guesses SolveCodeSet makes.
+ *          That is about twice the work of solve_set on one processor,
+ *          but it is split among all of them, and the memory stays put.
+ *
+ *      (23) Constraint Propagation.
+ *
+ *          Past about 10^8 codes even streaming is too slow for a move,
+ *          and 12x12 has 8.9*10^12.  The built-in strategy "propagate"
+ *          never lists or walks codes.  It keeps, for each peg, the colors
+ *          it can still have (a WORD of bits), and for each color, the
+ *          fewest and most pegs it can have.  PropMove narrows these by
+ *          what a move says alone: no peg right in place rules out each
+ *          color where it was guessed, and cPosition+cColor bounds the
+ *          count of each color guessed or not.
+ *
+ *          PropSearch then looks for one code that fits, narrowing with
+ *          PropNarrow at every step until nothing changes.  A move's color
+ *          matches are the sum over colors of min(pegs in guess, pegs in
+ *          code), so the bounds on the other colors bound each color's
+ *          share of it; a color at its most leaves the pegs not yet it,
+ *          one at its fewest takes every peg that can be it; and a move
+ *          with all its position matches found rules out the rest, as one
+ *          that needs every peg that may match makes them match.  Moves say
+ *          far more about how many of each color than about where, so
+ *          PropSearch settles the counts first, the color with fewest
+ *          choices first, and then colors the peg with fewest colors left.
+ *          Any code found fits every move, so it is the guess; it need not
+ *          be the one "first" would pick.
+ *
+ *          On one processor 12x12 takes about 15 guesses, and no move in
+ *          50 games took more than 0.05 s or 21K calls of PropSearch; 10x10
+ *          takes about 12 guesses, each a few milliseconds.  16x16 could
+ *          take a minute for a move, so PropSearch stops after
+ *          maxPropNode calls, and the guess is where it got furthest: the
+ *          pegs it had down to one color, the rest filled in by PropFill
+ *          from the colors left them.  That guess may not fit every move,
+ *          but it is cheap and the next search still gains by it.  In 20
+ *          games of 16x16 the budget ran out on 47 of 434 moves, no move
+ *          took more than 2.5 s, and no game was lost.  It plays in
+ *          /tournament with /sample, where "minimax" cannot, nor "first"
+ *          past 2^32 codes (see "Performance Notes (21)" above).
+ *
+ *      (24) Genetic Search.
+ *
+ *          The built-in strategy "genetic" looks for a code that fits
+ *          every move by evolving codes rather than reasoning about them.
+ *          Each processor (two at least) runs an island of cGenePop codes
+ *          on its own thread.  A code's fitness is how far it is from
+ *          fitting: for each move, how far off the cPosition and cColor
+ *          it would have got are, summed.  GeneFitness slices an island's
+ *          codes (two slices) and scores each move's guess against a
+ *          whole slice at once with ScoreSliced; a table per move gives
+ *          the distance for each RESULT, so scoring is all there is.
+ *
+ *          GeneBreed keeps the cGeneElite best codes, then fills the
+ *          island with children: each parent is the fitter of two codes
+ *          picked at random, the child takes a random run of pegs from
+ *          the second, and then has a peg recolored, two pegs swapped, or
+ *          a run reversed.  Every cGeneMigrate generations each island
+ *          sends its best code to the next, which puts it in place of its
+ *          worst.  The first island to find a code that fits stops them
+ *          all, so which code is guessed depends on the threads; that is
+ *          why /tournament plays "genetic" only when it is named, and
+ *          /analyze only when asked, where the other built-ins always
+ *          play.  After cGeneMax generations with none, the closest code
+ *          is guessed.  Islands keep their codes from guess to guess in a
+ *          game, since codes that fit the old moves are near ones that
+ *          fit the new.  Their threads last as long as the strategy:
+ *          StratGeneticBegin starts a GeneThread for each island but the
+ *          first, which the guessing thread evolves itself, and each
+ *          guess only sets their events, so a 20-guess game does not
+ *          start 20 threads per island.
+ *
+ *          /bench plays 10x8 and 12x12 (solve_genetic) and writes how
+ *          many codes were scored against the moves a second, and how
+ *          many guesses fit, to tune the islands by.  On one processor
+ *          it scores about 3 million codes a second against a 12x12
+ *          game's moves, and takes about 13 guesses a game; one guess in
+ *          four or so is the closest code, not one that fits.  Moves take
+ *          a tenth of a second or so, and still well under a second on
+ *          16x16, where "propagate" can take a minute.
+ *
+ *      (25) Static Solving.
+ *
+ *          mastmind /static finds the fewest guesses that, made all at
+ *          once, tell every code of a board apart: no two codes get the
+ *          same RESULT from every one of them.  Codes are kept in classes
+ *          that no guess so far tells apart, and StaticRefine splits them
+ *          by one more guess with a row of the Feedback Table: a code's
+ *          class and RESULT index a table, a hash with no collisions,
+ *          stamped so it is never cleared.  When the guess must be the
+ *          last, StaticRefine stops at the first two codes still alike.
+ *
+ *          A greedy set (the guess making most classes, until every code
+ *          is alone) gives a first bound.  StaticSearch then tries sets
+ *          with fewer guesses, adding codes in order and pruning:
+ *
+ *              - A guess that splits no class is never needed.
+ *              - With r guesses left, a class of m codes ends as at most
+ *                min(m,cResult^r) classes, so if the sum is short of
+ *                every code, no set of these will do.
+ *              - Changing colors or moving pegs keeps a set good, so the
+ *                first guess need only be one of each way of repeating
+ *                colors (StaticCanonical): 5 codes on 6x4, 1 on 6x4u.
+ *
+ *          Threads, one per processor, take a first and second guess at a
+ *          time from a shared counter, and each keeps its own classes and
+ *          table.  A smaller set found by any thread lowers cBest for all.
+ *          After msStaticBudget a board's search stops, and the set found
+ *          is reported as not shown to be the smallest.
+ *
+ *          On one processor every board in abszStatic up to 5x4u is
+ *          solved in well under a second, 6x4u (5 guesses) in about 24 s,
+ *          and on 6x4 the search finds 6 guesses but cannot rule out 5
+ *          within the budget.
+ */
+
+#include <windows.h>
+#include <process.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mm.h"
+#include "mmstrat.h"
+
+
+/**************
+ *** Macros *****************************************************************
+ **************/
+
+#define MIR(x)  MAKEINTRESOURCE(x)  // Make DialogBox lines shorter
+
+#define AssertMsg(x)        // BUGBUG - Enable this for DEBUG build
+
+// Latency instrumentation -- See "Performance Notes (5)" above.
+#ifdef TIMING
+#define TimingStart(li)     QueryPerformanceCounter(&(li))
+#define TimingStop(ev,li)   TimingRecord(ev,&(li))
+#else
+#define TimingStart(li)
+#define TimingStop(ev,li)
+#endif
+
+// Make 64-bit constants without relying on compiler-specific suffixes
+#define QW(hi,lo)   ((((ULONGLONG)(hi)) << 32) | (ULONGLONG)(lo))
+
+// Look up RESULT in Feedback Table -- See "Performance Notes (7)" above.
+#define ScoreTable(pbd,iGuess,iCode) \
+	    ((pbd)->presTable[(DWORD)(iGuess)*(pbd)->cCode + (iCode)])
+
+
+/*****************
+ *** Constants **************************************************************
+ *****************/
+
+#define cbMaxString   100       // Length of longest string resource
+
+#define nColor          6       // Number of colors
+#define nPeg            4       // Number of pegs per move
+#define maxMove        10       // Maximum number of moves
+
+#define nPin            2       // Number of result pin colors
+
+#define cxPegBox       24               // x width of a Peg Box
+#define cyPegBox       24               // y height of a Peg Box
+
+#define cxPeg          16               // x width of a Peg
+#define cyPeg          16               // y height of a Peg
+
+#define cxPegOffset ((cxPegBox-cxPeg)/2) // x offset of Peg in Peg Box
+#define cyPegOffset ((cyPegBox-cyPeg)/2) // y offset of Peg in Peg Box
+
+#define cxPegHole       8               // x width of a Peg Hole
+#define cyPegHole       8               // y height of a Peg Hole
+
+#define cxPegHoleOffset ((cxPegBox-cxPegHole)/2) // x offset of Peg Hole
+#define cyPegHoleOffset ((cyPegBox-cyPegHole)/2) // y offset of Peg Hole
+
+#define cxPinBox    (cxPegBox)          // x width of a Pin Box
+#define cyPinBox    (cyPegBox)          // y width of a Pin Box
+
+#define cxPin           6               // x width of a Pin
+#define cyPin           6               // y width of a Pin
+
+#define cxPinSpace  (cxPin/2)           // x distance between Pins in Pin Box
+#define cyPinSpace  (cyPin/2)           // y distance between Pins in Pin Box
+
+#define cxPinOffset ((cxPinBox-2*cxPin-cxPinSpace)/2) // x offset of Pin
+#define cyPinOffset ((cyPinBox-2*cyPin-cyPinSpace)/2) // y offset of Pin
+
+
+#define cxImageBoxOffset  1         // x border around image
+#define cyImageBoxOffset  1         // y border around image
+
+#define cxImageBox  (cxPegBox - 2*cxImageBoxOffset)
+#define cyImageBox  (cyPegBox - 2*cyImageBoxOffset)
+
+#define nLibraryImage (nColor+1+15+1) // Colors + Peg Hole + Result Pin
+				    // Patterns + Peg Mask.
+				    // See "Performance Notes (1) and (3)"
+#define iLibraryMask  (nColor+1+15) // Index of Peg Mask in Image Library
+#define cxLibrary   (cxImageBox)          // Width of Image Library Bitmap
+#define cyLibrary   (cyImageBox*nLibraryImage) // Height of Image Library Bitmap
+
+
+#define cxMove      (nPeg*cxPegBox)     // x width of Move Area
+#define cyMove      (maxMove*cyPegBox)  // y height of Move Area
+
+#define cyBorder        8               // y width of client border
+#define cxBorder        8               // x width of client border
+
+#define cxResult    (cxPinBox)          // x width of Result Area
+#define cyResult    (cyMove)            // y height of Result Area
+
+#define cxWell      (nColor*cxPegBox)   // x width of Well Area
+#define cyWell      (cyPegBox)          // y height of Well Area
+
+#define cxMoveToResult    8             // x width between Move and Result Area
+#define cxWellToButton    8             // x width between Result Area & Buttons
+
+#define cyWellToMove      8             // y height between Well and Move Area
+#define cyMoveToAnswer	  8		// y height between Move and Answer Area
+
+#define xWell   (cxBorder)              // x left of Well Area
+#define xMove   (xWell + (cxWell - (cxMove+cxResult+cxMoveToResult))/2)
+#define xResult (xMove+cxMove+cxMoveToResult) // x left of Result Area
+#define xButton (xWell+cxWell+cxWellToButton) // x left of Buttons
+
+#define yWell   (cyBorder)              // y top of Well Area
+#define yMove   (yWell+cyWell+cyWellToMove)  // y top of Move Area
+#define yResult (yMove)                 // y top of Result Area
+#define yButton (cyBorder)              // y top of Buttons
+
+#define xAnswer  (xMove)
+#define yAnswer  (yMove + cyMove + cyMoveToAnswer)
+#define cxAnswer (cxMove)
+#define cyAnswer (cyPegBox)
+
+/*
+ *  Rectangle to bound cursor while dragging a peg
+ */
+#define xCursorLeft     xWell
+#define yCursorTop      yWell
+#define xCursorRight    (xWell+cxWell)
+#define yCursorBottom   (yMove+cyMove)
+
+/*
+ *  Hit Test Map -- See "Performance Notes (4)" above.
+ *
+ *  The Well and Move Areas lie inside the cursor rectangle, so the map only
+ *  has to cover that.  Every area edge must fall on a cell boundary; with
+ *  the layout above, all edges are multiples of 8 pixels.
+ */
+#define cxHitCell         8             // x width of a Hit Test cell
+#define cyHitCell         8             // y height of a Hit Test cell
+#define cxHitMap    ((xCursorRight+cxHitCell-1)/cxHitCell) // Cells across
+#define cyHitMap    ((yCursorBottom+cyHitCell-1)/cyHitCell) // Cells down
+
+/*
+ *  Latency Histograms -- See "Performance Notes (5)" above.
+ */
+#define nBucket         124             // 4 buckets per power of 2 to 2^31us
+
+/*
+ *  Input Replay -- See "Performance Notes (6)" above.
+ */
+#define MSG_RESIGN  (WM_USER+1)     // Recorded answer to QueryResignGame
+#define cbMaxPath   260             // Length of longest file name
+
+/*
+ *  Solver Engine -- See "Performance Notes (7)" above.
+ */
+#define maxPegBoard      16             // Most pegs in a BOARD
+#define maxColorBoard    16             // Most colors in a BOARD
+#define maxResult   ((maxPegBoard+1)*(maxPegBoard+2)/2) // Most RESULTs
+#define maxCodeList  (1L<<24)           // Most codes BoardBegin will list
+#define maxCodeTable  4096              // Most codes BoardTable keeps in memory
+#define RESULT_NONE    0xFF             // RESULT for impossible combination
+
+/*
+ *  Feedback Files -- See "Performance Notes (13)" above.
+ */
+#define sigFeed     0x42464D4DL         // "MMFB", first bytes of file
+#define cbFeedHeader 0x10000L           // Header block; tiles start after
+#define cGuessTile     256              // Guesses (rows) in a tile
+#define cCodeTile     4096              // Codes (columns) in a tile
+#define cbTile  ((DWORD)cGuessTile*cCodeTile) // Bytes in a tile, 1 MB
+#define cViewFeed       16              // Tiles a BOARD keeps mapped
+#define iTileNone  0xFFFFFFFFL          // FEEDVIEW holds no tile
+
+/*
+ *  Partition Counting -- See "Performance Notes (14)" above.
+ */
+#define cGuessBlock     32              // Guesses a thread counts at once
+#define cCodeBlock     512              // Codes per tile; PACKEDs fill 12K
+#define cPairThread (1L<<20)            // Guess-code pairs worth threads
+#define maxPartThread    8              // Most PartitionGuesses threads
+#define iCodeNone  0xFFFFFFFFL          // No code chosen yet
+
+/*
+ *  Bit-Sliced Scoring -- See "Performance Notes (19)" above.
+ */
+#define cLaneSlice      64              // Codes in a SLICE, one per bit
+#define cRunSlice        8              // Fewest candidates worth a slice
+#define maxBitCount      5              // Bits in a bit-sliced peg count
+#define cqwSlice(pbd) ((pbd)->cPeg*(pbd)->cColor) // ULONGLONGs in a slice
+
+/*
+ *  Code Sets -- See "Performance Notes (21)" above.
+ */
+#define cbitChunk       16              // Low bits of index, within chunk
+#define cChunkCode  (1L<<cbitChunk)     // Codes in a chunk
+#define cqwChunk    (cChunkCode/64)     // ULONGLONGs in a chunk bitmap
+#define maxArrayChunk 4096              // Most codes in a CT_ARRAY chunk
+#define cbChunk(pch) (sizeof(CHUNK) + (((pch)->ct == CT_BITMAP) ? \
+		     cqwChunk*sizeof(ULONGLONG) : (pch)->cw*sizeof(WORD)))
+
+/*
+ *  Streaming Codes -- See "Performance Notes (22)" above.
+ */
+#define cStreamCode   4096              // Codes a thread takes at once
+#define maxStreamThread  8              // Most StreamCodes threads
+
+/*
+ *  Constraint Propagation -- See "Performance Notes (23)" above.
+ */
+#define maxPropNode (1L<<20)            // Most PropSearch calls for a guess
+
+/*
+ *  Genetic Search -- See "Performance Notes (24)" above.
+ */
+#define cGenePop       128              // Codes on an island, two SLICEs
+#define cGeneElite       4              // Best codes kept as they are
+#define cGeneMigrate    16              // Generations between migrations
+#define cGeneMax      2000              // Generations an island tries
+#define maxGeneIsland    8              // Most islands, a thread each
+
+/*
+ *  Static Solving -- See "Performance Notes (25)" above.
+ */
+#define maxStaticGuess  16              // Most guesses in a static set
+#define maxStaticThread  8              // Most StaticThread threads
+#define msStaticBudget 60000            // Longest a board is searched
+#define cNodeStatic   1024              // Sets tried between time checks
+#define cchStaticLine  384              // Longest line of StaticSolve report
+
+/*
+ *  Hints -- See "Performance Notes (15)" above.
+ */
+#define MSG_HINT    (WM_USER+2)     // HintThread found a better hint
+#define msHintBudget  5000          // Longest a hint keeps being refined
+
+/*
+ *  Opening Books -- See "Performance Notes (17)" above.
+ */
+#define sigBook     0x424F4D4DL         // "MMOB", first bytes of file
+#define cPlyBookDefault  3              // Guesses /genbook puts in a book
+#define maxPlyBook       4              // Most guesses in a book
+#define pszStratBook "minimax"          // Strategy of our game's hints
+
+/*
+ *  Server Mode -- See "Performance Notes (8)" above.
+ */
+#define maxSession  100000              // Most sessions at once
+#define cbitSession     17              // Bits of session id for index
+#define cPipe           16              // Pipe instances
+#define cbPipeBuf     4096              // Pipe read/write buffer size
+#define pszPipeDefault  "\\\\.\\pipe\\mastmind"
+#define keyRetry         1              // Completion key: reconnect pipe
+#define msRetry        100              // Wait before reconnecting pipes
+#define cbCacheLine     64              // Bytes per processor cache line
+#define cSesSlab      1024              // Sessions per POOL slab
+#define maxBatch    (cbPipeBuf/sizeof(SREQUEST)) // Guesses ServerGuesses
+						 // chains at once
+#define cSesBench     1024              // BenchServer sessions
+#define cGuessBench      8              // BenchServer guesses per session
+#define cReqBench   (cSesBench*cGuessBench)
+#define cRoundBench     64              // BenchServer rounds
+
+/*
+ *  Tournament -- See "Performance Notes (9)" above.
+ */
+#define maxStrategy     16              // Most strategies in a tournament
+#define maxGuessTourney 64              // Guesses before strategy loses game
+#define cStratBuiltIn    3              // "first", "minimax", "propagate"
+
+/*
+ *  Worst-case analysis -- See "Performance Notes (11)" above.
+ */
+#define sigAnalysis 0x4E414D4DL         // "MMAN", first bytes of table file
+#define cchStratName    64              // Strategy name kept in table file
+#define maxAnalyzeThread 32             // Most worker threads
+#define cCodeChunk      64              // Codes a worker takes at once
+#define cMoveLost     0xFF              // Table entry: strategy lost
+#define msProgress    1000              // Milliseconds between progress lines
+#define msCheckpoint 30000              // Milliseconds between flushes
+
+/*
+ *  Animation timing -- See "Performance Notes (3)" above.
+ */
+#define idTimerAnimate    1             // Timer ID for animation frames
+#define msFrame          16             // Milliseconds per animation tick
+#define cTickSwap         8             // Ticks to animate a peg swap
+
+
+/************************
+ *** Type Definitions *******************************************************
+ ************************/
+
+typedef int PEG; /* peg */  // Peg value
+#define PEG_BLANK   (nColor)    // PEG color of empty peg box
+
+
+typedef PEG GUESS[nPeg]; /* guess */
+
+typedef struct _MOVE {  /* mv */
+    GUESS   guess;          // The guess
+    int     cPosition;      // Pegs that match both position and color
+    int     cColor;         // Pegs that match color but not position
+} MOVE, *PMOVE;
+
+// SPRITE - A peg sliding along a row of the Move Area during a swap
+typedef struct _SPRITE { /* spr */
+    PEG     peg;            // Peg being moved, PEG_BLANK if none
+    int     ixFrom;         // Column peg is moving from
+    int     ixTo;           // Column peg is moving to
+} SPRITE, *PSPRITE;
+
+// ANIMATE - State of the Move Area animation
+typedef struct _ANIMATE { /* anim */
+    BOOL    fTimer;         // TRUE => frame timer is running
+    BOOL    fDirty;         // TRUE => Move Area must be repainted
+    DWORD   msLast;         // GetTime() at last timer message
+    DWORD   msAccum;        // Elapsed time not yet consumed by ticks
+    int     iTick;          // Ticks done in current swap
+    int     cTick;          // Ticks in current swap, 0 => no swap running
+    int     iy;             // Row of current swap
+    SPRITE  asprite[2];     // Pegs being swapped
+    BOOL    fDrag;          // TRUE => draw the peg being dragged
+    PEG     pegDrag;        // Peg being dragged
+    int     xDrag;          // x left of dragged peg (Move Area coordinates)
+    int     yDrag;          // y top of dragged peg (Move Area coordinates)
+} ANIMATE, *PANIMATE;
+
+#ifdef TIMING
+// EVENT - Type of event we time
+typedef enum {
+    EV_MOUSEMOVE,           // WM_MOUSEMOVE
+    EV_BUTTONDOWN,          // WM_LBUTTONDOWN
+    EV_BUTTONUP,            // WM_LBUTTONUP, WM_RBUTTONUP (Guess)
+    EV_DBLCLK,              // WM_LBUTTONDBLCLK
+    EV_KEY,                 // WM_KEYDOWN
+    EV_COMMAND,             // WM_COMMAND
+    EV_PAINT,               // WM_PAINT
+    EV_FRAME,               // WM_TIMER animation frame
+    EV_DRAGTOFRAME,         // Drag mouse move until frame shows it
+    nEvent
+} EVENT; /* ev */
+
+// HISTOGRAM - Latencies of one event type
+typedef struct _HISTOGRAM { /* hist */
+    DWORD   cSample;            // Number of events timed
+    DWORD   usMax;              // Longest latency
+    DWORD   acBucket[nBucket];  // Count of events in each bucket
+} HISTOGRAM, *PHISTOGRAM;
+#endif
+
+// RECORD - One message in an input recording
+typedef struct _RECORD { /* rec */
+    DWORD   ms;             // Time since recording began
+    UINT    msg;            // Message
+    UINT    wParam;         // Message parameter
+    LONG    lParam;         // Message parameter
+} RECORD, *PRECORD;
+
+// REPLAYSTAT - Replay cost of one message type
+typedef struct _REPLAYSTAT { /* rs */
+    UINT    msg;            // Message
+    char   *psz;            // Name for report
+    DWORD   c;              // Number replayed
+    LONGLONG liTotal;       // Performance counter ticks spent
+} REPLAYSTAT, *PREPLAYSTAT;
+
+// RESULT - Index of a (cPosition,cColor) pair; see BOARD
+typedef BYTE RESULT; /* res */
+
+// CODE - A code (or guess) for the Solver Engine
+typedef struct _CODE { /* code */
+    BYTE    apeg[maxPegBoard];  // Color of each peg
+} CODE, *PCODE;
+typedef const CODE *PCCODE;
+
+// PACKED - A CODE packed for ScorePacked
+typedef struct _PACKED { /* pk */
+    ULONGLONG qwPos;            // Color of each peg, 4 bits per peg
+    ULONGLONG aqwClr[2];        // Count of each color, 8 bits per color
+} PACKED, *PPACKED;
+typedef const PACKED *PCPACKED;
+
+// FEEDHDR - Start of a Feedback File
+typedef struct _FEEDHDR { /* fh */
+    DWORD   sig;                // sigFeed
+    DWORD   cCode;              // Codes on board
+    int     cPeg;               // Board
+    int     cColor;
+    BOOL    fDup;
+    DWORD   cTileGuess;         // cGuessTile, checked when opened
+    DWORD   cTileCode;          // cCodeTile, checked when opened
+} FEEDHDR, *PFEEDHDR;
+
+// FEEDVIEW - One tile of a Feedback File, mapped
+typedef struct _FEEDVIEW { /* fv */
+    DWORD   iTile;              // Tile mapped, iTileNone => none
+    RESULT *pres;               // View of tile
+    DWORD   stamp;              // FEEDFILE stamp when last used
+} FEEDVIEW, *PFEEDVIEW;
+
+// FEEDFILE - Feedback File opened for a BOARD
+typedef struct _FEEDFILE { /* ff */
+    HANDLE  hfile;              // The file
+    HANDLE  hmap;               // Mapping of whole file
+    DWORD   cBlock;             // Tiles across, per band of cGuessTile rows
+    DWORD   stamp;              // Count of lookups, for least recently used
+    FEEDVIEW afv[cViewFeed];    // Tiles mapped
+} FEEDFILE, *PFEEDFILE;
+
+// BOOKHDR - Start of an Opening Book file; cNode BOOKNODEs follow
+typedef struct _BOOKHDR { /* bh */
+    DWORD   sig;                // sigBook
+    DWORD   cCode;              // Codes on board
+    DWORD   cResult;            // RESULTs on board
+    DWORD   cNode;              // Nodes in book
+    BYTE    cPeg;               // Board
+    BYTE    cColor;
+    BYTE    fDup;
+    BYTE    cPly;               // Guesses in book
+    char    achStrat[cchStratName]; // Strategy, as made by BookName
+} BOOKHDR, *PBOOKHDR;
+
+// BOOKNODE - Guess after some moves; node 0 is the first guess
+typedef struct _BOOKNODE { /* bn */
+    DWORD   iGuess;             // Guess, iCodeNone if none
+    DWORD   iChild;             // Node after iGuess gets RESULT 0; the
+				// rest follow in order.  0 => none
+} BOOKNODE, *PBOOKNODE;
+
+// BOOK - Opening Book opened by BookBegin
+typedef struct _BOOK { /* bk */
+    HANDLE  hfile;              // The file
+    HANDLE  hmap;               // Mapping of the file
+    PBOOKHDR pbh;               // View of the file, NULL if no book
+    PBOOKNODE abn;              // Nodes, just past *pbh
+} BOOK, *PBOOK;
+
+// BOARD - Size and rules of a game, for the Solver Engine
+typedef struct _BOARD { /* bd */
+    int     cPeg;               // Pegs per code
+    int     cColor;             // Number of colors
+    BOOL    fDup;               // TRUE => colors may repeat in a code
+    DWORD   cCode;              // Number of codes, 0 if more than 2^32-1
+    int     cResult;            // Number of RESULTs
+    RESULT  resWin;             // RESULT when guess is the code
+    RESULT  mpPosClrToResult[maxPegBoard+1][maxPegBoard+1];
+    BYTE    mpResultToPos[maxResult]; // cPosition of each RESULT
+    BYTE    mpResultToClr[maxResult]; // cColor of each RESULT
+    DWORD   aiPlace[maxPegBoard]; // What each peg adds to a code index
+    PCCODE  acode;              // Every code, NULL if not listed
+    PCPACKED apacked;           // Every code packed, NULL if not listed
+    const RESULT *presTable;    // Feedback Table, NULL if not built
+    BOOL    fBuiltIn;           // TRUE => lists and table are in MMTABLES.H
+    BOOL    fShared;            // TRUE => lists, table and slices belong to
+				// another BOARD; see BoardShare
+    PFEEDFILE pff;              // Feedback File, NULL if none open
+    ULONGLONG *aqwSlice;        // Every code sliced, NULL => not sliced
+} BOARD, *PBOARD;
+
+// BOARDSIZE - A board size, for lists of boards
+typedef struct _BOARDSIZE { /* bsz */
+    int     cPeg;               // Pegs per code
+    int     cColor;             // Number of colors
+    BOOL    fDup;               // TRUE => colors may repeat in a code
+} BOARDSIZE, *PBOARDSIZE;
+
+// BUILTIN - Lists and Feedback Table for a board, from MMTABLES.H
+typedef struct _BUILTIN { /* bi */
+    int     cPeg;               // Board
+    int     cColor;
+    BOOL    fDup;
+    DWORD   cCode;              // Codes in acode and apacked
+    const CODE *acode;          // Every code
+    const PACKED *apacked;      // Every code packed
+    const RESULT *aresTable;    // Feedback Table
+} BUILTIN, *PBUILTIN;
+
+// BENCHBOARD - A board size for /bench
+typedef struct _BENCHBOARD { /* bb */
+    int     cPeg;               // Pegs per code
+    int     cColor;             // Number of colors
+    BOOL    fDup;               // TRUE => colors may repeat
+    DWORD   cSolve;             // Games to solve
+} BENCHBOARD, *PBENCHBOARD;
+
+// POOL - Fixed-size slots, allocated by the slab
+typedef struct _POOL { /* pool */
+    DWORD   cbSlot;             // Bytes per slot, whole cache lines
+    DWORD   cSlotSlab;          // Slots per slab
+    int     cSlab;              // Slabs allocated
+    int     maxSlab;            // Room in apvSlab
+    void  **apvSlab;            // Slabs, as returned by malloc
+    void   *pvFree;             // First free slot; each links to the next
+} POOL, *PPOOL;
+
+// SESSION - One game hosted by the server
+typedef struct _SESSION { /* ses */
+    DWORD   id;                 // Session id; low cbitSession bits index
+    CODE    code;               // The code
+    PACKED  pkCode;             // The code, packed for ScorePacked
+    DWORD   iCode;              // The code's index on g.bdServer
+    int     cGuess;             // Guesses made
+    BOOL    fOver;              // TRUE => game won or lost
+    DWORD   stampBatch;         // ServerGuesses batch that set iFirst,iLast
+    WORD    iFirst;             // First guess for session in that batch
+    WORD    iLast;              // Last guess for session in that batch
+    struct _SESSION *psesNext;  // Next session of same pipe
+    struct _SESSION **ppsesPrev; // Link to this one; NULL if no pipe
+} SESSION, *PSESSION;
+
+// PIPESTATE - What a server pipe instance is waiting for
+typedef enum {PS_CONNECT, PS_READ, PS_WRITE} PIPESTATE; /* ps */
+
+// CHUNKTYPE - How a CHUNK keeps its codes
+typedef enum {CT_ARRAY, CT_BITMAP, CT_RUN} CHUNKTYPE; /* ct */
+
+// CHUNK - Codes of a CODESET with the same high index bits
+typedef struct _CHUNK { /* ch */
+    DWORD   iChunk;             // Codes are iChunk*cChunkCode + offset
+    CHUNKTYPE ct;
+    DWORD   c;                  // Codes in chunk, never 0
+    DWORD   cw;                 // CT_ARRAY: offsets; CT_RUN: 2 per run
+    WORD   *aw;                 // CT_ARRAY: offsets in order
+				// CT_RUN: first and last offset of each run
+    ULONGLONG *aqw;             // CT_BITMAP: bit for each offset
+} CHUNK, *PCHUNK;
+
+// CODESET - Compressed set of code indexes; see "Performance Notes (21)"
+typedef struct _CODESET { /* cs */
+    DWORD   c;                  // Codes in set
+    DWORD   cChunk;             // Chunks in ach
+    PCHUNK  ach;                // Chunks holding any codes, in order
+    DWORD   cb;                 // Bytes the chunks take
+} CODESET, *PCODESET;
+
+// PIPE - One server pipe instance
+typedef struct _PIPE { /* pipe */
+    OVERLAPPED ov;              // Must be first; see Server
+    HANDLE  h;                  // Pipe handle
+    PIPESTATE ps;               // What we are waiting for
+    BOOL    fRetry;             // TRUE => reconnect when retry wait is up
+    PSESSION pses;              // Sessions client started, for disconnect
+    DWORD   cbIn;               // Bytes in abIn
+    BYTE    abIn[cbPipeBuf];    // Requests read
+    BYTE    abOut[cbPipeBuf];   // Replies to write
+} PIPE, *PPIPE;
+
+// STRATEGY - One codebreaker in a tournament
+typedef struct _STRATEGY { /* strat */
+    char   *pszName;            // Plugin file, or name of built-in
+    HMODULE hmod;               // Plugin DLL, NULL if built-in
+    PFNSTRATBEGIN pfnBegin;     // See MMSTRAT.H
+    PFNSTRATGUESS pfnGuess;
+    PFNSTRATEND pfnEnd;
+    HANDLE  hThread;            // Thread playing the games
+    DWORD   cWin;               // Games won
+    DWORD   cLose;              // Games given up or out of guesses
+    DWORD   cMove;              // Guesses, all games won
+    int     cMoveMax;           // Most guesses to win one game
+    LONGLONG cpu;               // Thread CPU time, 100ns units
+} STRATEGY, *PSTRATEGY;
+
+// ANALYSIS - Header of /analyze table file
+//
+//  The table follows the header: one BYTE for each strategy and code, at
+//  [iStrat*cCode + iCode].  0 => not played yet, cMoveLost => lost, else
+//  guesses to win.
+typedef struct _ANALYSIS { /* an */
+    DWORD   sig;                // sigAnalysis
+    DWORD   cCode;              // Codes on board
+    BYTE    cPeg;               // Board analyzed
+    BYTE    cColor;
+    BYTE    fDup;
+    BYTE    cStrat;             // Strategies, one table row each
+    char    aachStrat[maxStrategy][cchStratName]; // Names, checked on resume
+} ANALYSIS, *PANALYSIS;
+
+// TOURNEY - Tournament settings and players
+typedef struct _TOURNEY { /* tny */
+    int     cPeg;               // Board to play
+    int     cColor;
+    BOOL    fDup;
+    DWORD   cSample;            // Codes to play, 0 => every code
+    unsigned seed;              // Seed for choosing sample
+    char   *pszReport;          // Report file, NULL => message box
+    BOARD   bd;                 // Board, codes listed
+    DWORD  *aiSecret;           // Codes to play
+    PPACKED apkSecret;          // Codes to play, if bd is not listed
+    DWORD   cSecret;            // Count of codes to play
+    BOOL    fAdversary;         // TRUE => play Adversary, not codes
+    BOOL    fSliced;            // TRUE => built-ins score bit-sliced
+    int     cStrat;             // Count of strategies
+    STRATEGY astrat[maxStrategy]; // Strategies
+    char   *pszAnalysis;        // /analyze table file
+    PANALYSIS pan;              // Table file view
+    BYTE   *acMove;             // Table, just past *pan
+    LONG    iCodeNext;          // Next code for a worker to take
+    LONG    cCodeDone;          // Codes every strategy has played
+} TOURNEY;
+
+// FIRSTSTATE - State of built-in strategy "first"
+typedef struct _FIRSTSTATE { /* fs */
+    BOARD   bd;                 // Board, codes listed unless fSet
+    DWORD  *aiCode;             // Codes still consistent
+    DWORD   c;                  // Count of codes still consistent
+    int     cMove;              // Moves aiCode has been filtered by
+    BOOL    fMinimax;           // TRUE => strategy "minimax"
+    DWORD   iGuessFirst;        // "minimax" opening, iCodeNone until known
+    DWORD  *aiGuessWork;        // Room for ChooseGuess
+    BOOK    bk;                 // "minimax" Opening Book, if there is one
+    DWORD  *acPart;
+    BOOL    fSet;               // TRUE => too many codes to list; cs
+				//  holds the codes still consistent
+    CODESET cs;
+    CODE    codeOpen;           // First guess of the first game
+    PCODESET acsOpen;           // Every code, split by codeOpen's
+				//  RESULTs; NULL until first game
+} FIRSTSTATE, *PFIRSTSTATE;
+
+// PROPMOVE - A move, as built-in strategy "propagate" keeps it
+typedef struct _PROPMOVE { /* pm */
+    BYTE    apeg[maxPegBoard];  // Guess
+    BYTE    acClr[maxColorBoard]; // Pegs of each color in guess
+    BYTE    cPosition;          // Pegs right in color and position
+    BYTE    cMatch;             // Pegs right in color, in position or not
+} PROPMOVE, *PPROPMOVE;
+
+// PROPSTATE - State of built-in strategy "propagate"
+typedef struct _PROPSTATE { /* prs */
+    BOARD   bd;                 // Board; codes not listed
+    int     cMove;              // Moves taken in by PropMove
+    PROPMOVE apm[maxGuessTourney]; // Those moves
+    BYTE    acMin[maxColorBoard]; // Fewest pegs each color can have
+    BYTE    acMax[maxColorBoard]; // Most pegs each color can have
+    WORD    afRoot[maxPegBoard]; // Colors each peg can have, bit each
+    CODE    code;               // Code PropSearch is building
+    DWORD   cNode;              // PropSearch calls for last guess
+    WORD    afBest[maxPegBoard]; // Colors of pegs where search got furthest
+    int     cPegBest;           // Pegs with one color in afBest, -1 if none
+} PROPSTATE, *PPROPSTATE;
+
+// GENEMOVE - A move, as built-in strategy "genetic" keeps it
+typedef struct _GENEMOVE { /* gm */
+    PACKED  pk;                 // Guess
+    BYTE    acDist[maxResult];  // How far each RESULT is from the answer
+} GENEMOVE, *PGENEMOVE;
+
+// GENEISLAND - One thread's codes for built-in strategy "genetic"
+typedef struct _GENEISLAND { /* gi */
+    CODE    acode[cGenePop];    // Codes evolving
+    WORD    afit[cGenePop];     // How far each is from fitting; 0 => fits
+    CODE    codeMigrant;        // Best code of the island before
+    WORD    fitMigrant;         // Its afit
+    BOOL    fMigrant;           // TRUE => codeMigrant not yet taken in
+    DWORD   seed;               // For GeneRandom
+    DWORD   cEval;              // Codes scored against the moves, this guess
+    DWORD   cGen;               // Generations, this guess
+    struct _GENESTATE *pgs;     // State the island is part of
+    HANDLE  hThread;            // GeneThread evolving it; NULL => guesser
+    HANDLE  hevGo;              // Set when a guess needs the island
+    HANDLE  hevDone;            // Set when the island has done its part
+} GENEISLAND, *PGENEISLAND;
+
+// GENESTATE - State of built-in strategy "genetic"
+typedef struct _GENESTATE { /* gs */
+    BOARD   bd;                 // Board; codes not listed
+    int     cMove;              // Moves taken in
+    GENEMOVE agm[maxGuessTourney]; // Those moves
+    int     cIsland;            // Islands, one thread each
+    GENEISLAND agi[maxGeneIsland];
+    CRITICAL_SECTION cs;        // Guards codeBest and migrants
+    volatile BOOL fFound;       // TRUE => codeBest fits; islands stop
+    volatile BOOL fQuit;        // TRUE => GeneThreads exit
+    WORD    fitBest;            // afit of codeBest
+    CODE    codeBest;           // Best code any island found this guess
+    DWORD   cGuess;             // Guesses since StratGeneticBegin
+    DWORD   cFit;               // Those that fit every move
+    double  cEval;              // Codes scored against the moves
+    double  cGen;               // Generations, all islands
+} GENESTATE, *PGENESTATE;
+
+// STATICJOB - Work shared by StaticThread threads
+typedef struct _STATICJOB { /* stj */
+    PBOARD  pbd;                // Board, with Feedback Table
+    DWORD  *aiFirst;            // Codes to guess first, see StaticCanonical
+    DWORD   cFirst;             // Count of them
+    LONG    iJobNext;           // Next first and second guess to take
+    volatile int cBest;         // Fewest guesses found that tell codes apart
+    DWORD   aiBest[maxStaticGuess]; // Those guesses
+    CRITICAL_SECTION cs;        // Guards cBest, aiBest and cNode
+    DWORD   msStart;            // GetTickCount() when search began
+    volatile BOOL fAbort;       // TRUE => out of time; cBest may not be fewest
+    double  cNode;              // Sets of guesses tried, all threads
+} STATICJOB, *PSTATICJOB;
+
+// STATICWORK - One StaticThread's room to search in
+typedef struct _STATICWORK { /* sw */
+    PSTATICJOB pstj;            // Job
+    DWORD   aiGuess[maxStaticGuess]; // Guesses so far
+    DWORD   acClass[maxStaticGuess+1]; // Classes after each of them
+    DWORD  *aaiClass;           // Class of each code, after each guess
+    DWORD  *acSize;             // Codes in each class, from StaticRefine
+    DWORD  *aiKeyClass;         // New class for each class and RESULT
+    DWORD  *aStamp;             // Stamp when aiKeyClass entry was set
+    DWORD   stamp;              // Bumped by each StaticRefine
+    DWORD   cNode;              // Sets of guesses tried
+} STATICWORK, *PSTATICWORK;
+
+// PARTJOB - Work shared by PartitionGuesses threads
+typedef struct _PARTJOB { /* pj */
+    PBOARD  pbd;                // Board, codes listed
+    DWORD  *aiGuess;            // Guesses to count partitions for
+    DWORD   cGuess;
+    DWORD  *aiCode;             // Codes to partition
+    DWORD   c;
+    DWORD  *acPart;             // cGuess rows of pbd->cResult counts
+    LONG    iGuessNext;         // Next guess block for a thread to take
+} PARTJOB, *PPARTJOB;
+
+// PFNSTREAM - Gets codes from StreamCodes; returns FALSE to stop it
+typedef BOOL (*PFNSTREAM)(void *pv, DWORD *aiCode, DWORD c);
+
+// STREAMJOB - Work shared by StreamCodes threads
+typedef struct _STREAMJOB { /* sj */
+    PBOARD  pbd;                // Board; codes need not be listed
+    int     cMove;              // Moves codes must fit
+    PACKED  apkGuess[maxMove];  // Guess of each move
+    RESULT  ares[maxMove];      // RESULT of each move
+    PFNSTREAM pfn;              // Gets codes that fit
+    void   *pv;                 // Passed to pfn
+    CRITICAL_SECTION cs;        // Held while pfn runs
+    LONG    iCodeNext;          // Next code block for a thread to take
+    BOOL    fStop;              // TRUE => pfn returned FALSE
+    DWORD   c;                  // Codes given to pfn
+} STREAMJOB, *PSTREAMJOB;
+
+// HINTLEVEL - Work space for one level of HintSolve
+typedef struct _HINTLEVEL { /* hl */
+    DWORD  *aiGuess;            // Guesses worth trying, best first
+    DWORD  *acPart;             // Partition counts for every guess
+    RESULT *ares;               // RESULT of each code for one guess
+} HINTLEVEL, *PHINTLEVEL;
+
+// HINTJOB - A hint being refined by HintThread
+typedef struct _HINTJOB { /* hj */
+    HWND    hwnd;               // Where MSG_HINT goes
+    LONG    gen;                // g.genHint when hint was asked for
+    DWORD   msStart;            // GetTickCount() when hint was asked for
+    BOOL    fAbort;             // TRUE => out of time, or hint not wanted
+    DWORD  *aiCode;             // Codes that fit the moves so far
+    DWORD   c;                  // Count of them
+    int     cGuessLeft;         // Guesses player has left
+    DWORD   iBest;              // Guess already shown, iCodeNone if none
+    DWORD   acSolve[maxMove+1]; // Most codes k guesses could be sure of
+    HINTLEVEL ahl[maxMove];     // Work space for each level
+} HINTJOB, *PHINTJOB;
+
+// SPEC - Speculation on the guess in the play row
+typedef struct _SPEC { /* spec */
+    LONG    gen;                // g.genSpec when speculation started
+    int     iMove;              // Row speculated on, -1 if none
+    SMOVE   asmove[maxMove];    // Moves before iMove, then guess in it
+    BOOL    fGrouped;           // TRUE => aiCode grouped by RESULT
+    DWORD   c;                  // Codes that fit the moves before iMove
+    DWORD  *aiCode;             // Those codes
+    DWORD   aiFirst[maxResult]; // First code in aiCode giving each RESULT
+    DWORD   ac[maxResult];      // Count of codes giving each RESULT
+    DWORD   aiBest[maxResult];  // Best next guess, iCodeNone if not known
+    DWORD  *aiGuess;            // Work space for ChooseGuess
+    DWORD  *acPart;
+    RESULT *ares;               // RESULT of each code for guess
+} SPEC, *PSPEC;
+
+typedef struct _GLOBAL { /* g */  // Global Variables
+    HWND    hwnd;               // Client window
+    int     cxMain;		// X width of main window
+    int     cyMain;		// Y width of main window
+    int     cxClient;           // X width of client area of window
+    int     cyClient;           // Y width of client area of window
+    int     cxButton;           // X width of widest button
+    int     cyButton;           // Y height of tallest button
+    int     cyButtonSpace;      // Y separation between buttons
+    int     xFun;		// X of Fun area
+    int     yFun;		// Y of Fun area
+    int     cxFun;		// X width of Fun area
+    int     cyFun;		// Y height of Fun area
+    GUESS   guessCode;          // The code
+    int     iMove;              // Current move index
+    PEG     pegMove;            // Peg value being dragged
+    MOVE    amove[maxMove];     // The game history
+    HANDLE  hInstance;          // App instance handle
+    FARPROC lpfnAboutDlgProc;   // About DlgProc instance function pointer
+    BOOL    fGameOver;		// TRUE => current game is over
+    BOOL    fGameWon;		// TRUE => player won current game
+    BOOL    fGuessAllowed;	// TRUE => guess button enabled
+    HDC     hdcLibrary;         // HDC for Image Library
+    HBITMAP hbmLibrary;         // HBM for Image Library
+    HDC     hdcMove;            // HDC for Move Area Back Buffer
+    HBITMAP hbmMove;            // HBM for Move Area Back Buffer
+    ANIMATE anim;               // Move Area animation state
+    unsigned seed;              // Seed given to srand
+    char   *pszRecord;          // Recording file name, NULL if none
+    FILE   *pfileRecord;        // Recording file, NULL if not recording
+    DWORD   msRecord;           // GetTickCount() when recording began
+    BOOL    fReplay;            // TRUE => replaying a recording
+    PRECORD arec;               // Recording being replayed
+    int     crec;               // Number of records in arec
+    int     irec;               // Next record to replay
+    DWORD   msReplay;           // Recorded time of current record
+    char   *pszReport;          // Replay report file, NULL => message box
+    HDC     hdcReplay;          // Off-screen client area during replay
+    HBITMAP hbmReplay;          // Off-screen client area bitmap
+    BOOL    fBench;             // TRUE => run benchmarks, no game
+    char   *pszBench;           // Benchmark JSON file, NULL => default
+    BOOL    fGenTables;         // TRUE => write MMTABLES.H, no game
+    char   *pszTables;          // File for GenTables
+    BOOL    fGenFeed;           // TRUE => write Feedback File, no game
+    BOARDSIZE bszFeed;          // Board for GenFeedback
+    BOOL    fGenBook;           // TRUE => write Opening Book, no game
+    int     cPlyBook;           // Guesses for GenBook
+    BOARD   bd;                 // Solver Engine board for our game
+    BOOK    bk;                 // Opening Book for our game's hints
+    BOOL    fServer;            // TRUE => run server, no game
+    char   *pszPipe;            // Server pipe name
+    HANDLE  hiocp;              // Server I/O completion port
+    POOL    poolSession;        // Where SESSIONs come from
+    PSESSION *apses;            // Sessions, indexed by low bits of id
+    DWORD  *aiSesFree;          // Free slots in apses
+    DWORD   ciSesFree;          // Count of free slots
+    DWORD   genSession;         // Generation for next session id
+    DWORD   stampBatch;         // Count of ServerGuesses batches
+    BOARD   bdServer;           // Server board, colors repeating, so
+				// every guess is listed
+    BOOL    fTourney;           // TRUE => run tournament, no game
+    BOOL    fAnalyze;           // TRUE => run worst-case analysis, no game
+    BOOL    fStatic;            // TRUE => run static solver, no game
+    BOARDSIZE bszStatic;        // Board for StaticSolve; cPeg 0 => all
+    char   *pszStaticReport;    // StaticSolve report, NULL => message box
+    BOOL    fAdversary;         // TRUE => Options/Adversary checked
+    BOOL    fAdvGame;           // TRUE => Adversary plays this game
+    DWORD  *aiAdv;              // Codes consistent with answers so far
+    DWORD   cAdv;               // Count of codes in aiAdv
+    RESULT *aresAdv;            // Room for PartitionCodes RESULTs
+    TOURNEY tny;                // Tournament
+    volatile LONG genHint;      // Bumped when hints are no longer wanted
+    HANDLE  hthHint;            // HintThread refining hint, NULL if none
+    DWORD   iHint;              // Code shown as hint, iCodeNone if none
+    SPEC    spec;               // Speculation on play row
+    volatile LONG genSpec;      // Bumped when speculation must stop
+    HANDLE  hthSpec;            // SpecThread, NULL if none
+#ifdef TIMING
+    LARGE_INTEGER liFreq;       // Performance counter ticks per second
+    LARGE_INTEGER liDrag;       // Time of first drag move not yet shown
+    BOOL    fDragPending;       // TRUE => liDrag is valid
+    HISTOGRAM ahist[nEvent];    // Latency histogram for each EVENT
+#endif
+    HCURSOR hcurCurrent;        // Current cursor
+    HCURSOR hcurDefault;        // Default cursor
+    HCURSOR hcurOverWell;       // Cursor when over Well, but not dragging
+    HCURSOR hcurDrag;           // Cursor during Drag
+    HCURSOR hcurDragOver;       // Cursor at Drag Over Move row in Move Area
+    HFONT   hfntButton; 	// Button font
+} GLOBAL,*PGLOBAL;
+
+
+// Where is the Mouse?
+typedef enum {WH_NOTOURS,WH_WELL, WH_MOVE} WHERE; /* wh */
+
+
+// HIT - What is under one cell of the Hit Test Map
+typedef struct _HIT { /* hit */
+    BYTE    wh;     // WHERE value
+    BYTE    ix;     // Color in Well Area, or Column in Move Area
+    BYTE    iy;     // Row in Move Area
+} HIT, *PHIT;
+
+
+// BUTTON - Information used to create a button in the client area.
+typedef struct tagButtonDescription { /* btn */
+    int     ids;    // String ID in resource file
+    int     idc;    // Command ID
+    long    style;  // Button Style
+    HWND    hwnd;   // Button window handle
+} BUTTON, *PBUTTON;
+
+
+/*****************
+ *** Variables **************************************************************
+ *****************/
+
+GLOBAL g;   // Globals
+
+DWORD   clrPeg[nColor] = {  // Maps PEG value to screen color
+    CLR_BLACK,
+    CLR_BLUE,
+    CLR_GREEN,
+    CLR_YELLOW,
+    CLR_RED,
+    CLR_WHITE,
+    };
+
+// Brush indicies for painting pins
+int aPinColor[nPin] = {
+    BLACK_BRUSH,    // Match Position and Color
+    WHITE_BRUSH,    // Match Color but not Position
+};
+
+// Client-Area button definitions
+BUTTON abutton[] = {
+  /* string id     control ID    style          hwnd */
+  /* ---------     ------------  -------------  ---- */
+    {IDS_NEW_GAME, IDC_NEW_GAME, BS_PUSHBUTTON, NULL},
+    {IDS_GUESS,    IDC_GUESS   , BS_PUSHBUTTON, NULL},
+};
+#define nButton (sizeof(abutton)/sizeof(BUTTON))
+
+// Button indicies
+#define iButtonNewGame  0
+#define iButtonGuess    1
+
+// Message types reported by replay
+REPLAYSTAT arstat[] = {
+  /* msg               name           c  liTotal */
+  /* ---------------   -------------  -  ------- */
+    {WM_MOUSEMOVE,     "MouseMove",   0, 0},
+    {WM_LBUTTONDOWN,   "LButtonDown", 0, 0},
+    {WM_LBUTTONUP,     "LButtonUp",   0, 0},
+    {WM_LBUTTONDBLCLK, "LButtonDbl",  0, 0},
+    {WM_RBUTTONUP,     "RButtonUp",   0, 0},
+    {WM_RBUTTONDBLCLK, "RButtonDbl",  0, 0},
+    {WM_KEYDOWN,       "KeyDown",     0, 0},
+    {WM_COMMAND,       "Command",     0, 0},
+    {WM_TIMER,         "Timer",       0, 0},
+    {WM_PAINT,         "Paint",       0, 0},
+};
+#define nReplayStat (sizeof(arstat)/sizeof(REPLAYSTAT))
+
+// Board sizes for /bench
+BENCHBOARD abbBench[] = {
+  /* cPeg  cColor  fDup   cSolve */
+  /* ----  ------  -----  ------ */
+    {4,    6,      FALSE,  360},        // Our game, every code
+    {4,    6,      TRUE,  1296},        // Classic MasterMind, every code
+    {5,    8,      TRUE,   256},
+    {6,    10,     TRUE,    16},
+    {8,    10,     TRUE,     2},        // Too many to list; CODESETs
+    {12,   12,     TRUE,     4},        // Too many to index; "genetic"
+};
+#define nBenchBoard (sizeof(abbBench)/sizeof(BENCHBOARD))
+
+// Bits set in each nibble, for RankCode
+BYTE acBitNibble[16] = {0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4};
+
+// Board sizes /gentables builds into MMTABLES.H
+BOARDSIZE abszBuiltIn[] = {
+  /* cPeg  cColor  fDup  */
+  /* ----  ------  ----- */
+    {nPeg, nColor, FALSE},              // Our game
+    {4,    6,      TRUE },              // Classic; /server scores on it
+};
+#define nBoardBuiltIn (sizeof(abszBuiltIn)/sizeof(BOARDSIZE))
+
+// Board sizes /static solves, unless told one
+BOARDSIZE abszStatic[] = {
+  /* cPeg  cColor  fDup  */
+  /* ----  ------  ----- */
+    {2,    2,      TRUE},
+    {2,    3,      TRUE},
+    {2,    4,      TRUE},
+    {3,    2,      TRUE},
+    {3,    3,      TRUE},
+    {3,    4,      TRUE},
+    {4,    2,      TRUE},
+    {4,    3,      TRUE},
+    {4,    4,      TRUE},
+    {3,    5,      FALSE},
+    {4,    5,      FALSE},
+    {nPeg, nColor, FALSE},              // Our game
+    {4,    6,      TRUE},               // Classic MasterMind
+};
+#define nBoardStatic (sizeof(abszStatic)/sizeof(BOARDSIZE))
+
+#ifdef TIMING
+// Names of EVENTs for timing report
+char *apszEvent[nEvent] = {
+    "MouseMove",
+    "ButtonDown",
+    "ButtonUp",
+    "DblClk",
+    "Key",
+    "Command",
+    "Paint",
+    "Frame",
+    "DragToFrame",
+};
+#endif
+
+
+// mpResultToImage - This array is used to find the index in the Image
+//      Library Bitmap of a particular Result.  The first index is the
+//      cPosition, the second index is the cColor.
+//
+//      GenTables writes this array to MMTABLES.H, along with abiBuiltIn,
+//      the built-in Solver Engine tables.  See "Performance Notes (12)".
+
+#include "mmtables.h"
+
+
+// mpCellToHit - Hit Test Map.  The first index is y/cyHitCell, the second
+//      index is x/cxHitCell.  See "Performance Notes (4)" above.
+//
+//      BuildHitMap initializes this array.
+
+HIT mpCellToHit[cyHitMap][cxHitMap];
+
+
+/***************************
+ *** Function Prototypes ****************************************************
+ ***************************/
+
+int PASCAL WinMain(HANDLE hInstance,
+		   HANDLE hPrevInstance,
+		   LPSTR lpszCmdLine,
+		   int nCmdShow);
+
+BOOL FAR PASCAL AboutDlgProc(HWND hDlg,UINT msg,UINT wParam,LONG lParam);
+long FAR PASCAL WndProc(HWND hDlg,UINT msg,UINT wParam,LONG lParam);
+
+RESULT AdversaryAnswer(PBOARD pbd, DWORD *aiCode, DWORD *pc,
+		       PCPACKED ppkGuess, RESULT *ares);
+BOOL   Analyze(VOID);
+unsigned __stdcall AnalyzeThread(void *pv);
+VOID   AnimateDrag(HWND hwnd, PEG peg, int x, int y);
+VOID   AnimateDragEnd(HWND hwnd);
+VOID   AnimateStart(HWND hwnd);
+VOID   AnimateStop(HWND hwnd);
+VOID   AnimateSwap(HWND hwnd, int iy, int ixSrc, int ixDst);
+VOID   AnimateTick(HWND hwnd);
+BOOL   BeginMM(HANDLE hInstance,HANDLE hPrevInstance);
+VOID   BenchBoard(FILE *pfile, PBENCHBOARD pbb, int *pcRecord);
+double BenchElapsed(LARGE_INTEGER *pliStart);
+VOID   BenchGenetic(FILE *pfile, PBENCHBOARD pbb, PBOARD pbd, int *pcRecord);
+VOID   Benchmark(char *pszFile);
+VOID   BenchServer(FILE *pfile, int *pcRecord);
+VOID   BenchSet(FILE *pfile, PBENCHBOARD pbb, PBOARD pbd, int *pcRecord);
+VOID   BenchWrite(FILE *pfile, int *pcRecord, PBOARD pbd, char *pszName,
+		  double cOp, double ns, DWORD check, char *pszExtra);
+BOOL   BoardBegin(PBOARD pbd, int cPeg, int cColor, BOOL fDup, BOOL fList);
+VOID   BoardEnd(PBOARD pbd);
+VOID   BoardShare(PBOARD pbd, PBOARD pbdOwner);
+BOOL   BoardSlice(PBOARD pbd);
+BOOL   BoardTable(PBOARD pbd);
+BOOL   BookBegin(PBOOK pbk, PBOARD pbd, char *pszStrat);
+VOID   BookEnd(PBOOK pbk);
+DWORD  BookGuess(PBOOK pbk, PBOARD pbd, PSMOVE asmove, int cMove);
+VOID   BookName(PBOARD pbd, char *pszStrat, char *psz, char *pszName);
+VOID   BuildHitMap(VOID);
+BOOL   CheckCode(PBOARD pbd, PCODE pcode);
+DWORD  ChooseGuess(PBOARD pbd, DWORD *aiCode, DWORD c, DWORD *aiGuess,
+		   DWORD *acPart);
+VOID   CreateBackBuffer(HDC hdcDisplay);
+int    CompareKey(const void *pv1, const void *pv2);
+int    CompareStrategy(const void *pv1, const void *pv2);
+BOOL   ChunkAnd(PCHUNK pch, PCHUNK pchOther, ULONGLONG *aqw);
+VOID   ChunkFree(PCHUNK pch);
+BOOL   ChunkPack(PCHUNK pch, ULONGLONG *aqw);
+VOID   ChunkScore(PBOARD pbd, DWORD iChunk, ULONGLONG *aqw,
+		  PCPACKED ppkGuess, ULONGLONG *aqwRes);
+VOID   ChunkSpread(PCHUNK pch, ULONGLONG *aqw);
+int    CountLanes(ULONGLONG qw);
+VOID   CreateButtons(HWND hwnd);
+VOID   CreateImageLibrary(HDC hdcDisplay);
+VOID   DestroyButtons(VOID);
+VOID   DoCommand(HWND hwnd,UINT wParam,LONG lParam);
+BOOL   DoMouse(HWND hwnd,UINT msg,UINT wParam,LONG lParam);
+VOID   EndMM(VOID);
+VOID   EraseForNewGame(HWND hwnd);
+VOID   FastSetCursor(HCURSOR hcur);
+DWORD  FilterCodes(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+		   RESULT res);
+DWORD  FilterCodesFeed(PBOARD pbd, DWORD *aiCode, DWORD c, DWORD iGuess,
+		       RESULT res);
+DWORD  FilterCodesSliced(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+			 RESULT res);
+DWORD  FilterCodesTable(PBOARD pbd, DWORD *aiCode, DWORD c, DWORD iGuess,
+			RESULT res);
+BOOL   FeedBegin(PBOARD pbd);
+VOID   FeedEnd(PBOARD pbd);
+VOID   FeedName(PBOARD pbd, char *psz);
+RESULT *FeedRow(PBOARD pbd, DWORD iGuess, DWORD iCode);
+DWORD  FitCodes(DWORD *aiCode, DWORD *piBest);
+int    GameMoves(PSMOVE asmove);
+BOOL   GenBook(VOID);
+BOOL   GenFeedback(PBOARDSIZE pbsz);
+BOOL   GenTables(char *pszFile);
+VOID   GeneBreed(PGENESTATE pgs, PGENEISLAND pgi);
+VOID   GeneEvolve(PGENESTATE pgs, PGENEISLAND pgi);
+VOID   GeneFitness(PGENESTATE pgs, PGENEISLAND pgi);
+int    GeneRandom(DWORD *pseed, int n);
+VOID   GeneRepair(PBOARD pbd, PCODE pcode, DWORD *pseed);
+unsigned __stdcall GeneThread(void *pv);
+HDC    GetClientDC(HWND hwnd);
+DWORD  GetTime(VOID);
+VOID   GroupCodes(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+		  RESULT *ares, DWORD *aiFirst, DWORD *acPart);
+VOID   HintFree(PHINTJOB phj);
+VOID   HintShow(HWND hwnd, LONG gen, DWORD iCode);
+BOOL   HintSolve(PHINTJOB phj, int iLevel, DWORD *aiCode, DWORD c, int k,
+		 DWORD *piGuess);
+VOID   HintStart(HWND hwnd);
+VOID   HintStop(VOID);
+unsigned __stdcall HintThread(void *pv);
+BOOL   MouseInArea(int xM,int yM,int x,int y,int cx,int cy);
+VOID   NewGame(VOID);
+BOOL   NextCode(PBOARD pbd, PCODE pcode);
+VOID   PackCode(PBOARD pbd, PCODE pcode, PPACKED ppk);
+void  *PoolAlloc(PPOOL ppool);
+BOOL   PoolBegin(PPOOL ppool, DWORD cb, DWORD cSlotSlab, DWORD maxSlot);
+VOID   PoolEnd(PPOOL ppool);
+VOID   PoolFree(PPOOL ppool, void *pv);
+BOOL   ParseCommandLine(LPSTR lpszCmdLine);
+VOID   PartitionCodes(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+		      RESULT *ares, DWORD *acPart);
+VOID   PartitionGuesses(PBOARD pbd, DWORD *aiGuess, DWORD cGuess,
+			DWORD *aiCode, DWORD c, DWORD *acPart);
+unsigned __stdcall PartitionThread(void *pv);
+BOOL   QueryResignGame(HWND hwnd);
+VOID   PaintAnswer(HWND hwnd);
+VOID   PaintAnswerSub(HDC hdc);
+VOID   PaintBoard(HDC hdc);
+VOID   PaintHolesForPegs(HWND hwnd);
+VOID   PaintLibrary(HDC hdc, int x, int y, int iLibrary);
+VOID   PaintMoveArea(HDC hdc);
+VOID   PaintPeg(HWND hwnd, int ix, int iy);
+VOID   PaintPegSub(HWND hwnd, int ix, int iy);
+VOID   PaintResult(HWND hwnd);
+VOID   PaintResultSub(HDC hdc, int iMove);
+VOID   PaintSprite(HDC hdc, int x, int y, PEG peg);
+VOID   PickCode(VOID);
+VOID   PlayerLost(HWND hwnd);
+VOID   PlayerLostSub(HDC hdc);
+VOID   PlayerTextOut(HDC hdc, char *psz);
+VOID   PlayerWon(HWND hwnd);
+VOID   PlayerWonSub(HDC hdc);
+int    PlayGame(PBOARD pbd, PSTRATEGY pstrat, void *pvStrat, PCPACKED ppkSecret,
+		DWORD *aiAdv, RESULT *aresAdv);
+VOID   PropFill(PPROPSTATE pprs);
+VOID   PropMove(PPROPSTATE pprs, PSMOVE psmove);
+BOOL   PropNarrow(PPROPSTATE pprs, WORD *afDom, BYTE *acMin, BYTE *acMax);
+BOOL   PropSearch(PPROPSTATE pprs, WORD *afDomAbove, BYTE *acMinAbove,
+		   BYTE *acMaxAbove);
+VOID   RandomCode(PBOARD pbd, PCODE pcode);
+VOID   Randomize(VOID);
+DWORD  RankCode(PBOARD pbd, PCCODE pcode);
+VOID   RecordBegin(VOID);
+VOID   RecordMessage(UINT msg,UINT wParam,LONG lParam);
+VOID   ReleaseClientDC(HWND hwnd, HDC hdc);
+BOOL   ReplayLoad(char *pszFile);
+BOOL   ReplayResign(VOID);
+VOID   ReplayRun(VOID);
+VOID   ReleaseMouse(VOID);
+RESULT ScoreCode(PBOARD pbd, PCCODE pcodeGuess, PCCODE pcodeCode);
+RESULT ScorePacked(PBOARD pbd, PCPACKED ppkGuess, PCPACKED ppkCode);
+VOID   ScoreSliced(PBOARD pbd, PCPACKED ppkGuess, ULONGLONG *aqw,
+		   ULONGLONG qwLanes, ULONGLONG *aqwRes);
+BOOL   Server(char *pszPipe);
+BOOL   ServerBatch(PPIPE ppipe, PSREQUEST asreq, PSREPLY asrep, DWORD *pc);
+BOOL   ServerBegin(VOID);
+VOID   ServerConnect(PPIPE ppipe);
+VOID   ServerDisconnect(PPIPE ppipe);
+VOID   ServerEnd(VOID);
+VOID   ServerGuesses(PSREQUEST asreq, PSREPLY asrep, DWORD c);
+BOOL   ServerRequest(PPIPE ppipe, PSREQUEST psreq, PSREPLY psrep);
+VOID   SessionEnd(PSESSION pses);
+PSESSION SessionFind(DWORD id);
+PSESSION SessionNew(PPIPE ppipe);
+BOOL   SetAnd(PCODESET pcs, PCODESET pcsOther);
+BOOL   SetBegin(PCODESET pcs, PBOARD pbd);
+VOID   SetEnd(PCODESET pcs);
+BOOL   SetFilter(PCODESET pcs, PBOARD pbd, PCPACKED ppkGuess, RESULT res);
+DWORD  SetFirst(PCODESET pcs);
+VOID   SetMouse(HWND hwnd);
+BOOL   SetPartition(PCODESET pcs, PBOARD pbd, PCPACKED ppkGuess,
+		     PCODESET acsPart);
+VOID   SliceCodes(PBOARD pbd, DWORD *aiCode, DWORD c, ULONGLONG *aqw);
+int    SolveCode(PBOARD pbd, DWORD iSecret, DWORD *aiWork);
+int    SolveCodeSet(PBOARD pbd, DWORD iSecret, PCODESET pcs, DWORD *pcbMax);
+int    SolveCodeStream(PBOARD pbd, DWORD iSecret);
+VOID   SpecFree(VOID);
+VOID   SpecStart(VOID);
+VOID   SpecStop(VOID);
+unsigned __stdcall SpecThread(void *pv);
+int    StaticBoard(PBOARDSIZE pbsz, char *psz);
+BOOL   StaticCanonical(PBOARD pbd, PCCODE pcode);
+VOID   StaticFound(PSTATICWORK psw, int cGuess);
+DWORD  StaticRefine(PSTATICWORK psw, int cGuess, DWORD iGuess, BOOL fAll);
+VOID   StaticSearch(PSTATICWORK psw, int cGuess, DWORD iGuessMin);
+BOOL   StaticSolve(VOID);
+unsigned __stdcall StaticThread(void *pv);
+BOOL   StaticWorkBegin(PSTATICJOB pstj, PSTATICWORK psw);
+VOID   StaticWorkEnd(PSTATICWORK psw);
+BOOL   StrategyLoad(PSTRATEGY pstrat);
+void * WINAPI StratFirstBegin(int cPeg, int cColor, BOOL fDup);
+VOID   WINAPI StratFirstEnd(void *pv);
+BOOL   WINAPI StratFirstGuess(void *pv, PSMOVE asmove, int cMove,
+			      BYTE *apegGuess);
+BOOL   StratFirstGuessSet(PFIRSTSTATE pfs, PSMOVE asmove, int cMove,
+			  BYTE *apegGuess);
+void * WINAPI StratGeneticBegin(int cPeg, int cColor, BOOL fDup);
+VOID   WINAPI StratGeneticEnd(void *pv);
+BOOL   WINAPI StratGeneticGuess(void *pv, PSMOVE asmove, int cMove,
+				BYTE *apegGuess);
+void * WINAPI StratMinimaxBegin(int cPeg, int cColor, BOOL fDup);
+void * WINAPI StratPropBegin(int cPeg, int cColor, BOOL fDup);
+VOID   WINAPI StratPropEnd(void *pv);
+BOOL   WINAPI StratPropGuess(void *pv, PSMOVE asmove, int cMove,
+			     BYTE *apegGuess);
+DWORD  StreamCodes(PBOARD pbd, PSMOVE asmove, int cMove, PFNSTREAM pfn,
+		   void *pv);
+BOOL   StreamFirst(void *pv, DWORD *aiCode, DWORD c);
+unsigned __stdcall StreamThread(void *pv);
+BOOL   TestGuess(VOID);
+BOOL   Tournament(VOID);
+VOID   TournamentFree(VOID);
+BOOL   TournamentLoad(VOID);
+unsigned __stdcall TournamentThread(void *pv);
+VOID   UnrankCode(PBOARD pbd, DWORD iCode, PCODE pcode);
+#ifdef TIMING
+VOID   TimingDump(HWND hwnd);
+VOID   TimingRecord(EVENT ev, LARGE_INTEGER *pliStart);
+VOID   TimingReport(char *psz);
+VOID   TimingSave(VOID);
+#endif
+
+
+/***************
+ *** WinMain ****************************************************************
+ ***************/
+
+int PASCAL WinMain(HANDLE hInstance,
+		   HANDLE hPrevInstance,
+		   LPSTR lpszCmdLine,
+		   int nCmdShow)
+{
+    MSG         msg;
+
+    if (!ParseCommandLine(lpszCmdLine))
+	exit(1);
+
+    //  Run benchmarks, if asked; no window needed
+
+    if (g.fBench) {
+	Benchmark(g.pszBench);
+	return 0;
+    }
+
+    //  Write built-in tables, if asked; no window needed
+
+    if (g.fGenTables)
+	return GenTables(g.pszTables) ? 0 : 1;
+
+    //  Write Feedback File, if asked; no window needed
+
+    if (g.fGenFeed)
+	return GenFeedback(&g.bszFeed) ? 0 : 1;
+
+    //  Write Opening Book, if asked; no window needed
+
+    if (g.fGenBook)
+	return GenBook() ? 0 : 1;
+
+    //  Run server, if asked; no window needed
+
+    if (g.fServer)
+	return Server(g.pszPipe) ? 0 : 1;
+
+    //  Run tournament, if asked; no window needed
+
+    if (g.fTourney)
+	return Tournament() ? 0 : 1;
+
+    //  Run worst-case analysis, if asked; no window needed
+
+    if (g.fAnalyze)
+	return Analyze() ? 0 : 1;
+
+    //  Run static solver, if asked; no window needed
+
+    if (g.fStatic)
+	return StaticSolve() ? 0 : 1;
+
+    if (!BeginMM(hInstance,hPrevInstance))
+	exit(1);
+
+    //  Replay recording, if asked, with window hidden
+
+    if (g.fReplay) {
+	ReplayRun();
+	DestroyWindow(g.hwnd);
+	EndMM();
+	return 0;
+    }
+
+    //  Start recording, if asked
+
+    if (g.pszRecord)
+	RecordBegin();
+
+    //  Show window
+
+    ShowWindow(g.hwnd,nCmdShow);
+    UpdateWindow(g.hwnd);
+
+    while(GetMessage(&msg,NULL,0,0))
+	{
+	TranslateMessage(&msg);
+	DispatchMessage(&msg);
+	}
+
+    EndMM();
+
+    return msg.wParam;
+}
+
+
+/************************************************
+ *** Functions - Listed in Alphabetical Order *******************************
+ ************************************************/
+
+/***    AboutDlgProc - About Dialog Box Procedure
+ *
+ */
+BOOL FAR PASCAL AboutDlgProc(HWND hdlg,UINT msg,UINT wParam,LONG lParam)
+{
+    switch (msg)
+	{
+	case WM_INITDIALOG:
+	    return TRUE;
+
+	case WM_COMMAND:
+	    switch (wParam)
+		{
+		case IDOK:
+		case IDCANCEL:
+		    EndDialog(hdlg, 0);
+		    return TRUE;
+		}
+	    break;
+	}
+    return FALSE;
+}
+
+
+/***    AdversaryAnswer - Answer a guess, giving away as little as possible
+ *
+ *      Entry
+ *          pbd      - board, with codes listed
+ *          aiCode   - codes consistent with answers so far
+ *          pc       - count of codes in aiCode
+ *          ppkGuess - guess
+ *          ares     - room for *pc RESULTs
+ *
+ *      Exit
+ *          Returns the RESULT shared by the most codes in aiCode, and not
+ *          a win unless no other RESULT is possible.  Codes that do not
+ *          give that RESULT are removed; *pc is updated.
+ *
+ *      See "Performance Notes (10)" above.
+ */
+RESULT AdversaryAnswer(PBOARD pbd, DWORD *aiCode, DWORD *pc,
+		       PCPACKED ppkGuess, RESULT *ares)
+{
+    DWORD   acPart[maxResult];  // Count of codes giving each RESULT
+    DWORD   i;
+    DWORD   iKeep;
+    int     res;
+    RESULT  resBest;
+
+    PartitionCodes(pbd,aiCode,*pc,ppkGuess,ares,acPart);
+
+    resBest = pbd->resWin;              // Only if nothing else is left
+    for (res=0; res<pbd->cResult; res++)
+	if ((res != pbd->resWin) &&
+	    ((resBest == pbd->resWin) ? (acPart[res] > 0)
+				      : (acPart[res] > acPart[resBest])))
+	    resBest = (RESULT)res;
+
+    iKeep = 0;
+    for (i=0; i<*pc; i++)
+	if (ares[i] == resBest)
+	    aiCode[iKeep++] = aiCode[i];
+    *pc = iKeep;
+    return resBest;
+}
+
+
+/***    Analyze - Find guesses each strategy needs for every code
+ *
+ *      Entry
+ *          g.tny has board, table file, report file, and plugin names.
+ *
+ *      Exit
+ *          Returns TRUE; table complete, report written.
+ *          Returns FALSE if analysis could not run; user has been told.
+ *
+ *      See "Performance Notes (11)" above.
+ */
+BOOL Analyze(VOID)
+{
+    char    ach[(maxStrategy+4)*128];
+    char    achCode[cPegStrat+1];
+    HANDLE  ahThread[maxAnalyzeThread];
+    DWORD   cb;
+    DWORD   cbFile;
+    DWORD   cbWritten;
+    DWORD   cLose;
+    int     cMove;
+    int     cMoveMax;
+    DWORD   cMoveSum;
+    DWORD   cThread;
+    DWORD   cWin;
+    DWORD   cWorst;
+    BOOL    fOK = FALSE;
+    HANDLE  hcon;
+    HANDLE  hfile = INVALID_HANDLE_VALUE;
+    HANDLE  hmap = NULL;
+    int     i;
+    DWORD   iCode;
+    unsigned idThread;
+    int     iPeg;
+    DWORD   iWorst;
+    DWORD   msFlush;
+    PANALYSIS pan;
+    PBOARD  pbd = &g.tny.bd;
+    FILE   *pfile;
+    char   *psz;
+    SYSTEM_INFO si;
+
+    if (g.tny.fAdversary || (g.tny.cSample != 0)) {
+	MessageBox(NULL,"Analysis plays every code; /adversary and /sample "
+			"do not apply.","MasterMind",
+		   MB_ICONEXCLAMATION | MB_OK);
+	goto Done;
+    }
+    if (!TournamentLoad())
+	goto Done;
+
+    // Map table file, new (grown and zeroed by mapping) or from last run
+    cb = sizeof(ANALYSIS) + g.tny.cStrat*pbd->cCode;
+    hfile = CreateFile(g.tny.pszAnalysis,GENERIC_READ | GENERIC_WRITE,0,
+		       NULL,OPEN_ALWAYS,FILE_ATTRIBUTE_NORMAL,NULL);
+    cbFile = (hfile != INVALID_HANDLE_VALUE) ? GetFileSize(hfile,NULL) : 0;
+    if ((hfile != INVALID_HANDLE_VALUE) && ((cbFile == 0) || (cbFile == cb)))
+	hmap = CreateFileMapping(hfile,NULL,PAGE_READWRITE,0,cb,NULL);
+    if (hmap != NULL)
+	g.tny.pan = MapViewOfFile(hmap,FILE_MAP_WRITE,0,0,cb);
+    pan = g.tny.pan;
+
+    if ((pan != NULL) && (cbFile == 0)) { // New file
+	pan->sig = sigAnalysis;
+	pan->cCode = pbd->cCode;
+	pan->cPeg = pbd->cPeg;
+	pan->cColor = pbd->cColor;
+	pan->fDup = pbd->fDup;
+	pan->cStrat = g.tny.cStrat;
+	for (i=0; i<g.tny.cStrat; i++)
+	    strncpy(pan->aachStrat[i],g.tny.astrat[i].pszName,cchStratName-1);
+    }
+    for (i=0; (pan != NULL) && (i < g.tny.cStrat); i++)
+	if (strncmp(pan->aachStrat[i],g.tny.astrat[i].pszName,
+		    cchStratName-1) != 0)
+	    pan = NULL;
+    if ((pan == NULL) || (pan->sig != sigAnalysis) ||
+	(pan->cCode != pbd->cCode) || (pan->cPeg != pbd->cPeg) ||
+	(pan->cColor != pbd->cColor) || (pan->fDup != pbd->fDup) ||
+	(pan->cStrat != g.tny.cStrat)) {
+	sprintf(ach,"Cannot use analysis file %s.  To resume, give the same "
+		    "board and strategies as before.",g.tny.pszAnalysis);
+	MessageBox(NULL,ach,"MasterMind",MB_ICONEXCLAMATION | MB_OK);
+	goto Done;
+    }
+    g.tny.acMove = (BYTE *)(pan+1);
+
+    // Count codes finished before a restart
+    for (iCode=0; iCode<pbd->cCode; iCode++) {
+	for (i=0; i<g.tny.cStrat; i++)
+	    if (g.tny.acMove[i*pbd->cCode + iCode] == 0)
+		break;
+	if (i == g.tny.cStrat)
+	    g.tny.cCodeDone++;
+    }
+
+    // One worker per processor, showing progress until all are done
+    GetSystemInfo(&si);
+    cThread = min(max(si.dwNumberOfProcessors,1),maxAnalyzeThread);
+    for (i=0; i<(int)cThread; i++) {
+	ahThread[i] = (HANDLE)_beginthreadex(NULL,0,AnalyzeThread,NULL,0,
+					     &idThread);
+	if (ahThread[i] == NULL)
+	    break;
+    }
+    cThread = i;
+    if (cThread == 0)
+	goto Done;
+
+    AllocConsole();                     // Fails harmlessly if we have one
+    hcon = GetStdHandle(STD_OUTPUT_HANDLE);
+    msFlush = GetTickCount();
+    do {
+	sprintf(ach,"\r%lu of %lu codes analyzed",g.tny.cCodeDone,pbd->cCode);
+	WriteFile(hcon,ach,strlen(ach),&cbWritten,NULL);
+	if (GetTickCount() - msFlush >= msCheckpoint) {
+	    FlushViewOfFile(pan,0);
+	    msFlush = GetTickCount();
+	}
+    } while (WaitForMultipleObjects(cThread,ahThread,TRUE,msProgress) ==
+	     WAIT_TIMEOUT);
+    FlushViewOfFile(pan,0);
+    for (i=0; i<(int)cThread; i++)
+	CloseHandle(ahThread[i]);
+    sprintf(ach,"\r%lu of %lu codes analyzed\r\n",g.tny.cCodeDone,pbd->cCode);
+    WriteFile(hcon,ach,strlen(ach),&cbWritten,NULL);
+
+    // Sum up each strategy's row
+    psz = ach;
+    psz += sprintf(psz,"Analysis of %dx%d%s, %lu codes\n",pbd->cColor,
+		   pbd->cPeg,pbd->fDup ? "" : "u",pbd->cCode);
+    psz += sprintf(psz,"Average\tWorst\tAt worst\tLost\tWorst code\t"
+		       "Strategy\n");
+    for (i=0; i<g.tny.cStrat; i++) {
+	cWin = cLose = cMoveSum = cWorst = iWorst = 0;
+	cMoveMax = 0;
+	for (iCode=0; iCode<pbd->cCode; iCode++) {
+	    cMove = g.tny.acMove[i*pbd->cCode + iCode];
+	    if (cMove == cMoveLost) {
+		cLose++;
+		continue;
+	    }
+	    cWin++;
+	    cMoveSum += cMove;
+	    if (cMove > cMoveMax) {
+		cMoveMax = cMove;
+		cWorst = 0;
+		iWorst = iCode;
+	    }
+	    if (cMove == cMoveMax)
+		cWorst++;
+	}
+	for (iPeg=0; iPeg<pbd->cPeg; iPeg++)
+	    achCode[iPeg] = "0123456789ABCDEF"[pbd->acode[iWorst].apeg[iPeg]];
+	achCode[iPeg] = '\0';
+	psz += sprintf(psz,"%.3f\t%d\t%lu\t\t%lu\t%s\t\t%s\n",
+		       cWin ? (double)cMoveSum/cWin : 0.0,cMoveMax,cWorst,cLose,
+		       cWin ? achCode : "-",pan->aachStrat[i]);
+    }
+
+    pfile = g.tny.pszReport ? fopen(g.tny.pszReport,"w") : NULL;
+    if (pfile != NULL) {
+	fputs(ach,pfile);
+	fclose(pfile);
+    }
+    else
+	MessageBox(NULL,ach,"MasterMind Analysis",MB_OK);
+    fOK = TRUE;
+
+Done:
+    if (g.tny.pan != NULL)
+	UnmapViewOfFile(g.tny.pan);
+    if (hmap != NULL)
+	CloseHandle(hmap);
+    if (hfile != INVALID_HANDLE_VALUE)
+	CloseHandle(hfile);
+    TournamentFree();
+    return fOK;
+}
+
+
+/***    AnalyzeThread - Play every strategy against codes until none are left
+ *
+ *      Entry
+ *          pv - Not used
+ *          g.tny.iCodeNext - Next code no worker has taken
+ *
+ *      Exit
+ *          Returns 0; table filled in for every code this worker took.
+ */
+unsigned __stdcall AnalyzeThread(void *pv)
+{
+    void   *apvStrat[maxStrategy]; // Strategy states, for this thread only
+    int     cMove;
+    BOOL    fPlayed;
+    int     i;
+    DWORD   iCode;
+    DWORD   iCodeFirst;
+    DWORD   iCodeLast;
+    PBOARD  pbd = &g.tny.bd;
+    BYTE   *pcMove;
+    PSTRATEGY pstrat;
+
+    for (i=0; i<g.tny.cStrat; i++) {
+	pstrat = &g.tny.astrat[i];
+	apvStrat[i] = (*pstrat->pfnBegin)(pbd->cPeg,pbd->cColor,pbd->fDup);
+    }
+
+    while ((iCodeFirst = (DWORD)InterlockedExchangeAdd(&g.tny.iCodeNext,
+						       cCodeChunk)) <
+	   pbd->cCode) {
+	iCodeLast = min(iCodeFirst+cCodeChunk,pbd->cCode);
+	for (iCode=iCodeFirst; iCode<iCodeLast; iCode++) {
+	    fPlayed = FALSE;
+	    for (i=0; i<g.tny.cStrat; i++) {
+		pcMove = &g.tny.acMove[i*pbd->cCode + iCode];
+		if (*pcMove != 0)       // Played before a restart
+		    continue;
+		cMove = 0;              // Strategy cannot play this board
+		if (apvStrat[i] != NULL)
+		    cMove = PlayGame(pbd,&g.tny.astrat[i],apvStrat[i],
+				     &pbd->apacked[iCode],NULL,NULL);
+		*pcMove = (cMove != 0) ? (BYTE)cMove : cMoveLost;
+		fPlayed = TRUE;
+	    }
+	    if (fPlayed)
+		InterlockedIncrement(&g.tny.cCodeDone);
+	}
+    }
+
+    for (i=0; i<g.tny.cStrat; i++)
+	if (apvStrat[i] != NULL)
+	    (*g.tny.astrat[i].pfnEnd)(apvStrat[i]);
+    return 0;
+}
+
+
+/***    AnimateDrag - Show peg being dragged over the Move Area
+ *
+ *      Entry
+ *          hwnd - main window
+ *          peg  - Peg being dragged
+ *          x,y  - Mouse position (client coordinates, in Move Area)
+ *
+ *      Exit
+ *          Peg will be drawn at the next animation frame.  Over the active
+ *          row the peg is snapped into the hole where it would be dropped,
+ *          elsewhere it is centered on the mouse.
+ */
+VOID AnimateDrag(HWND hwnd, PEG peg, int x, int y)
+{
+    int     ix,iy;
+
+    x -= xMove;                         // Convert to Move Area coordinates
+    y -= yMove;
+    ix = x/cxPegBox;
+    iy = y/cyPegBox;
+
+    if (iy == g.iMove) {                // Over drop target, snap to hole
+	x = ix*cxPegBox;
+	y = iy*cyPegBox;
+    }
+    else {                              // Center peg on mouse
+	x -= cxPegBox/2;
+	y -= cyPegBox/2;
+    }
+
+    if (g.anim.fDrag && (x == g.anim.xDrag) && (y == g.anim.yDrag))
+	return;                         // Peg did not move
+
+#ifdef TIMING
+    if (!g.fDragPending) {              // Time until a frame shows this
+	QueryPerformanceCounter(&g.liDrag);
+	g.fDragPending = TRUE;
+    }
+#endif
+
+    g.anim.fDrag   = TRUE;
+    g.anim.pegDrag = peg;
+    g.anim.xDrag   = x;
+    g.anim.yDrag   = y;
+    AnimateStart(hwnd);                 // Draw it on next frame
+}
+
+
+/***    AnimateDragEnd - Stop showing peg being dragged
+ *
+ *      Entry
+ *          hwnd - main window
+ */
+VOID AnimateDragEnd(HWND hwnd)
+{
+    if (g.anim.fDrag) {
+	g.anim.fDrag = FALSE;
+	AnimateStart(hwnd);             // Erase it on next frame
+    }
+}
+
+
+/***    AnimateStart - Request a Move Area frame
+ *
+ *      Entry
+ *          hwnd - main window
+ *
+ *      Exit
+ *          Frame timer is running, and Move Area will be repainted on the
+ *          next tick.
+ */
+VOID AnimateStart(HWND hwnd)
+{
+    g.anim.fDirty = TRUE;
+    if (!g.anim.fTimer) {
+	g.anim.msLast  = GetTime();
+	g.anim.msAccum = 0;
+	SetTimer(hwnd,idTimerAnimate,msFrame,NULL);
+	g.anim.fTimer = TRUE;
+    }
+}
+
+
+/***    AnimateStop - Cancel all animation
+ *
+ *      Entry
+ *          hwnd - main window
+ */
+VOID AnimateStop(HWND hwnd)
+{
+    if (g.anim.fTimer) {
+	KillTimer(hwnd,idTimerAnimate);
+	g.anim.fTimer = FALSE;
+    }
+    g.anim.cTick  = 0;
+    g.anim.fDrag  = FALSE;
+    g.anim.fDirty = FALSE;
+}
+
+
+/***    AnimateSwap - Animate a move or swap of pegs in a row
+ *
+ *      Entry
+ *          hwnd  - main window
+ *          iy    - row of Move Area
+ *          ixSrc - column peg was dragged from (now holds old ixDst peg)
+ *          ixDst - column peg was dropped on
+ *
+ *          g.amove[iy] already holds the result of the swap.
+ */
+VOID AnimateSwap(HWND hwnd, int iy, int ixSrc, int ixDst)
+{
+    g.anim.iy = iy;
+
+    g.anim.asprite[0].peg    = g.amove[iy].guess[ixDst];
+    g.anim.asprite[0].ixFrom = ixSrc;
+    g.anim.asprite[0].ixTo   = ixDst;
+
+    g.anim.asprite[1].peg    = g.amove[iy].guess[ixSrc]; // May be PEG_BLANK
+    g.anim.asprite[1].ixFrom = ixDst;
+    g.anim.asprite[1].ixTo   = ixSrc;
+
+    g.anim.iTick = 0;
+    g.anim.cTick = cTickSwap;
+    AnimateStart(hwnd);
+}
+
+
+/***    AnimateTick - Handle animation timer
+ *
+ *      Entry
+ *          hwnd - main window
+ *
+ *      Exit
+ *          Swap advanced by the number of whole ticks that have elapsed,
+ *          and Move Area repainted if anything changed.  Timer is stopped
+ *          once there is nothing left to animate.
+ */
+VOID AnimateTick(HWND hwnd)
+{
+    HDC     hdc;
+    DWORD   ms;
+
+    ms = GetTime();
+    g.anim.msAccum += ms - g.anim.msLast;
+    g.anim.msLast = ms;
+
+    // Advance swap in fixed steps, catching up if timer messages are late
+    while ((g.anim.cTick > 0) && (g.anim.msAccum >= msFrame)) {
+	g.anim.msAccum -= msFrame;
+	g.anim.iTick++;
+	if (g.anim.iTick >= g.anim.cTick)
+	    g.anim.cTick = 0;           // Swap is done
+	g.anim.fDirty = TRUE;
+    }
+
+    if (g.anim.fDirty) {
+	hdc = GetClientDC(hwnd);
+	PaintMoveArea(hdc);
+	ReleaseClientDC(hwnd,hdc);
+    }
+
+    if (g.anim.cTick == 0) {            // Nothing is moving on its own
+	KillTimer(hwnd,idTimerAnimate);
+	g.anim.fTimer = FALSE;
+    }
+}
+
+
+/***    BeginMM - Initialize MasterMind
+ *
+ */
+BOOL BeginMM(HANDLE hInstance,HANDLE hPrevInstance)
+{
+    char        ach[cbMaxString];
+    int         cch;
+    int         cchButton;
+    int         cxChar;
+    int         cyChar;
+    HDC         hdc;
+    HFONT	hfnt;
+    int         i;
+    long        lStyle;
+    static char szAppName [] = "MastMind";
+    TEXTMETRIC  tm;
+    WNDCLASS    wndclass;
+
+    // Randomize number generator
+    Randomize();
+
+    // Build Hit Test Map from layout
+    BuildHitMap();
+
+    // Set up Solver Engine for our game
+    if (!BoardBegin(&g.bd,nPeg,nColor,FALSE,TRUE))
+	return FALSE;
+    g.aiAdv = malloc(g.bd.cCode*sizeof(DWORD));
+    g.aresAdv = malloc(g.bd.cCode*sizeof(RESULT));
+    if ((g.aiAdv == NULL) || (g.aresAdv == NULL))
+	return FALSE;
+    BookBegin(&g.bk,&g.bd,pszStratBook); // Use book, if there is one
+
+#ifdef TIMING
+    // Get performance counter rate for latency histograms
+    QueryPerformanceFrequency(&g.liFreq);
+#endif
+
+    // Save hInstance
+    g.hInstance = hInstance;
+
+    // Load Cursors
+
+    g.hcurDefault  = LoadCursor(NULL,IDC_ARROW);
+    g.hcurCurrent  = g.hcurDefault;  // Assume current is default
+    g.hcurOverWell = LoadCursor(g.hInstance,MIR(CUR_OVER_WELL));
+    g.hcurDrag     = LoadCursor(g.hInstance,MIR(CUR_DRAG));
+    g.hcurDragOver = LoadCursor(g.hInstance,MIR(CUR_DRAG_OVER));
+
+    // Register window class, if necessary
+    if (!hPrevInstance)
+	{
+	wndclass.style	       = CS_DBLCLKS;
+	wndclass.lpfnWndProc   = WndProc;
+	wndclass.cbClsExtra    = 0;
+	wndclass.cbWndExtra    = 0;
+	wndclass.hInstance     = g.hInstance;
+	wndclass.hIcon         = LoadIcon(hInstance, szAppName);
+	wndclass.hCursor       = NULL;  // We want total control of cursor
+	wndclass.hbrBackground = COLOR_APPWORKSPACE+1;
+	wndclass.lpszMenuName  = szAppName;
+	wndclass.lpszClassName = szAppName;
+
+	RegisterClass(&wndclass);
+	}
+
+    // Get system font metrics (to size buttons)
+    hdc = CreateDC("DISPLAY",NULL,NULL,NULL);
+
+    // Create Image Library DC and Bitmap
+
+    CreateImageLibrary(hdc);
+
+    // Create Move Area Back Buffer for animation
+
+    CreateBackBuffer(hdc);
+
+    // Get button font
+
+    g.hfntButton = GetStockObject(SYSTEM_FONT);
+
+    if (g.hfntButton == 0) {
+	// BUGBUG bens 01-Jul-1991 Create Font failed
+    }
+
+    // Get Font Metrics for sizing buttons
+
+    hfnt = SelectObject(hdc,g.hfntButton);
+    GetTextMetrics(hdc, &tm);
+    cxChar = tm.tmAveCharWidth;
+    cyChar = tm.tmHeight + tm.tmExternalLeading;
+
+    // Done with Display DC
+
+    SelectObject(hdc,hfnt);         // Restore original font
+    DeleteDC(hdc);
+
+
+    // Compute button dimensions
+
+    cchButton = 0;
+    for (i=0; i<nButton; i++) { // Get length of longest string
+	cch = LoadString(g.hInstance,abutton[i].ids,ach,sizeof(ach));
+	cchButton = max(cch,cchButton);
+    }
+
+    g.cxButton = (cchButton+4)*cxChar; // Give 2 char room on either side
+    g.cyButton = (7 * cyChar) / 4;  // BUGBUG - Magic number from petzold ex.
+    g.cyButtonSpace = g.cyButton/2;     // Button Spacing
+
+
+    // Compute size of client area and main window
+
+    g.cxClient = 2*cxBorder + cxWell + cxWellToButton + g.cxButton;
+
+    g.cyClient = 2*cyBorder + cyWell +
+		   cyWellToMove + cyMove +
+		   cyMoveToAnswer + cyAnswer;
+
+    g.cxMain   = g.cxClient +
+		 GetSystemMetrics(SM_CXBORDER);
+
+    g.cyMain   = g.cyClient +
+		 GetSystemMetrics(SM_CYBORDER) +
+		 GetSystemMetrics(SM_CYCAPTION) +
+		 GetSystemMetrics(SM_CYMENU);
+
+
+    // Compute Fun area dimensions
+
+    g.xFun  = xButton;
+    g.yFun  = yButton + 2*(g.cyButton+g.cyButtonSpace);
+    g.cxFun = g.cxButton;
+    g.cyFun = g.cyClient - (g.yFun+cyBorder);
+
+
+    // Create main window
+
+    LoadString(g.hInstance,IDS_APP_TITLE,ach,sizeof(ach));
+    lStyle = WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX;
+    g.hwnd = CreateWindow(
+		szAppName,          // Window class
+		ach,                // Window Title
+		lStyle,             // Window Style
+		CW_USEDEFAULT,      // Left edge of window
+		CW_USEDEFAULT,      // Top edge of window
+		g.cxMain,	    // Width of window
+		g.cyMain,	    // Height of window
+		NULL,               // Parent window
+		NULL,               // Control ID
+		hInstance,          // App instance
+		NULL                // lpCreateStruct
+	     );
+
+    // Create dialog procedure instance(s)
+    g.lpfnAboutDlgProc = MakeProcInstance(AboutDlgProc,g.hInstance);
+
+    return TRUE;
+}
+
+
+/***    BenchBoard - Run benchmarks for one board size
+ *
+ *      Entry
+ *          pfile    - JSON file
+ *          pbb      - board size
+ *          pcRecord - count of records written so far
+ *
+ *      Exit
+ *          One record written for each benchmark; *pcRecord updated.
+ *          A board with too many codes to list only gets BenchSet.
+ */
+VOID BenchBoard(FILE *pfile, PBENCHBOARD pbb, int *pcRecord)
+{
+    DWORD  *acPart;             // Partition counts
+    DWORD  *aiGuess;            // Guesses to partition by
+    DWORD  *aiWork;             // Candidate list
+    char    ach[cbMaxString];
+    RESULT *ares;               // Room for PartitionCodes
+    BOARD   bd;
+    BOARD   bdBare;             // bd, as if codes were not listed
+    DWORD   c;
+    DWORD   cGuess;             // Guesses to score against every code
+    DWORD   check;              // Checksum, so work is not optimized away
+    CODE    code;
+    DWORD   cRep;               // Repeats, so each timing is long enough
+    int     cTry;               // Guesses to solve one game
+    int     cTryMax;
+    DWORD   cTryTotal;
+    DWORD   i;
+    DWORD   iCode;
+    DWORD   iGuess;
+    DWORD   iRep;
+    LARGE_INTEGER li;
+    double  ns;
+    ULONGLONG *aqwSlice;        // bd's slices, while they are off
+    RESULT  res;
+    SMOVE   smove;              // Move for StreamCodes
+
+    if (!BoardBegin(&bd,pbb->cPeg,pbb->cColor,pbb->fDup,TRUE))
+	return;
+    if (bd.acode == NULL) {         // Too many codes to list
+	BenchSet(pfile,pbb,&bd,pcRecord);
+	BenchGenetic(pfile,pbb,&bd,pcRecord);
+	BoardEnd(&bd);
+	return;
+    }
+    BoardTable(&bd);                // NULL presTable if board too big,
+				    // and pff too if no Feedback File
+    aiWork = malloc(bd.cCode*sizeof(DWORD));
+    if (aiWork == NULL) {
+	BoardEnd(&bd);
+	return;
+    }
+
+    // Score: every code against a spread of guesses
+    cGuess = min(bd.cCode,64);
+    cRep = max(1,(4L<<20)/(cGuess*bd.cCode));
+
+    check = 0;
+    QueryPerformanceCounter(&li);
+    for (iRep=0; iRep<cRep; iRep++)
+	for (i=0; i<cGuess; i++) {
+	    iGuess = i*(bd.cCode/cGuess);
+	    for (iCode=0; iCode<bd.cCode; iCode++)
+		check += ScoreCode(&bd,&bd.acode[iGuess],&bd.acode[iCode]);
+	}
+    ns = BenchElapsed(&li);
+    BenchWrite(pfile,pcRecord,&bd,"score_scalar",
+	       (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+
+    check = 0;
+    QueryPerformanceCounter(&li);
+    for (iRep=0; iRep<cRep; iRep++)
+	for (i=0; i<cGuess; i++) {
+	    iGuess = i*(bd.cCode/cGuess);
+	    for (iCode=0; iCode<bd.cCode; iCode++)
+		check += ScorePacked(&bd,&bd.apacked[iGuess],
+				     &bd.apacked[iCode]);
+	}
+    ns = BenchElapsed(&li);
+    BenchWrite(pfile,pcRecord,&bd,"score_packed",
+	       (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+
+    if (bd.presTable != NULL) {
+	check = 0;
+	QueryPerformanceCounter(&li);
+	for (iRep=0; iRep<cRep; iRep++)
+	    for (i=0; i<cGuess; i++) {
+		iGuess = i*(bd.cCode/cGuess);
+		for (iCode=0; iCode<bd.cCode; iCode++)
+		    check += ScoreTable(&bd,iGuess,iCode);
+	    }
+	ns = BenchElapsed(&li);
+	BenchWrite(pfile,pcRecord,&bd,"score_table",
+		   (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+    }
+
+    // Filter: keep the codes consistent with one guess and its RESULT
+    check = 0;
+    ns = 0;
+    for (iRep=0; iRep<cRep; iRep++)
+	for (i=0; i<cGuess; i++) {
+	    iGuess = i*(bd.cCode/cGuess);
+	    iCode = (i*7919 + iRep) % bd.cCode; // Any code will do
+	    res = ScorePacked(&bd,&bd.apacked[iGuess],&bd.apacked[iCode]);
+	    for (c=0; c<bd.cCode; c++)
+		aiWork[c] = c;
+	    QueryPerformanceCounter(&li);
+	    check += FilterCodes(&bd,aiWork,bd.cCode,&bd.apacked[iGuess],res);
+	    ns += BenchElapsed(&li);
+	}
+    BenchWrite(pfile,pcRecord,&bd,"filter_packed",
+	       (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+
+    if (bd.presTable != NULL) {
+	check = 0;
+	ns = 0;
+	for (iRep=0; iRep<cRep; iRep++)
+	    for (i=0; i<cGuess; i++) {
+		iGuess = i*(bd.cCode/cGuess);
+		iCode = (i*7919 + iRep) % bd.cCode;
+		res = ScoreTable(&bd,iGuess,iCode);
+		for (c=0; c<bd.cCode; c++)
+		    aiWork[c] = c;
+		QueryPerformanceCounter(&li);
+		check += FilterCodesTable(&bd,aiWork,bd.cCode,iGuess,res);
+		ns += BenchElapsed(&li);
+	    }
+	BenchWrite(pfile,pcRecord,&bd,"filter_table",
+		   (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+    }
+
+    if (bd.pff != NULL) {
+	check = 0;
+	ns = 0;
+	for (iRep=0; iRep<cRep; iRep++)
+	    for (i=0; i<cGuess; i++) {
+		iGuess = i*(bd.cCode/cGuess);
+		iCode = (i*7919 + iRep) % bd.cCode;
+		res = ScorePacked(&bd,&bd.apacked[iGuess],&bd.apacked[iCode]);
+		for (c=0; c<bd.cCode; c++)
+		    aiWork[c] = c;
+		QueryPerformanceCounter(&li);
+		check += FilterCodesFeed(&bd,aiWork,bd.cCode,iGuess,res);
+		ns += BenchElapsed(&li);
+	    }
+	BenchWrite(pfile,pcRecord,&bd,"filter_file",
+		   (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+    }
+
+    if (BoardSlice(&bd)) {
+	check = 0;
+	ns = 0;
+	for (iRep=0; iRep<cRep; iRep++)
+	    for (i=0; i<cGuess; i++) {
+		iGuess = i*(bd.cCode/cGuess);
+		iCode = (i*7919 + iRep) % bd.cCode;
+		res = ScorePacked(&bd,&bd.apacked[iGuess],&bd.apacked[iCode]);
+		for (c=0; c<bd.cCode; c++)
+		    aiWork[c] = c;
+		QueryPerformanceCounter(&li);
+		check += FilterCodesSliced(&bd,aiWork,bd.cCode,
+					   &bd.apacked[iGuess],res);
+		ns += BenchElapsed(&li);
+	    }
+	BenchWrite(pfile,pcRecord,&bd,"filter_sliced",
+		   (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+    }
+
+    check = 0;                          // Same again, streamed
+    ns = 0;
+    memset(&smove,0,sizeof(SMOVE));
+    for (iRep=0; iRep<cRep; iRep++)
+	for (i=0; i<cGuess; i++) {
+	    iGuess = i*(bd.cCode/cGuess);
+	    iCode = (i*7919 + iRep) % bd.cCode;
+	    res = ScorePacked(&bd,&bd.apacked[iGuess],&bd.apacked[iCode]);
+	    memcpy(smove.apeg,bd.acode[iGuess].apeg,bd.cPeg);
+	    smove.cPosition = bd.mpResultToPos[res];
+	    smove.cColor = bd.mpResultToClr[res];
+	    iCode = iCodeNone;
+	    QueryPerformanceCounter(&li);
+	    check += StreamCodes(&bd,&smove,1,StreamFirst,&iCode);
+	    ns += BenchElapsed(&li);
+	}
+    BenchWrite(pfile,pcRecord,&bd,"filter_stream",
+	       (double)cRep*cGuess*bd.cCode,ns,check,NULL);
+    aqwSlice = bd.aqwSlice;             // Off until partition_sliced
+    bd.aqwSlice = NULL;
+
+    // Partition: count RESULTs of a spread of guesses over every code,
+    // one guess at a time, then blocked, then bit-sliced
+    cGuess = min(bd.cCode,1024);
+    acPart = malloc(cGuess*bd.cResult*sizeof(DWORD));
+    aiGuess = malloc(cGuess*sizeof(DWORD));
+    ares = malloc(bd.cCode*sizeof(RESULT));
+    if ((acPart != NULL) && (aiGuess != NULL) && (ares != NULL)) {
+	for (c=0; c<bd.cCode; c++)
+	    aiWork[c] = c;
+	for (i=0; i<cGuess; i++)
+	    aiGuess[i] = i*(bd.cCode/cGuess);
+
+	check = 0;
+	QueryPerformanceCounter(&li);
+	for (i=0; i<cGuess; i++) {
+	    PartitionCodes(&bd,aiWork,bd.cCode,&bd.apacked[aiGuess[i]],ares,
+			   acPart);
+	    check += acPart[i % bd.cResult];
+	}
+	ns = BenchElapsed(&li);
+	BenchWrite(pfile,pcRecord,&bd,"partition_single",
+		   (double)cGuess*bd.cCode,ns,check,NULL);
+
+	check = 0;
+	QueryPerformanceCounter(&li);
+	PartitionGuesses(&bd,aiGuess,cGuess,aiWork,bd.cCode,acPart);
+	ns = BenchElapsed(&li);
+	for (i=0; i<cGuess; i++)
+	    check += acPart[i*bd.cResult + i % bd.cResult];
+	BenchWrite(pfile,pcRecord,&bd,"partition_blocked",
+		   (double)cGuess*bd.cCode,ns,check,NULL);
+
+	if (aqwSlice != NULL) {         // Same again, bit-sliced
+	    bd.aqwSlice = aqwSlice;
+	    check = 0;
+	    QueryPerformanceCounter(&li);
+	    PartitionGuesses(&bd,aiGuess,cGuess,aiWork,bd.cCode,acPart);
+	    ns = BenchElapsed(&li);
+	    for (i=0; i<cGuess; i++)
+		check += acPart[i*bd.cResult + i % bd.cResult];
+	    BenchWrite(pfile,pcRecord,&bd,"partition_sliced",
+		       (double)cGuess*bd.cCode,ns,check,NULL);
+	}
+    }
+    bd.aqwSlice = aqwSlice;             // BoardEnd frees it
+    free(acPart);
+    free(aiGuess);
+    free(ares);
+
+    // Code generation, as PickCode does for a new game
+    srand(1);
+    check = 0;
+    QueryPerformanceCounter(&li);
+    for (i=0; i<100000; i++) {
+	RandomCode(&bd,&code);
+	check += code.apeg[0];
+    }
+    ns = BenchElapsed(&li);
+    BenchWrite(pfile,pcRecord,&bd,"pickcode",100000,ns,check,NULL);
+
+    // Rank every code, and unrank it as for a board too big to list
+    cRep = max(1,(1L<<20)/bd.cCode);
+    check = 0;
+    QueryPerformanceCounter(&li);
+    for (iRep=0; iRep<cRep; iRep++)
+	for (iCode=0; iCode<bd.cCode; iCode++)
+	    check += RankCode(&bd,&bd.acode[iCode]);
+    ns = BenchElapsed(&li);
+    BenchWrite(pfile,pcRecord,&bd,"rank",(double)cRep*bd.cCode,ns,check,NULL);
+
+    bdBare = bd;
+    bdBare.acode = NULL;
+    check = 0;
+    QueryPerformanceCounter(&li);
+    for (iRep=0; iRep<cRep; iRep++)
+	for (iCode=0; iCode<bd.cCode; iCode++) {
+	    UnrankCode(&bdBare,iCode,&code);
+	    check += code.apeg[bd.cPeg-1];
+	}
+    ns = BenchElapsed(&li);
+    BenchWrite(pfile,pcRecord,&bd,"unrank",(double)cRep*bd.cCode,ns,check,
+	       NULL);
+
+    // Solve whole games, secrets spread evenly over the codes
+    c = min(pbb->cSolve,bd.cCode);
+    cTryMax = 0;
+    cTryTotal = 0;
+    QueryPerformanceCounter(&li);
+    for (i=0; i<c; i++) {
+	cTry = SolveCode(&bd,i*(bd.cCode/c),aiWork);
+	cTryTotal += cTry;
+	cTryMax = max(cTryMax,cTry);
+    }
+    ns = BenchElapsed(&li);
+    sprintf(ach,"\"avg_guesses\": %.3f, \"max_guesses\": %d",
+	    (double)cTryTotal/c,cTryMax);
+    BenchWrite(pfile,pcRecord,&bd,"solve",c,ns,cTryTotal,ach);
+
+    free(aiWork);
+    BoardEnd(&bd);
+}
+
+
+/***    BenchElapsed - Get time since start of benchmark
+ *
+ *      Entry
+ *          pliStart - QueryPerformanceCounter at start
+ *
+ *      Exit
+ *          Returns nanoseconds since *pliStart.
+ */
+double BenchElapsed(LARGE_INTEGER *pliStart)
+{
+    LARGE_INTEGER liFreq;
+    LARGE_INTEGER liNow;
+
+    QueryPerformanceCounter(&liNow);
+    QueryPerformanceFrequency(&liFreq);
+    return (double)(liNow.QuadPart - pliStart->QuadPart) * 1e9 /
+	   (double)liFreq.QuadPart;
+}
+
+
+/***    BenchGenetic - Time "genetic" on a board too big to list
+ *
+ *      Entry
+ *          pfile    - JSON file
+ *          pbb      - board size
+ *          pbd      - board, codes not listed
+ *          pcRecord - count of records written so far
+ *
+ *      Exit
+ *          Record written for solve_genetic, with how fast codes were
+ *          scored against the moves and how many guesses fit them all,
+ *          to tune the islands by.  See "Performance Notes (24)" above.
+ */
+VOID BenchGenetic(FILE *pfile, PBENCHBOARD pbb, PBOARD pbd, int *pcRecord)
+{
+    char    ach[2*cbMaxString];         // Extra JSON fields
+    CODE    code;
+    int     cLose = 0;
+    int     cTry;
+    int     cTryMax = 0;
+    DWORD   cTryTotal = 0;
+    DWORD   i;
+    LARGE_INTEGER li;
+    double  ns;
+    PGENESTATE pgs;
+    PACKED  pkSecret;
+    STRATEGY strat;
+
+    memset(&strat,0,sizeof(STRATEGY));
+    strat.pszName = "genetic";
+    StrategyLoad(&strat);
+    srand(1);
+    pgs = (*strat.pfnBegin)(pbd->cPeg,pbd->cColor,pbd->fDup);
+    if (pgs == NULL)
+	return;
+
+    QueryPerformanceCounter(&li);
+    for (i=0; i<pbb->cSolve; i++) {
+	RandomCode(pbd,&code);
+	PackCode(pbd,&code,&pkSecret);
+	cTry = PlayGame(pbd,&strat,pgs,&pkSecret,NULL,NULL);
+	if (cTry == 0)
+	    cLose++;
+	cTryTotal += cTry;
+	cTryMax = max(cTryMax,cTry);
+    }
+    ns = BenchElapsed(&li);
+    sprintf(ach,"\"avg_guesses\": %.3f, \"max_guesses\": %d, \"lost\": %d, "
+		"\"islands\": %d, \"evals_per_sec\": %.0f, "
+		"\"generations\": %.0f, \"guesses_fit\": %.3f",
+	    (cLose < (int)pbb->cSolve) ?
+		(double)cTryTotal/(pbb->cSolve-cLose) : 0.0,
+	    cTryMax,cLose,pgs->cIsland,(ns > 0) ? pgs->cEval*1e9/ns : 0.0,
+	    pgs->cGen,(pgs->cGuess > 0) ? (double)pgs->cFit/pgs->cGuess : 0.0);
+    BenchWrite(pfile,pcRecord,pbd,"solve_genetic",pbb->cSolve,ns,
+	       cTryTotal,ach);
+    (*strat.pfnEnd)(pgs);
+}
+
+
+/***    Benchmark - Time the Solver Engine, write results as JSON
+ *
+ *      Entry
+ *          pszFile - JSON file, NULL => mmbench.json
+ *
+ *      Exit
+ *          JSON file written.  See "Performance Notes (7)" above.
+ */
+VOID Benchmark(char *pszFile)
+{
+    char    ach[cbMaxString+cbMaxPath];
+    int     cRecord = 0;
+    int     i;
+    FILE   *pfile;
+    BOOL    fTell = (pszFile == NULL);  // No file given, so say where
+
+    if (pszFile == NULL)
+	pszFile = "mmbench.json";
+
+    pfile = fopen(pszFile,"w");
+    if (pfile == NULL) {
+	MessageBox(NULL,"Could not create benchmark file.",
+		   "MasterMind",MB_ICONEXCLAMATION | MB_OK);
+	return;
+    }
+
+    fprintf(pfile,"{\n  \"benchmarks\": [");
+    for (i=0; i<nBenchBoard; i++)
+	BenchBoard(pfile,&abbBench[i],&cRecord);
+    BenchServer(pfile,&cRecord);
+    fprintf(pfile,"\n  ]\n}\n");
+    fclose(pfile);
+
+    if (fTell) {
+	sprintf(ach,"Benchmark results written to %s.",pszFile);
+	MessageBox(NULL,ach,"MasterMind",MB_ICONINFORMATION | MB_OK);
+    }
+}
+
+
+/***    BenchServer - Time server guesses, one at a time and batched
+ *
+ *      Entry
+ *          pfile    - JSON file
+ *          pcRecord - count of records written so far
+ *
+ *      Exit
+ *          Records written for server_single and server_batch.
+ */
+VOID BenchServer(FILE *pfile, int *pcRecord)
+{
+    PSREPLY asrep;
+    PSREQUEST asreq;
+    DWORD   c;
+    DWORD   check;
+    int     fBatch;
+    DWORD   i;
+    DWORD   iRound;
+    LARGE_INTEGER li;
+    double  ns;
+    PSESSION pses;
+
+    if (!ServerBegin())
+	return;
+    asreq = malloc(cReqBench*sizeof(SREQUEST));
+    asrep = malloc(cReqBench*sizeof(SREPLY));
+    if ((asreq == NULL) || (asrep == NULL))
+	goto Done;
+
+    // Start sessions, then make guesses that go round them in turn
+    srand(1);
+    for (i=0; i<cSesBench; i++) {
+	asreq[i].op = SOP_NEW;
+	ServerRequest(NULL,&asreq[i],&asrep[i]);
+    }
+    for (i=0; i<cReqBench; i++) {
+	asreq[i].op = SOP_GUESS;
+	asreq[i].id = asrep[i % cSesBench].id;
+	for (c=0; c<nPeg; c++)
+	    asreq[i].apeg[c] = (BYTE)(rand() % nColor);
+    }
+
+    for (fBatch=0; fBatch<2; fBatch++) {
+	check = 0;
+	ns = 0;
+	for (iRound=0; iRound<cRoundBench; iRound++) {
+	    // Every session starts the round with no guesses
+	    for (i=0; i<cSesBench; i++) {
+		pses = SessionFind(asreq[i].id);
+		pses->cGuess = 0;
+		pses->fOver = FALSE;
+	    }
+
+	    QueryPerformanceCounter(&li);
+	    if (fBatch)                 // As many as one pipe read holds
+		for (i=0; i<cReqBench; i+=c) {
+		    c = min(cReqBench-i,maxBatch);
+		    ServerBatch(NULL,&asreq[i],&asrep[i],&c);
+		}
+	    else
+		for (i=0; i<cReqBench; i++)
+		    ServerRequest(NULL,&asreq[i],&asrep[i]);
+	    ns += BenchElapsed(&li);
+
+	    for (i=0; i<cReqBench; i++)
+		check += asrep[i].err*25 + asrep[i].cPosition*5 +
+			 asrep[i].cColor;
+	}
+	BenchWrite(pfile,pcRecord,&g.bd,
+		   fBatch ? "server_batch" : "server_single",
+		   (double)cRoundBench*cReqBench,ns,check,NULL);
+    }
+
+Done:
+    free(asreq);
+    free(asrep);
+    ServerEnd();
+}
+
+
+/***    BenchSet - Time solving codes of a board too big to list
+ *
+ *      Entry
+ *          pfile    - JSON file
+ *          pbb      - board size
+ *          pbd      - board, codes not listed
+ *          pcRecord - count of records written so far
+ *
+ *      Exit
+ *          Record written for solve_set, with the most bytes a CODESET
+ *          took, and for solve_stream, which solves the same codes.
+ *          See "Performance Notes (21)" and "(22)" above.
+ */
+VOID BenchSet(FILE *pfile, PBENCHBOARD pbb, PBOARD pbd, int *pcRecord)
+{
+    char    ach[cbMaxString];
+    DWORD   c;
+    DWORD   cbMax = 0;          // Most bytes any set took
+    DWORD   cbSolve;
+    CODESET cs;
+    int     cTry;
+    int     cTryMax = 0;
+    DWORD   cTryTotal = 0;
+    DWORD   i;
+    LARGE_INTEGER li;
+    double  ns;
+
+    if (pbd->cCode == 0)                // Too many codes to index
+	return;
+
+    c = min(pbb->cSolve,pbd->cCode);
+    QueryPerformanceCounter(&li);
+    for (i=0; i<c; i++) {
+	cTry = SolveCodeSet(pbd,i*(pbd->cCode/c) + pbd->cCode/(2*c),&cs,
+			    &cbSolve);
+	if (cTry == 0)                  // Out of memory
+	    return;
+	cTryTotal += cTry;
+	cTryMax = max(cTryMax,cTry);
+	cbMax = max(cbMax,cbSolve);
+    }
+    ns = BenchElapsed(&li);
+    sprintf(ach,"\"avg_guesses\": %.3f, \"max_guesses\": %d, "
+		"\"max_set_bytes\": %lu",
+	    (double)cTryTotal/c,cTryMax,(unsigned long)cbMax);
+    BenchWrite(pfile,pcRecord,pbd,"solve_set",c,ns,cTryTotal,ach);
+
+    cTryMax = 0;
+    cTryTotal = 0;
+    QueryPerformanceCounter(&li);
+    for (i=0; i<c; i++) {
+	cTry = SolveCodeStream(pbd,i*(pbd->cCode/c) + pbd->cCode/(2*c));
+	cTryTotal += cTry;
+	cTryMax = max(cTryMax,cTry);
+    }
+    ns = BenchElapsed(&li);
+    sprintf(ach,"\"avg_guesses\": %.3f, \"max_guesses\": %d",
+	    (double)cTryTotal/c,cTryMax);
+    BenchWrite(pfile,pcRecord,pbd,"solve_stream",c,ns,cTryTotal,ach);
+}
+
+
+/***    BenchWrite - Write one benchmark record
+ *
+ *      Entry
+ *          pfile    - JSON file
+ *          pcRecord - count of records written so far
+ *          pbd      - board that was timed
+ *          pszName  - name of benchmark
+ *          cOp      - operations timed
+ *          ns       - nanoseconds for all operations
+ *          check    - checksum of results
+ *          pszExtra - more JSON fields, or NULL
+ *
+ *      Exit
+ *          Record written; *pcRecord incremented.
+ */
+VOID BenchWrite(FILE *pfile, int *pcRecord, PBOARD pbd, char *pszName,
+		double cOp, double ns, DWORD check, char *pszExtra)
+{
+    fprintf(pfile,"%s\n    {\"board\": \"%dx%d%s\", \"pegs\": %d, "
+		  "\"colors\": %d, \"dup\": %s, \"name\": \"%s\", "
+		  "\"ops\": %.0f, \"ns_per_op\": %.2f, \"check\": %lu, "
+		  "\"cache_misses\": null%s%s}",
+	    (*pcRecord > 0) ? "," : "",
+	    pbd->cColor,pbd->cPeg,pbd->fDup ? "" : "u",
+	    pbd->cPeg,pbd->cColor,pbd->fDup ? "true" : "false",pszName,
+	    cOp,(cOp > 0) ? ns/cOp : 0.0,(unsigned long)check,
+	    pszExtra ? ", " : "",pszExtra ? pszExtra : "");
+    (*pcRecord)++;
+}
+
+
+/***    BoardBegin - Set up a BOARD for the Solver Engine
+ *
+ *      Entry
+ *          pbd    - board to set up
+ *          cPeg   - pegs per code (1..maxPegBoard)
+ *          cColor - number of colors (1..maxColorBoard)
+ *          fDup   - TRUE => colors may repeat in a code
+ *          fList  - TRUE => list (and pack) every code, if not too many
+ *
+ *      Exit-Success
+ *          Returns TRUE; RESULT maps filled in; codes listed, if asked.
+ *          For a board in MMTABLES.H, the lists and Feedback Table are
+ *          the built-in ones.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; board size is bad, or out of memory.
+ */
+BOOL BoardBegin(PBOARD pbd, int cPeg, int cColor, BOOL fDup, BOOL fList)
+{
+    PCODE   acode;              // Lists being built; pbd's are const
+    PPACKED apacked;
+    CODE    code;
+    double  cCode;
+    DWORD   iCode;
+    int     i;
+    int     iClr;
+    int     iPos;
+    BOOL    fUsed[maxColorBoard];
+
+    if ((cPeg < 1) || (cPeg > maxPegBoard) ||
+	(cColor < 1) || (cColor > maxColorBoard) ||
+	(!fDup && (cPeg > cColor)))
+	return FALSE;
+
+    memset(pbd,0,sizeof(BOARD));
+    pbd->cPeg = cPeg;
+    pbd->cColor = cColor;
+    pbd->fDup = fDup;
+
+    // Number RESULTs the way PaintLibrary numbers Result Pin Patterns
+    for (iPos=0; iPos<=cPeg; iPos++)
+	for (iClr=0; iClr<=cPeg; iClr++) {
+	    if ((iPos+iClr) > cPeg) {   // Invalid combination
+		pbd->mpPosClrToResult[iPos][iClr] = RESULT_NONE;
+		continue;
+	    }
+	    pbd->mpPosClrToResult[iPos][iClr] = (RESULT)pbd->cResult;
+	    pbd->mpResultToPos[pbd->cResult] = (BYTE)iPos;
+	    pbd->mpResultToClr[pbd->cResult] = (BYTE)iClr;
+	    pbd->cResult++;
+	}
+    pbd->resWin = pbd->mpPosClrToResult[cPeg][0];
+
+    // Count codes
+    cCode = 1;
+    for (i=0; i<cPeg; i++)
+	cCode *= fDup ? cColor : cColor-i;
+    pbd->cCode = (cCode > (double)0xFFFFFFFFL) ? 0 : (DWORD)cCode;
+
+    // Place value of each peg, for RankCode; see Performance Notes (18)
+    if (pbd->cCode != 0) {
+	pbd->aiPlace[cPeg-1] = 1;
+	for (i=cPeg-2; i>=0; i--)
+	    pbd->aiPlace[i] = pbd->aiPlace[i+1] * (fDup ? cColor : cColor-i-1);
+    }
+
+    if (!fList || (pbd->cCode == 0) || (pbd->cCode > maxCodeList))
+	return TRUE;                    // Caller does not need the list
+
+    // Use lists and Feedback Table from MMTABLES.H, if they are there
+    for (i=0; (i < nBuiltIn) && !g.fGenTables; i++)
+	if ((abiBuiltIn[i].cPeg == cPeg) && (abiBuiltIn[i].cColor == cColor) &&
+	    (abiBuiltIn[i].fDup == fDup)) {
+	    pbd->acode = abiBuiltIn[i].acode;
+	    pbd->apacked = abiBuiltIn[i].apacked;
+	    pbd->presTable = abiBuiltIn[i].aresTable;
+	    pbd->fBuiltIn = TRUE;
+	    return TRUE;
+	}
+
+    pbd->acode = acode = malloc(pbd->cCode*sizeof(CODE));
+    pbd->apacked = apacked = malloc(pbd->cCode*sizeof(PACKED));
+    if ((acode == NULL) || (apacked == NULL)) {
+	BoardEnd(pbd);
+	return FALSE;
+    }
+
+    // List codes in order, last peg changing fastest
+    memset(&code,0,sizeof(CODE));
+    iCode = 0;
+    for (;;) {
+	if (!fDup) {                    // Skip codes with repeated colors
+	    memset(fUsed,0,sizeof(fUsed));
+	    for (i=0; i<cPeg; i++) {
+		if (fUsed[code.apeg[i]])
+		    break;
+		fUsed[code.apeg[i]] = TRUE;
+	    }
+	}
+	if (fDup || (i == cPeg)) {
+	    acode[iCode] = code;
+	    PackCode(pbd,&code,&apacked[iCode]);
+	    iCode++;
+	}
+
+	// Advance to next code
+	for (i=cPeg-1; i>=0; i--) {
+	    if (++code.apeg[i] < cColor)
+		break;
+	    code.apeg[i] = 0;
+	}
+	if (i < 0)                      // Wrapped around, all done
+	    break;
+    }
+
+    // Begin Assert
+    if (iCode != pbd->cCode) {
+	AssertMsg("BoardBegin listed wrong number of codes.");
+    }
+    // End Assert
+    return TRUE;
+}
+
+
+/***    BoardEnd - Free memory used by a BOARD
+ *
+ */
+VOID BoardEnd(PBOARD pbd)
+{
+    if (!pbd->fBuiltIn && !pbd->fShared) { // Built-in tables are not ours
+	free((void *)pbd->acode);       // Const only to the rest of us
+	free((void *)pbd->apacked);
+	free((void *)pbd->presTable);
+    }
+    pbd->acode = NULL;
+    pbd->apacked = NULL;
+    pbd->presTable = NULL;
+    pbd->fBuiltIn = FALSE;
+    if (!pbd->fShared)                  // Ours, even on a built-in board
+	free(pbd->aqwSlice);
+    pbd->aqwSlice = NULL;
+    pbd->fShared = FALSE;
+    FeedEnd(pbd);
+}
+
+
+/***    BoardShare - Set up a BOARD using another BOARD's lists and tables
+ *
+ *      Entry
+ *          pbd      - board to set up
+ *          pbdOwner - board to share, codes listed; no Feedback File open
+ *
+ *      Exit
+ *          *pbd is *pbdOwner, but BoardEnd(pbd) frees none of what they
+ *          share.  pbdOwner must outlive pbd, and neither may be changed
+ *          while both are in use, except that BoardTable may open a
+ *          Feedback File for pbd, which pbd then owns.
+ *
+ *      See "Performance Notes (11)" above.
+ */
+VOID BoardShare(PBOARD pbd, PBOARD pbdOwner)
+{
+    *pbd = *pbdOwner;
+    pbd->fShared = TRUE;
+    pbd->pff = NULL;
+}
+
+
+/***    BoardSlice - Slice every code on a BOARD
+ *
+ *      Entry
+ *          pbd - board, with codes listed
+ *
+ *      Exit-Success
+ *          Returns TRUE; pbd->aqwSlice filled in.  Use FilterCodesSliced,
+ *          and PartitionGuesses scores bit-sliced from now on.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; codes not listed, or out of memory.
+ *
+ *      See "Performance Notes (19)" above.
+ */
+BOOL BoardSlice(PBOARD pbd)
+{
+    DWORD   aiCode[cLaneSlice]; // Codes in this slice
+    DWORD   c;
+    DWORD   i;
+    DWORD   iCode;
+
+    if (pbd->aqwSlice != NULL)          // Already sliced
+	return TRUE;
+    if (pbd->acode == NULL)
+	return FALSE;
+
+    pbd->aqwSlice = malloc((pbd->cCode+cLaneSlice-1)/cLaneSlice *
+			   cqwSlice(pbd)*sizeof(ULONGLONG));
+    if (pbd->aqwSlice == NULL)
+	return FALSE;
+    for (iCode=0; iCode<pbd->cCode; iCode+=c) {
+	c = min(cLaneSlice,pbd->cCode - iCode);
+	for (i=0; i<c; i++)
+	    aiCode[i] = iCode+i;
+	SliceCodes(pbd,aiCode,c,
+		   &pbd->aqwSlice[iCode/cLaneSlice*cqwSlice(pbd)]);
+    }
+    return TRUE;
+}
+
+
+/***    BoardTable - Build Feedback Table for a BOARD
+ *
+ *      Entry
+ *          pbd - board, with codes listed
+ *
+ *      Exit-Success
+ *          Returns TRUE; pbd->presTable filled in.  Use ScoreTable.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; codes not listed, too many codes, or out of memory.
+ */
+BOOL BoardTable(PBOARD pbd)
+{
+    DWORD   iCode;
+    DWORD   iGuess;
+    RESULT *pres;
+
+    if ((pbd->presTable != NULL) || (pbd->pff != NULL)) // Already built
+	return TRUE;
+    if (pbd->apacked == NULL)
+	return FALSE;
+    if (pbd->cCode > maxCodeTable)      // Too big for memory, try disk
+	return FeedBegin(pbd);
+
+    pres = malloc(pbd->cCode*pbd->cCode*sizeof(RESULT));
+    if (pres == NULL)
+	return FALSE;
+    pbd->presTable = pres;
+
+    for (iGuess=0; iGuess<pbd->cCode; iGuess++)
+	for (iCode=0; iCode<pbd->cCode; iCode++)
+	    *pres++ = ScorePacked(pbd,&pbd->apacked[iGuess],
+				  &pbd->apacked[iCode]);
+    return TRUE;
+}
+
+
+/***    BookBegin - Open Opening Book for a board and strategy
+ *
+ *      Entry
+ *          pbk      - book to open
+ *          pbd      - board, codes listed
+ *          pszStrat - strategy, plugin file or name of built-in
+ *
+ *      Exit
+ *          Returns TRUE; book mapped.  Use BookGuess.
+ *          Returns FALSE if there is no book for this board and strategy
+ *          (see GenBook), or it does not fit.  BookGuess finds nothing.
+ *
+ *      See "Performance Notes (17)" above.
+ */
+BOOL BookBegin(PBOOK pbk, PBOARD pbd, char *pszStrat)
+{
+    char    ach[cbMaxPath];
+    char    achStrat[cchStratName];
+    DWORD   cb = 0;
+    DWORD   cbHigh;
+    PBOOKHDR pbh;
+
+    memset(pbk,0,sizeof(BOOK));
+    if (g.fGenBook)                     // Making one; do not use old one
+	return FALSE;
+
+    BookName(pbd,pszStrat,ach,achStrat);
+    pbk->hfile = CreateFile(ach,GENERIC_READ,FILE_SHARE_READ,NULL,
+			    OPEN_EXISTING,FILE_FLAG_RANDOM_ACCESS,NULL);
+    if (pbk->hfile != INVALID_HANDLE_VALUE) {
+	cb = GetFileSize(pbk->hfile,&cbHigh);
+	if ((cbHigh == 0) && (cb >= sizeof(BOOKHDR)))
+	    pbk->hmap = CreateFileMapping(pbk->hfile,NULL,PAGE_READONLY,
+					  0,0,NULL);
+    }
+    if (pbk->hmap != NULL)
+	pbk->pbh = MapViewOfFile(pbk->hmap,FILE_MAP_READ,0,0,0);
+
+    pbh = pbk->pbh;
+    if ((pbh == NULL) || (pbh->sig != sigBook) ||
+	(pbh->cCode != pbd->cCode) || (pbh->cResult != (DWORD)pbd->cResult) ||
+	(pbh->cPeg != pbd->cPeg) || (pbh->cColor != pbd->cColor) ||
+	(pbh->fDup != pbd->fDup) ||
+	(strncmp(pbh->achStrat,achStrat,cchStratName) != 0) ||
+	(cb != sizeof(BOOKHDR) + pbh->cNode*sizeof(BOOKNODE))) {
+	BookEnd(pbk);
+	return FALSE;
+    }
+    pbk->abn = (PBOOKNODE)(pbh+1);
+    return TRUE;
+}
+
+
+/***    BookEnd - Close Opening Book
+ *
+ *      Entry
+ *          pbk - book from BookBegin
+ *
+ *      Exit
+ *          View unmapped, file closed.  BookGuess finds nothing.
+ */
+VOID BookEnd(PBOOK pbk)
+{
+    if (pbk->pbh != NULL)
+	UnmapViewOfFile(pbk->pbh);
+    if (pbk->hmap != NULL)
+	CloseHandle(pbk->hmap);
+    if ((pbk->hfile != NULL) && (pbk->hfile != INVALID_HANDLE_VALUE))
+	CloseHandle(pbk->hfile);
+    memset(pbk,0,sizeof(BOOK));
+}
+
+
+/***    BookGuess - Look up the next guess in an Opening Book
+ *
+ *      Entry
+ *          pbk    - book from BookBegin
+ *          pbd    - board, codes listed
+ *          asmove - moves so far this game
+ *          cMove  - count of moves so far
+ *
+ *      Exit
+ *          Returns code index of the next guess.
+ *          Returns iCodeNone if the game has left the book: too many
+ *          moves, or a guess the strategy would not have made.
+ */
+DWORD BookGuess(PBOOK pbk, PBOARD pbd, PSMOVE asmove, int cMove)
+{
+    int     i;
+    DWORD   iNode;
+    PBOOKNODE pbn;
+    RESULT  res;
+
+    if ((pbk->pbh == NULL) || (cMove >= pbk->pbh->cPly))
+	return iCodeNone;
+
+    pbn = &pbk->abn[0];
+    for (i=0; i<cMove; i++) {
+	if ((pbn->iGuess >= pbd->cCode) || (pbn->iChild == 0) ||
+	    (memcmp(asmove[i].apeg,pbd->acode[pbn->iGuess].apeg,pbd->cPeg)
+	     != 0))
+	    return iCodeNone;
+	res = pbd->mpPosClrToResult[asmove[i].cPosition][asmove[i].cColor];
+	iNode = pbn->iChild + res;
+	if ((res == RESULT_NONE) || (iNode >= pbk->pbh->cNode))
+	    return iCodeNone;
+	pbn = &pbk->abn[iNode];
+    }
+    return (pbn->iGuess < pbd->cCode) ? pbn->iGuess : iCodeNone;
+}
+
+
+/***    BookName - Make name of Opening Book for a board and strategy
+ *
+ *      Entry
+ *          pbd      - board
+ *          pszStrat - strategy, plugin file or name of built-in
+ *          psz      - receives file name, cbMaxPath bytes
+ *          pszName  - receives strategy name kept in book, cchStratName
+ *                     bytes
+ *
+ *      Exit
+ *          psz filled in, as in "mm6x4u-minimax.mmb", in the current
+ *          directory.  pszName is pszStrat without directory or
+ *          extension.
+ */
+VOID BookName(PBOARD pbd, char *pszStrat, char *psz, char *pszName)
+{
+    char   *pch;
+
+    for (pch=pszStrat; *pch != '\0'; pch++)
+	if ((*pch == '\\') || (*pch == '/') || (*pch == ':'))
+	    pszStrat = pch+1;
+    memset(pszName,0,cchStratName);
+    strncpy(pszName,pszStrat,cchStratName-1);
+    if ((pch = strchr(pszName,'.')) != NULL)
+	*pch = '\0';
+    sprintf(psz,"mm%dx%d%s-%.32s.mmb",pbd->cColor,pbd->cPeg,
+	    pbd->fDup ? "" : "u",pszName);
+}
+
+
+/***    BuildHitMap - Build Hit Test Map from layout
+ *
+ *      Exit
+ *          mpCellToHit filled in.  See "Performance Notes (4)" above.
+ */
+VOID BuildHitMap(VOID)
+{
+    PHIT    phit;
+    int     ix,iy;
+    int     x,y;
+
+    for (iy=0; iy<cyHitMap; iy++) {
+	for (ix=0; ix<cxHitMap; ix++) {
+	    phit = &mpCellToHit[iy][ix];
+	    x = ix*cxHitCell;           // Left top of cell
+	    y = iy*cyHitCell;
+
+	    if (MouseInArea(x,y,xWell,yWell,cxWell,cyWell)) {
+		phit->wh = WH_WELL;
+		phit->ix = (x-xWell)/cxPegBox;  // Color
+		phit->iy = 0;
+	    }
+	    else if (MouseInArea(x,y,xMove,yMove,cxMove,cyMove)) {
+		phit->wh = WH_MOVE;
+		phit->ix = (x-xMove)/cxPegBox;  // Column
+		phit->iy = (y-yMove)/cyPegBox;  // Row
+	    }
+	    else {
+		phit->wh = WH_NOTOURS;
+		phit->ix = 0;
+		phit->iy = 0;
+	    }
+
+	    // Begin Assert
+	    x += cxHitCell-1;           // Right bottom of cell
+	    y += cyHitCell-1;
+	    if (MouseInArea(x,y,xWell,yWell,cxWell,cyWell) !=
+		(phit->wh == WH_WELL)) {
+		AssertMsg("Well Area not aligned to Hit Test cells.");
+	    }
+	    if (MouseInArea(x,y,xMove,yMove,cxMove,cyMove) !=
+		(phit->wh == WH_MOVE)) {
+		AssertMsg("Move Area not aligned to Hit Test cells.");
+	    }
+	    // End Assert
+	}
+    }
+}
+
+
+/***    CheckCode - See if a code is on a board
+ *
+ *      Entry
+ *          pbd   - board; codes need not be listed
+ *          pcode - code
+ *
+ *      Exit
+ *          Returns TRUE if every color is in range, and none repeats when
+ *          colors may not repeat; else FALSE.  RankCode does the same
+ *          for a board with few enough codes to index.
+ */
+BOOL CheckCode(PBOARD pbd, PCODE pcode)
+{
+    WORD    fUsed = 0;          // Bit for each color used so far
+    int     i;
+
+    for (i=0; i<pbd->cPeg; i++) {
+	if (pcode->apeg[i] >= pbd->cColor)
+	    return FALSE;
+	if (!pbd->fDup && (fUsed & (1 << pcode->apeg[i])))
+	    return FALSE;
+	fUsed |= 1 << pcode->apeg[i];
+    }
+    return TRUE;
+}
+
+
+/***    ChooseGuess - Pick guess that leaves fewest codes in the worst case
+ *
+ *      Entry
+ *          pbd    - board, codes listed
+ *          aiCode - codes still consistent with the feedback
+ *          c      - count of codes in aiCode, not 0
+ *          aiGuess, acPart - room for pbd->cCode DWORDs, and for
+ *                            pbd->cCode*pbd->cResult DWORDs
+ *
+ *      Exit
+ *          Returns index of guess whose biggest partition of aiCode is
+ *          smallest; among those, one in aiCode if there is one.
+ *
+ *      Every code is tried as a guess when the board is small enough
+ *      for an in-memory Feedback Table, else only codes in aiCode.
+ */
+DWORD ChooseGuess(PBOARD pbd, DWORD *aiCode, DWORD c, DWORD *aiGuess,
+		  DWORD *acPart)
+{
+    DWORD   cGuess;
+    DWORD   cMax;               // Biggest partition for this guess
+    DWORD   cMaxBest;
+    DWORD  *pc;
+    BOOL    fIn;                // TRUE => guess is in aiCode
+    BOOL    fInBest;
+    DWORD   i;
+    DWORD   iBest;
+    int     res;
+
+    if (c <= 2)                         // Guessing one of them is best
+	return aiCode[0];
+
+    if (pbd->cCode <= maxCodeTable) {
+	cGuess = pbd->cCode;
+	for (i=0; i<cGuess; i++)
+	    aiGuess[i] = i;
+    }
+    else {
+	cGuess = c;
+	memcpy(aiGuess,aiCode,c*sizeof(DWORD));
+    }
+    PartitionGuesses(pbd,aiGuess,cGuess,aiCode,c,acPart);
+
+    iBest = aiCode[0];
+    cMaxBest = c+1;
+    fInBest = FALSE;
+    for (i=0, pc=acPart; i<cGuess; i++, pc+=pbd->cResult) {
+	cMax = 0;
+	for (res=0; res<pbd->cResult; res++)
+	    cMax = max(cMax,pc[res]);
+	fIn = (pc[pbd->resWin] != 0);   // Guess wins against itself only
+	if ((cMax < cMaxBest) || ((cMax == cMaxBest) && fIn && !fInBest)) {
+	    iBest = aiGuess[i];
+	    cMaxBest = cMax;
+	    fInBest = fIn;
+	}
+    }
+    return iBest;
+}
+
+
+/***    CreateBackBuffer - Create Move Area Back Buffer
+ *
+ *      Entry
+ *          hdc - Display DC
+ *
+ *      Exit
+ *          g.hdcMove has a bitmap the size of the Move Area, with the pen
+ *          and brush for the Move Area outline already selected.  If
+ *          anything fails, g.hdcMove is NULL and we fall back to painting
+ *          the Move Area directly and using cursors for dragging.
+ */
+VOID CreateBackBuffer(HDC hdcDisplay)
+{
+    g.hbmMove = CreateCompatibleBitmap(hdcDisplay,cxMove,cyMove);
+    if (g.hbmMove == NULL)
+	return;
+
+    g.hdcMove = CreateCompatibleDC(hdcDisplay);
+    if (g.hdcMove == NULL) {
+	DeleteObject(g.hbmMove);
+	g.hbmMove = NULL;
+	return;
+    }
+
+    SelectObject(g.hdcMove,g.hbmMove);
+    SelectObject(g.hdcMove,GetStockObject(BLACK_PEN));
+    SelectObject(g.hdcMove,GetStockObject(LTGRAY_BRUSH));
+}
+
+
+/***    CompareKey - qsort compare for DWORD sort keys
+ *
+ *      Entry
+ *          pv1, pv2 - DWORDs
+ *
+ *      Exit
+ *          Orders smallest first.
+ */
+int CompareKey(const void *pv1, const void *pv2)
+{
+    DWORD   dw1 = *(DWORD *)pv1;
+    DWORD   dw2 = *(DWORD *)pv2;
+
+    return (dw1 < dw2) ? -1 : (dw1 > dw2);
+}
+
+
+/***    CompareStrategy - qsort compare to rank tournament strategies
+ *
+ *      Entry
+ *          pv1, pv2 - STRATEGYs
+ *
+ *      Exit
+ *          Orders by games lost, then average guesses, then worst case,
+ *          then CPU time per guess.
+ */
+int CompareStrategy(const void *pv1, const void *pv2)
+{
+    double  d1;
+    double  d2;
+    PSTRATEGY pstrat1 = (PSTRATEGY)pv1;
+    PSTRATEGY pstrat2 = (PSTRATEGY)pv2;
+
+    if (pstrat1->cLose != pstrat2->cLose)
+	return (pstrat1->cLose < pstrat2->cLose) ? -1 : 1;
+
+    d1 = pstrat1->cWin ? (double)pstrat1->cMove/pstrat1->cWin : 0;
+    d2 = pstrat2->cWin ? (double)pstrat2->cMove/pstrat2->cWin : 0;
+    if (d1 != d2)
+	return (d1 < d2) ? -1 : 1;
+
+    if (pstrat1->cMoveMax != pstrat2->cMoveMax)
+	return (pstrat1->cMoveMax < pstrat2->cMoveMax) ? -1 : 1;
+
+    d1 = pstrat1->cMove ? (double)pstrat1->cpu/pstrat1->cMove : 0;
+    d2 = pstrat2->cMove ? (double)pstrat2->cpu/pstrat2->cMove : 0;
+    return (d1 < d2) ? -1 : (d1 > d2);
+}
+
+
+/***    CountLanes - Count bits set in a bit-sliced mask
+ *
+ *      Entry
+ *          qw - mask, a bit per lane
+ *
+ *      Exit
+ *          Returns count of lanes set.
+ */
+int CountLanes(ULONGLONG qw)
+{
+    qw -= (qw >> 1) & QW(0x55555555,0x55555555);
+    qw = (qw & QW(0x33333333,0x33333333)) +
+	 ((qw >> 2) & QW(0x33333333,0x33333333));
+    qw = (qw + (qw >> 4)) & QW(0x0F0F0F0F,0x0F0F0F0F); // Count per byte
+    return (int)((qw * QW(0x01010101,0x01010101)) >> 56);
+}
+
+
+/***    ChunkAnd - Keep only the codes of a chunk also in another chunk
+ *
+ *      Entry
+ *          pch      - chunk
+ *          pchOther - chunk with the same iChunk
+ *          aqw      - scratch, cqwChunk ULONGLONGs
+ *
+ *      Exit-Success
+ *          Returns TRUE; pch holds the codes in both, c of them, and
+ *          nothing if c is 0.  An array only shrinks, so stays an array;
+ *          any other result is stored in its smallest form.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; out of memory.  pch holds no codes.
+ *
+ *      See "Performance Notes (21)" above.
+ */
+BOOL ChunkAnd(PCHUNK pch, PCHUNK pchOther, ULONGLONG *aqw)
+{
+    WORD   *aw;
+    DWORD   c = 0;
+    DWORD   cw = 0;
+    BOOL    fIn;
+    DWORD   i;
+    DWORD   iOther = 0;
+    DWORD   iq;
+    DWORD   off;
+    DWORD   offFirst;
+    DWORD   offLast;
+    PCHUNK  pchArray;           // Array, if either is one
+    PCHUNK  pchWith;            // Chunk the array is checked against
+    ULONGLONG qwMask;
+
+    if ((pch->ct == CT_ARRAY) || (pchOther->ct == CT_ARRAY)) {
+	pchArray = (pch->ct == CT_ARRAY) ? pch : pchOther;
+	pchWith = (pch->ct == CT_ARRAY) ? pchOther : pch;
+	aw = malloc(pchArray->cw*sizeof(WORD));
+	if (aw == NULL) {
+	    ChunkFree(pch);
+	    return FALSE;
+	}
+	for (i=0; i<pchArray->cw; i++) {
+	    off = pchArray->aw[i];
+	    if (pchWith->ct == CT_ARRAY) { // Both sorted; walk them at once
+		while ((iOther < pchWith->cw) && (pchWith->aw[iOther] < off))
+		    iOther++;
+		fIn = (iOther < pchWith->cw) && (pchWith->aw[iOther] == off);
+	    }
+	    else if (pchWith->ct == CT_RUN) {
+		while ((iOther < pchWith->cw) && (pchWith->aw[iOther+1] < off))
+		    iOther += 2;
+		fIn = (iOther < pchWith->cw) && (pchWith->aw[iOther] <= off);
+	    }
+	    else
+		fIn = (BOOL)((pchWith->aqw[off >> 6] >> (off & 63)) & 1);
+	    if (fIn)
+		aw[c++] = (WORD)off;
+	}
+	ChunkFree(pch);
+	pch->ct = CT_ARRAY;
+	pch->c = c;
+	pch->cw = c;
+	pch->aw = aw;
+	if (c == 0) {
+	    free(aw);
+	    pch->aw = NULL;
+	}
+	return TRUE;
+    }
+
+    if ((pch->ct == CT_RUN) && (pchOther->ct == CT_RUN)) {
+	// Each run kept ends one of the two runs it came from
+	aw = malloc((pch->cw + pchOther->cw)*sizeof(WORD));
+	if (aw == NULL) {
+	    ChunkFree(pch);
+	    return FALSE;
+	}
+	i = 0;
+	while ((i < pch->cw) && (iOther < pchOther->cw)) {
+	    offFirst = max(pch->aw[i],pchOther->aw[iOther]);
+	    offLast = min(pch->aw[i+1],pchOther->aw[iOther+1]);
+	    if (offFirst <= offLast) {
+		aw[cw++] = (WORD)offFirst;
+		aw[cw++] = (WORD)offLast;
+		c += offLast - offFirst + 1;
+	    }
+	    if (pch->aw[i+1] < pchOther->aw[iOther+1])
+		i += 2;
+	    else
+		iOther += 2;
+	}
+	ChunkFree(pch);
+	pch->c = c;
+	pch->cw = cw;
+	pch->aw = aw;
+	if (c == 0) {
+	    ChunkFree(pch);
+	    return TRUE;
+	}
+	if (((c > maxArrayChunk) || (c > (DWORD)cw)) &&
+	    (2*cw < cqwChunk*sizeof(ULONGLONG)))
+	    return TRUE;                // Runs are still smallest
+	ChunkSpread(pch,aqw);
+	ChunkFree(pch);
+	return ChunkPack(pch,aqw);
+    }
+
+    // Bitmap and bitmap, or a bitmap and runs: mask a bitmap of pch
+    ChunkSpread(pch,aqw);
+    ChunkFree(pch);
+    if (pchOther->ct == CT_BITMAP)
+	for (iq=0; iq<cqwChunk; iq++)
+	    aqw[iq] &= pchOther->aqw[iq];
+    else                                // Clear the gaps between runs
+	for (i=0, off=0; i<=pchOther->cw; i+=2) {
+	    offLast = (i < pchOther->cw) ? pchOther->aw[i] : cChunkCode;
+	    while (off < offLast) {
+		cw = min(64 - (off & 63),offLast - off); // Bits in this word
+		qwMask = (cw == 64) ? ~(ULONGLONG)0 :
+			 (((ULONGLONG)1 << cw) - 1) << (off & 63);
+		aqw[off >> 6] &= ~qwMask;
+		off += cw;
+	    }
+	    if (i < pchOther->cw)
+		off = pchOther->aw[i+1] + 1;
+	}
+    for (iq=0; iq<cqwChunk; iq++)
+	c += CountLanes(aqw[iq]);
+    pch->c = c;
+    if (c == 0)
+	return TRUE;
+    return ChunkPack(pch,aqw);
+}
+
+
+/***    ChunkFree - Free the codes of a CHUNK
+ *
+ */
+VOID ChunkFree(PCHUNK pch)
+{
+    free(pch->aw);
+    free(pch->aqw);
+    pch->aw = NULL;
+    pch->aqw = NULL;
+}
+
+
+/***    ChunkPack - Store a chunk's codes in their smallest form
+ *
+ *      Entry
+ *          pch - chunk, iChunk and c filled in, no codes held
+ *          aqw - bitmap of the codes, cqwChunk ULONGLONGs
+ *
+ *      Exit-Success
+ *          Returns TRUE; pch holds the codes as CT_ARRAY, CT_BITMAP or
+ *          CT_RUN, whichever takes fewest bytes.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; out of memory.
+ */
+BOOL ChunkPack(PCHUNK pch, ULONGLONG *aqw)
+{
+    DWORD   cRun = 0;
+    DWORD   i;
+    DWORD   iw;
+    int     iBit;
+    ULONGLONG qw;
+    ULONGLONG qwPrev = 0;       // Last word, for runs across words
+
+    // Runs start where a bit is set and the bit below it is not
+    for (i=0; i<cqwChunk; i++) {
+	cRun += CountLanes(aqw[i] & ~((aqw[i] << 1) | (qwPrev >> 63)));
+	qwPrev = aqw[i];
+    }
+
+    if ((pch->c <= maxArrayChunk) && (pch->c <= 2*cRun)) {
+	pch->ct = CT_ARRAY;
+	pch->cw = pch->c;
+    }
+    else if (4*cRun < cqwChunk*sizeof(ULONGLONG)) {
+	pch->ct = CT_RUN;
+	pch->cw = 2*cRun;
+    }
+    else {
+	pch->ct = CT_BITMAP;
+	pch->aqw = malloc(cqwChunk*sizeof(ULONGLONG));
+	if (pch->aqw == NULL)
+	    return FALSE;
+	memcpy(pch->aqw,aqw,cqwChunk*sizeof(ULONGLONG));
+	return TRUE;
+    }
+
+    pch->aw = malloc(pch->cw*sizeof(WORD));
+    if (pch->aw == NULL)
+	return FALSE;
+    iw = 0;
+    for (i=0; i<cqwChunk; i++)
+	for (qw=aqw[i]; qw != 0; qw &= qw-1) {
+	    iBit = CountLanes((qw & (~qw+1)) - 1); // Lowest bit set
+	    if (pch->ct == CT_ARRAY)
+		pch->aw[iw++] = (WORD)(i*64 + iBit);
+	    else if ((iw == 0) || (pch->aw[iw-1] != i*64 + iBit - 1)) {
+		pch->aw[iw++] = (WORD)(i*64 + iBit); // New run
+		pch->aw[iw++] = (WORD)(i*64 + iBit);
+	    }
+	    else                        // Run goes on
+		pch->aw[iw-1]++;
+	}
+    return TRUE;
+}
+
+
+/***    ChunkScore - Score a guess against every code of a chunk
+ *
+ *      Entry
+ *          pbd      - board; codes need not be listed
+ *          iChunk   - chunk the codes are in
+ *          aqw      - bitmap of the codes, cqwChunk ULONGLONGs
+ *          ppkGuess - guess
+ *          aqwRes   - receives pbd->cResult bitmaps of cqwChunk
+ *                     ULONGLONGs, one for each RESULT
+ *
+ *      Exit
+ *          Bitmap res of aqwRes holds the codes of aqw for which the
+ *          guess gets res.
+ *
+ *      Each word of the bitmap is cLaneSlice codes, sliced and scored
+ *      with ScoreSliced if it holds at least cRunSlice of them, and
+ *      scored one at a time with ScorePacked if not.  Codes are made as
+ *      StreamThread makes them: while only the last peg changes, only
+ *      its plane is set a lane at a time.
+ *      See "Performance Notes (21)" above.
+ */
+VOID ChunkScore(PBOARD pbd, DWORD iChunk, ULONGLONG *aqw, PCPACKED ppkGuess,
+		ULONGLONG *aqwRes)
+{
+    ULONGLONG aqwLane[maxResult];       // Lanes of a word getting each
+    ULONGLONG aqwSlice[maxPegBoard*maxColorBoard]; // Codes of a word
+    CODE    code;
+    WORD    fPrefix = 0;        // Colors of all but last peg, if no repeats
+    BOOL    fSlice;
+    DWORD   iCode;
+    DWORD   iCodeLast = iCodeNone;      // Index of code, if any
+    int     iPeg;
+    int     iPegLast = pbd->cPeg - 1;
+    DWORD   iq;
+    int     peg;
+    PACKED  pk;
+    int     res;
+    ULONGLONG qw;
+    ULONGLONG qwBit;
+    ULONGLONG qwRun;            // Lanes since all but last peg changed
+
+    for (iq=0; iq<cqwChunk; iq++) {
+	memset(aqwLane,0,pbd->cResult*sizeof(ULONGLONG));
+	fSlice = (CountLanes(aqw[iq]) >= cRunSlice);
+	if (fSlice)
+	    memset(aqwSlice,0,cqwSlice(pbd)*sizeof(ULONGLONG));
+	qwRun = 0;
+	for (qw=aqw[iq]; qw != 0; qw ^= qwBit) {
+	    qwBit = qw & (~qw+1);       // Lowest code left in this word
+	    iCode = (iChunk << cbitChunk) + iq*64 + CountLanes(qwBit-1);
+	    peg = pbd->cColor;
+	    if ((iCodeLast != iCodeNone) && (iCode == iCodeLast+1))
+		for (peg=code.apeg[iPegLast]+1;
+		     (peg < pbd->cColor) && (fPrefix & (1 << peg)); peg++)
+		    ;
+	    if (peg < pbd->cColor)      // Only the last peg changes
+		code.apeg[iPegLast] = (BYTE)peg;
+	    else {
+		for (iPeg=0; fSlice && (iPeg<iPegLast); iPeg++)
+		    aqwSlice[iPeg*pbd->cColor + code.apeg[iPeg]] |= qwRun;
+		qwRun = 0;
+		if ((iCodeLast != iCodeNone) && (iCode == iCodeLast+1))
+		    NextCode(pbd,&code);
+		else
+		    UnrankCode(pbd,iCode,&code);
+		fPrefix = 0;
+		if (!pbd->fDup)
+		    for (iPeg=0; iPeg<iPegLast; iPeg++)
+			fPrefix |= 1 << code.apeg[iPeg];
+	    }
+	    iCodeLast = iCode;
+	    if (fSlice) {
+		aqwSlice[iPegLast*pbd->cColor + code.apeg[iPegLast]] |= qwBit;
+		qwRun |= qwBit;
+	    }
+	    else {
+		PackCode(pbd,&code,&pk);
+		aqwLane[ScorePacked(pbd,ppkGuess,&pk)] |= qwBit;
+	    }
+	}
+	if (fSlice) {
+	    for (iPeg=0; iPeg<iPegLast; iPeg++) // End of the word's last run
+		aqwSlice[iPeg*pbd->cColor + code.apeg[iPeg]] |= qwRun;
+	    ScoreSliced(pbd,ppkGuess,aqwSlice,aqw[iq],aqwLane);
+	}
+	for (res=0; res<pbd->cResult; res++)
+	    aqwRes[res*cqwChunk + iq] = aqwLane[res];
+    }
+}
+
+
+/***    ChunkSpread - Spread a chunk's codes into a bitmap
+ *
+ *      Entry
+ *          pch - chunk
+ *          aqw - receives bitmap, cqwChunk ULONGLONGs
+ */
+VOID ChunkSpread(PCHUNK pch, ULONGLONG *aqw)
+{
+    DWORD   i;
+    DWORD   off;
+
+    if (pch->ct == CT_BITMAP) {
+	memcpy(aqw,pch->aqw,cqwChunk*sizeof(ULONGLONG));
+	return;
+    }
+    memset(aqw,0,cqwChunk*sizeof(ULONGLONG));
+    if (pch->ct == CT_ARRAY)
+	for (i=0; i<pch->cw; i++)
+	    aqw[pch->aw[i] >> 6] |= (ULONGLONG)1 << (pch->aw[i] & 63);
+    else
+	for (i=0; i<pch->cw; i+=2)
+	    for (off=pch->aw[i]; off<=pch->aw[i+1]; off++)
+		aqw[off >> 6] |= (ULONGLONG)1 << (off & 63);
+}
+
+
+/***    CreateButtons - Create buttons in client area
+ *
+ */
+VOID CreateButtons(HWND hwnd)
+{
+    char        ach[cbMaxString];
+    HFONT	hfnt;
+    int         i;
+    long        lStyle;
+    int         x,y;
+
+    hfnt = GetStockObject(ANSI_VAR_FONT);   // Font for button text
+
+    x = xButton;
+    y = yButton;
+
+    for (i=0; i<nButton; i++) {
+	LoadString(g.hInstance,abutton[i].ids,ach,sizeof(ach));
+	lStyle = WS_CHILD | abutton[i].style;
+	abutton[i].hwnd = CreateWindow(
+	    "button",           // Window class
+	    ach,                // Button text
+	    lStyle,             // Button style;
+	    x,                  // Left edge of button
+	    y,                  // Top edge of button
+	    g.cxButton,         // Width of button
+	    g.cyButton,         // Height of button
+	    hwnd,               // Parent window (gets BM_ messages)
+	    abutton[i].idc,     // Button Control ID
+	    g.hInstance,        // App instance
+	    NULL);              // lpCreateStruct
+	y += (g.cyButton + g.cyButtonSpace);  // Advance button position
+
+	// Set button font
+	SendMessage(abutton[i].hwnd,WM_SETFONT,g.hfntButton,FALSE);
+
+	// Show button
+	ShowWindow(abutton[i].hwnd,SW_SHOWNORMAL);
+    }
+}
+
+
+/***    CreateImageLibrary - Create bitmap with all peg and pin images
+ *
+ *      Entry
+ *          hdc - Display DC
+ */
+VOID CreateImageLibrary(HDC hdcDisplay)
+{
+    int     acPins[2];
+    int     cPinsPainted;
+    HPEN    hpenSave;
+    HBRUSH  hbrush;
+    HBRUSH  hbrushLast;
+    HBRUSH  hbrushSave;
+    HDC     hdc;
+    int     i;
+    int     iClr;
+    int     iLoop;
+    int     iPinBox;
+    int     iPos;
+    int     x1,y1,x2,y2;
+
+    // Create Image Library Bitmap -- Same color depth as display!
+    g.hbmLibrary = CreateCompatibleBitmap(hdcDisplay,cxLibrary,cyLibrary);
+
+    // Create the memory DC
+    hdc = CreateCompatibleDC(hdcDisplay); // Image Library DC
+    g.hdcLibrary = hdc;                 // Save so we can free it at exit
+
+    SelectObject(hdc,g.hbmLibrary);     // Select bitmap into DC
+
+    // Set desired pen/brush and save default pen/brush
+
+    hpenSave = SelectObject(hdc,GetStockObject(BLACK_PEN));
+    hbrushSave = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
+
+    // Fill bitmap with background color (selected brush above!)
+
+    PatBlt(hdc,0,0,cxLibrary,cyLibrary,PATCOPY);
+
+    // Draw Color Pegs
+
+    x1 = cxPegOffset - cxImageBoxOffset;
+    x2 = x1+cxPeg;
+
+    y1 = cyPegOffset - cyImageBoxOffset;
+    for (i=0; i<nColor; i++) {
+	y2 = y1+cyPeg;
+	hbrush = CreateSolidBrush(clrPeg[i]); // Get brush for peg color
+	hbrushLast = SelectObject(hdc,hbrush);
+	if (i > 0)                      // Have a brush from last iteration
+	    DeleteObject(hbrushLast);   // Delete it!
+	Ellipse(hdc,x1,y1,x2,y2);
+	y1 += cyImageBox;
+    }
+
+    // Now, we have to delete the brush we created in the final iteration.
+    // So, we select in the brush we need for drawing the peg hole, and then
+    // we are able to delete that last brush we created!
+
+    hbrush = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
+    DeleteObject(hbrush);               // Delete brush from final iteration
+
+    //
+    // Draw Peg Hole
+    //
+
+    x1 = cxPegHoleOffset - cxImageBoxOffset;
+    x2 = x1 + cxPegHole;
+
+    y1 = nColor*cyImageBox + cyPegHoleOffset - cyImageBoxOffset;
+    y2 = y1 + cyPegHole;
+
+    Ellipse(hdc,x1,y1,x2,y2);
+
+    //
+    // Draw all valid combinations of Result Pin Patterns
+    //
+
+    for (iPos=0; iPos<=nPeg; iPos++) {
+	for (iClr=0; iClr<=nPeg; iClr++) {
+	    iPinBox = mpResultToLibrary[iPos][iClr]; // Built-in image index
+	    if (iPinBox < 0)            // Invalid combination
+		continue;               // Do next iteration of for loop!
+
+	    acPins[0] = iPos;           // Set count of positions for painting
+	    acPins[1] = iClr;           // Set count of colors for painting
+
+	    cPinsPainted = 0;           // No pins painted in this box, yet
+
+	    x1 = cxPinOffset - cxImageBoxOffset;
+	    y1 = iPinBox*cyImageBox + cyPinOffset - cyImageBoxOffset;
+
+	    // Paint black, then white pins
+	    for (iLoop=0; iLoop<nPin; iLoop++) {
+		// Select color
+		SelectObject(hdc,GetStockObject(aPinColor[iLoop]));
+
+		// Paint pins of this color
+		for (i=0; i<acPins[iLoop]; i++) {
+		    x2 = x1 + cxPin;
+		    y2 = y1 + cyPin;
+		    Ellipse(hdc,x1,y1,x2,y2); // Draw pin
+		    x1 = x2 + cxPinSpace;     // x for second pin
+		    cPinsPainted++;
+		    if (cPinsPainted == 2) {  // Wrap to second row of pins
+			x1 = cxPinOffset - cxImageBoxOffset; // x of third pin
+			y1 = y2 + cyPinSpace; // y for third and fourth pins
+		    }
+		}
+	    }
+	}
+    }
+
+    //
+    // Draw Peg Mask -- White background, black peg of same shape
+    //
+
+    y1 = iLibraryMask*cyImageBox;
+    PatBlt(hdc,0,y1,cxImageBox,cyImageBox,WHITENESS);
+
+    x1 = cxPegOffset - cxImageBoxOffset;
+    x2 = x1+cxPeg;
+    y1 += cyPegOffset - cyImageBoxOffset;
+    y2 = y1+cyPeg;
+
+    SelectObject(hdc,GetStockObject(BLACK_BRUSH));
+    Ellipse(hdc,x1,y1,x2,y2);
+
+    //
+    // Set restore original pen/brush
+    //
+
+    SelectObject(hdc,hpenSave);
+    SelectObject(hdc,hbrushSave);
+}
+
+
+/***    DestroyButtons - Destroy buttons in client area
+ *
+ */
+VOID DestroyButtons()
+{
+    int         i;
+
+    for (i=0; i<nButton; i++) {
+	DestroyWindow(abutton[i].hwnd);
+#ifdef DEBUG
+	abutton[i].hwnd = NULL;
+#endif
+    }
+}
+
+
+/***    DoCommand - Handle COMMAND messages
+ *
+ */
+VOID DoCommand(HWND hwnd,UINT wParam,LONG lParam)
+{
+    BOOL        f;
+
+    switch (wParam) {
+	case IDM_ABOUT:
+	    if (!g.fReplay)             // No dialogs during replay
+		DialogBox(g.hInstance,MIR(IDD_ABOUT),hwnd,g.lpfnAboutDlgProc);
+	    return;
+
+	case IDM_ADVERSARY:
+	    g.fAdversary = !g.fAdversary;
+	    CheckMenuItem(GetMenu(hwnd),IDM_ADVERSARY,
+			  g.fAdversary ? MF_CHECKED : MF_UNCHECKED);
+	    if ((g.iMove == 0) && !g.fGameOver) // No guess yet, so
+		NewGame();                      // change this game, too
+	    return;
+
+	case IDM_HINT:
+	    if (!g.fGameOver)
+		HintStart(hwnd);
+	    return;
+
+#ifdef TIMING
+	case IDM_TIMING:
+	    if (!g.fReplay)             // No dialogs during replay
+		TimingDump(hwnd);
+	    return;
+#endif
+
+	case IDC_GUESS:
+	    HintStop();         // Hint is for this row only
+	    SpecStop();         // Keep what was speculated for FitCodes
+	    f = TestGuess();
+	    PaintResult(hwnd);  // Show result
+
+	    // Disable Guess button
+	    EnableWindow(abutton[iButtonGuess].hwnd,FALSE);
+	    g.fGuessAllowed = FALSE;
+
+	    if (f) {    // Guess is correct
+		PlayerWon(hwnd); // Indicate a win
+
+		// Show answer
+		PaintAnswer(hwnd);
+
+		// Game won, disable play until New Game selected
+		g.fGameOver = TRUE;
+		g.fGameWon = TRUE;
+	    }
+	    else {  // Guess is not correct
+		g.iMove++;  // Advance to next row
+		if (g.iMove >= maxMove) { // Used up all guesses
+
+		    // Reset move index to last row, to keep PaintBoard
+		    // from crashing
+		    g.iMove = maxMove - 1;
+
+		    // Indicate the loss
+		    PlayerLost(hwnd);
+
+		    // Show answer
+		    PaintAnswer(hwnd);
+
+		    // Disable play until New Game selected
+		    g.fGameOver = TRUE;
+		    g.fGameWon = FALSE;
+		}
+		else {  // Player still has more guess(s) to make
+		    PaintHolesForPegs(hwnd); // Show where next moves go
+		}
+	    }
+	    return;
+
+	case IDC_NEW_GAME:
+	    if ( (g.iMove > 0) && (!g.fGameOver) ) { // Is game in progress?
+		// Verify that user wants to resign current game
+		if (QueryResignGame(hwnd)) {
+		    // Yes, user wants to resign.
+
+		    // Indicate loss
+		    PlayerLost(hwnd);
+
+		    // Show answer
+		    PaintAnswer(hwnd);
+
+		    // Disable play until New Game selected
+		    g.fGameOver = TRUE;
+		    g.fGameWon = FALSE;
+		}
+		else // No, user does not want to resign
+		    return; // Ignore command
+	    }
+	    else {  // No game underway, do new game
+		NewGame();  // New game
+		EraseForNewGame(hwnd);
+	    }
+	    return;
+    }
+}
+
+
+/***    DoMouse - Handle mouse messages
+ *
+ *	Entry
+ *	    Mouse message
+ *
+ *	Exit
+ *	    Return TRUE if we handled message
+ *	    Return FALSE if caller should handle message
+ */
+BOOL DoMouse(HWND hwnd,UINT msg,UINT wParam,LONG lParam)
+{
+    PHIT    phit;
+    int     i;
+    int     iWell;
+    int     ixMove,iyMove;
+    int     j;
+    WHERE   wh;
+    int     x,y;
+
+    static  BOOL    fDragging=FALSE;    // TRUE ==> Peg being dragged
+    static  int     ixMoveSrc,iyMoveSrc; // Source of copy/drag in Move Area
+    static  PEG     pegColor;           // Color of peg being moved
+    static  WHERE   whSource;           // Where Peg came from during drag
+
+    // Get mouse coordinates
+
+    x = LOWORD(lParam);
+    y = HIWORD(lParam);
+
+    // Figure out where mouse is -- See "Performance Notes (4)" above.
+
+    if ((x < xCursorRight) && (y < yCursorBottom)) {
+	phit = &mpCellToHit[y/cyHitCell][x/cxHitCell];
+	wh = phit->wh;
+	iWell = phit->ix;       // Color selected, if in Well Area
+	ixMove = phit->ix;      // Column selected, if in Move Area
+	iyMove = phit->iy;      // Row selected, if in Move Area
+    }
+    else {
+	wh = WH_NOTOURS;// Mouse is someplace else
+    }
+
+    // Now handle mouse message
+
+    switch (wh) {
+
+    case WH_NOTOURS:
+	switch (msg) {
+	case WM_MOUSEMOVE:
+	    if (fDragging) {
+		AnimateDragEnd(hwnd);   // Left Move Area, use cursor
+		FastSetCursor(g.hcurDrag);
+	    }
+	    else
+		FastSetCursor(g.hcurDefault);
+	    return TRUE;
+	    break;
+
+	case WM_LBUTTONUP:
+	    if (fDragging) {
+		fDragging = FALSE;
+		ReleaseMouse();
+		AnimateDragEnd(hwnd);
+		FastSetCursor(g.hcurDefault);
+	    }
+	    else
+		FastSetCursor(g.hcurDefault);
+	    return TRUE;            // We handled message
+	}
+	break;
+
+    case WH_WELL:
+	switch (msg) {
+	case WM_MOUSEMOVE:
+	    if (fDragging) {
+		AnimateDragEnd(hwnd);   // Left Move Area, use cursor
+		FastSetCursor(g.hcurDrag);
+	    }
+	    else
+		FastSetCursor(g.hcurOverWell);
+	    return TRUE;
+
+	case WM_LBUTTONDOWN:
+	    pegColor = iWell;           // Record color
+	    fDragging = TRUE;           // Note that we are dragging
+	    whSource = WH_WELL;         // It came from Well Area
+	    SetMouse(hwnd);             // Get that mouse
+	    FastSetCursor(g.hcurDrag);  // Change cursor
+	    return TRUE;                // We handled message
+
+	case WM_LBUTTONUP:
+	    if (fDragging) {
+		fDragging = FALSE;
+		ReleaseMouse();
+		AnimateDragEnd(hwnd);
+	    }
+	    FastSetCursor(g.hcurOverWell);
+	    return TRUE;                // We handled message
+	}
+	break;
+
+    case WH_MOVE:
+	switch (msg) {
+	case WM_MOUSEMOVE:
+	    if (fDragging) {
+		if (g.hdcMove) {        // We draw the peg ourselves
+		    AnimateDrag(hwnd,pegColor,x,y);
+		    FastSetCursor(NULL);
+		}
+		else if (iyMove == g.iMove)  // Over possible drop target
+		    FastSetCursor(g.hcurDragOver);
+		else
+		    FastSetCursor(g.hcurDrag);
+	    }
+	    else if (g.amove[iyMove].guess[ixMove] != PEG_BLANK)
+		FastSetCursor(g.hcurOverWell); // Player can move/copy this peg
+	    else
+		FastSetCursor(g.hcurDefault);
+	    return TRUE;
+
+	case WM_LBUTTONDOWN:
+	    pegColor = g.amove[iyMove].guess[ixMove]; // Record color
+	    if (pegColor == PEG_BLANK)  // No peg in that position
+		return TRUE;            // We handled message
+
+	    ixMoveSrc = ixMove;         // Keep track of source of drag/copy
+	    iyMoveSrc = iyMove;
+
+	    fDragging = TRUE;           // We are dragging
+	    whSource = WH_MOVE;         // It came from Move Area
+	    SetMouse(hwnd);             // Get that mouse
+	    if (g.hdcMove) {            // We draw the peg ourselves
+		AnimateDrag(hwnd,pegColor,x,y);
+		FastSetCursor(NULL);
+	    }
+	    else
+		FastSetCursor(g.hcurDrag);  // Set cursor
+	    return TRUE;                // We handled message
+
+	case WM_LBUTTONDBLCLK:
+	    if (iyMove == g.iMove) {	// Double Click occured on play row
+		// Check for first move
+		if (g.iMove == 0)	// If this is the first row
+		    return TRUE;	//  Do nothing
+
+		// Copy move down from previous row
+		for (i=0; i<nPeg; i++)
+		    g.amove[iyMove].guess[i] = g.amove[iyMove-1].guess[i];
+
+		// Paint pegs we just moved
+		// BUGBUG 03-Jul-1991 bens Would be faster to create DC once
+		for (i=0; i<nPeg; i++) {
+		    PaintPeg(hwnd,i,g.iMove);
+		}
+
+		// Turn on Guess button
+		EnableWindow(abutton[iButtonGuess].hwnd,TRUE);
+		g.fGuessAllowed = TRUE;
+		SpecStart();
+
+		// NOTE: The button up message will change the cursor, so
+		//	 we do not do it here.
+	    }
+	    return TRUE;
+
+	case WM_LBUTTONUP:
+	    if (fDragging) {
+		fDragging = FALSE;      // No longer dragging
+		ReleaseMouse();
+		AnimateDragEnd(hwnd);   // Stop drawing dragged peg
+
+		// Only do move if in active play row
+
+		if (iyMove != g.iMove) { // Drop did not occur on play row
+		    if (g.amove[iyMove].guess[ixMove] != PEG_BLANK)
+			FastSetCursor(g.hcurOverWell); // Move/Copy valid
+		    else
+			FastSetCursor(g.hcurDefault);
+		    return TRUE;        // We handled message
+		}
+
+		j = g.amove[iyMove].guess[ixMove]; // Remember destination
+
+		// Set color of destination
+
+		g.amove[iyMove].guess[ixMove] = pegColor; // dst = src
+
+		// See if we have to do a move/exchange
+
+		if ((whSource == WH_MOVE) && (iyMoveSrc == iyMove)) {
+		    // Do exchange
+		    g.amove[iyMoveSrc].guess[ixMoveSrc] = j; // src = dst
+		    if (g.hdcMove && (ixMoveSrc != ixMove))
+			AnimateSwap(hwnd,iyMove,ixMoveSrc,ixMove);
+		    else {
+			PaintPeg(hwnd,ixMove,iyMove);
+			PaintPeg(hwnd,ixMoveSrc,iyMoveSrc);
+		    }
+		}
+		else
+		    PaintPeg(hwnd,ixMove,iyMove); // Paint Peg
+
+		// Finally, if all pegs are placed, enable Guess button
+		j = 0;
+		for (i=0; i<nPeg; i++) {    // Count number of pegs
+		    if (g.amove[iyMove].guess[i] != PEG_BLANK) {
+			j++;
+		    }
+		}
+		if (j == nPeg) {
+		    EnableWindow(abutton[iButtonGuess].hwnd,TRUE);
+		    g.fGuessAllowed = TRUE;
+		    SpecStart();        // Work while player thinks
+		}
+	    }
+	    if (g.amove[iyMove].guess[ixMove] != PEG_BLANK)
+		FastSetCursor(g.hcurOverWell); // Player can move/copy this peg
+	    else
+		FastSetCursor(g.hcurDefault);
+	    return TRUE;                // We handled message
+	}
+	break;
+
+    default:
+	AssertMsg("Unexpected where value.");
+    }
+
+    // We did not handle message
+    return FALSE;
+}
+
+
+/***    EndMM - End MasterMind
+ *
+ */
+VOID EndMM(VOID)
+{
+#ifdef TIMING
+    // Write latency report, if asked for
+    TimingSave();
+#endif
+
+    // Free Solver Engine board
+
+    HintStop();
+    SpecStop();
+    SpecFree();
+    BookEnd(&g.bk);
+    free(g.aiAdv);
+    free(g.aresAdv);
+    BoardEnd(&g.bd);
+
+    // Finish recording
+
+    if (g.pfileRecord)
+	fclose(g.pfileRecord);
+
+    // Free dialog procedure instances
+
+    FreeProcInstance(g.lpfnAboutDlgProc);
+
+    // Free image library DC and Bitmap
+    // BUGBUG - Is it okay to delete DC and then Bitmap?  This is how
+    //          petzold does it.  This is different than everything other
+    //          object selected into a DC, where you must first select
+    //          back in the original object.
+
+    DeleteDC(g.hdcLibrary);
+    DeleteObject(g.hbmLibrary);
+
+    // Free Move Area Back Buffer DC and Bitmap
+
+    if (g.hdcMove) {
+	DeleteDC(g.hdcMove);
+	DeleteObject(g.hbmMove);
+    }
+
+    // Free cursors
+
+    // NOTE: Do not free g.hcurDefault -- it is a SYSTEM cursor!
+    DestroyCursor(g.hcurOverWell);
+    DestroyCursor(g.hcurDrag);
+    DestroyCursor(g.hcurDragOver);
+}
+
+
+/***    EraseForNewGame - Erase Result and Move Areas
+ *
+ */
+VOID EraseForNewGame(HWND hwnd)
+{
+    HBRUSH  hbrush;
+    HDC     hdc;
+    HPEN    hpen;
+    int     ix;
+
+    // Stop any swap in progress, it belongs to the old game
+    AnimateStop(hwnd);
+
+    hdc = GetClientDC(hwnd);
+
+    // Set desired pen/brush and save default pen/brush
+    hpen = SelectObject(hdc,GetStockObject(BLACK_PEN));
+    hbrush = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
+
+    // Clear Result, Move, and Fun Areas
+    Rectangle(hdc,xResult,yResult,xResult+cxResult,yResult+cyResult);
+    Rectangle(hdc,xMove,yMove,xMove+cxMove,yMove+cyMove);
+    Rectangle(hdc,xAnswer,yAnswer,xAnswer+cxAnswer,yAnswer+cyAnswer);
+    Rectangle(hdc,g.xFun,g.yFun,g.xFun+g.cxFun,g.yFun+g.cyFun);
+
+    // Paint Peg Holes in Move Area for 1st Move
+
+    for (ix=0; ix<nPeg; ix++) {
+	PaintPegSub(hdc,ix,0);
+    }
+
+    // Restore default pen and brush
+    SelectObject(hdc,hpen);
+    SelectObject(hdc,hbrush);
+
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***    FastSetCursor
+ *
+ *      Only set cursor if current setting is different from new setting.
+ */
+VOID FastSetCursor(HCURSOR hcur)
+{
+    if (hcur != g.hcurCurrent) {
+	if (!g.fReplay)                 // Leave real cursor alone in replay
+	    SetCursor(hcur);
+	g.hcurCurrent = hcur;
+    }
+}
+
+
+/***    FeedBegin - Open Feedback File for a BOARD
+ *
+ *      Entry
+ *          pbd - board, codes listed
+ *
+ *      Exit
+ *          Returns TRUE; pbd->pff open.  Use FeedRow or FilterCodesFeed.
+ *          Returns FALSE if there is no Feedback File for this board (see
+ *          GenFeedback), or it does not fit the board.
+ *
+ *      See "Performance Notes (13)" above.
+ */
+BOOL FeedBegin(PBOARD pbd)
+{
+    char    ach[cbMaxPath];
+    DWORD   cb;
+    DWORD   cbHigh;
+    DWORD   cBand;
+    FEEDHDR fh;
+    int     i;
+    PFEEDFILE pff;
+    ULONGLONG qwSize;           // Size file must be
+
+    pff = malloc(sizeof(FEEDFILE));
+    if (pff == NULL)
+	return FALSE;
+    memset(pff,0,sizeof(FEEDFILE));
+    pbd->pff = pff;
+    for (i=0; i<cViewFeed; i++)
+	pff->afv[i].iTile = iTileNone;
+
+    // Lookups jump all over the file, so ask for no read-ahead
+    FeedName(pbd,ach);
+    pff->hfile = CreateFile(ach,GENERIC_READ,FILE_SHARE_READ,NULL,
+			    OPEN_EXISTING,FILE_FLAG_RANDOM_ACCESS,NULL);
+    if ((pff->hfile == INVALID_HANDLE_VALUE) ||
+	!ReadFile(pff->hfile,&fh,sizeof(fh),&cb,NULL) || (cb != sizeof(fh)) ||
+	(fh.sig != sigFeed) || (fh.cCode != pbd->cCode) ||
+	(fh.cPeg != pbd->cPeg) || (fh.cColor != pbd->cColor) ||
+	(fh.fDup != pbd->fDup) || (fh.cTileGuess != cGuessTile) ||
+	(fh.cTileCode != cCodeTile)) {
+	FeedEnd(pbd);
+	return FALSE;
+    }
+
+    // Map whole file; FeedRow maps views of single tiles
+    pff->cBlock = (pbd->cCode + cCodeTile-1)/cCodeTile;
+    cBand = (pbd->cCode + cGuessTile-1)/cGuessTile;
+    qwSize = cbFeedHeader + (ULONGLONG)cBand*pff->cBlock*cbTile;
+    cb = GetFileSize(pff->hfile,&cbHigh);
+    if (QW(cbHigh,cb) != qwSize)
+	pff->hmap = NULL;               // Short file, generator stopped
+    else
+	pff->hmap = CreateFileMapping(pff->hfile,NULL,PAGE_READONLY,0,0,NULL);
+    if (pff->hmap == NULL) {
+	FeedEnd(pbd);
+	return FALSE;
+    }
+    return TRUE;
+}
+
+
+/***    FeedEnd - Close Feedback File for a BOARD
+ *
+ *      Entry
+ *          pbd - board, pbd->pff open or NULL
+ *
+ *      Exit
+ *          Views unmapped, file closed, pbd->pff NULL.
+ */
+VOID FeedEnd(PBOARD pbd)
+{
+    int     i;
+    PFEEDFILE pff = pbd->pff;
+
+    if (pff == NULL)
+	return;
+    for (i=0; i<cViewFeed; i++)
+	if (pff->afv[i].iTile != iTileNone)
+	    UnmapViewOfFile(pff->afv[i].pres);
+    if (pff->hmap != NULL)
+	CloseHandle(pff->hmap);
+    if ((pff->hfile != NULL) && (pff->hfile != INVALID_HANDLE_VALUE))
+	CloseHandle(pff->hfile);
+    free(pff);
+    pbd->pff = NULL;
+}
+
+
+/***    FeedName - Make name of Feedback File for a BOARD
+ *
+ *      Entry
+ *          pbd - board
+ *          psz - receives name, cbMaxPath bytes
+ *
+ *      Exit
+ *          psz filled in, as in "mm8x5.mmf", in the current directory.
+ */
+VOID FeedName(PBOARD pbd, char *psz)
+{
+    sprintf(psz,"mm%dx%d%s.mmf",pbd->cColor,pbd->cPeg,pbd->fDup ? "" : "u");
+}
+
+
+/***    FeedRow - Find RESULTs of a guess in the Feedback File
+ *
+ *      Entry
+ *          pbd    - board, pbd->pff open
+ *          iGuess - guess
+ *          iCode  - first code wanted
+ *
+ *      Exit
+ *          Returns RESULTs of iGuess against iCode and the codes after it,
+ *          up to the end of its tile (next multiple of cCodeTile).
+ *          Returns NULL if the tile could not be mapped.
+ *
+ *      The least recently used view is dropped to make room.
+ */
+RESULT *FeedRow(PBOARD pbd, DWORD iGuess, DWORD iCode)
+{
+    int     i;
+    DWORD   iTile;
+    ULONGLONG ib;               // Offset of tile in file
+    PFEEDFILE pff = pbd->pff;
+    PFEEDVIEW pfv;
+    PFEEDVIEW pfvOld;
+
+    iTile = (iGuess/cGuessTile)*pff->cBlock + iCode/cCodeTile;
+    pff->stamp++;
+    pfvOld = &pff->afv[0];
+    for (i=0; i<cViewFeed; i++) {
+	pfv = &pff->afv[i];
+	if (pfv->iTile == iTile)
+	    goto Found;
+	if (pfv->stamp < pfvOld->stamp)
+	    pfvOld = pfv;
+    }
+
+    // Not mapped; reuse the least recently used view
+    pfv = pfvOld;
+    if (pfv->iTile != iTileNone)
+	UnmapViewOfFile(pfv->pres);
+    ib = cbFeedHeader + (ULONGLONG)iTile*cbTile;
+    pfv->pres = MapViewOfFile(pff->hmap,FILE_MAP_READ,(DWORD)(ib >> 32),
+			      (DWORD)(ib & 0xFFFFFFFF),cbTile);
+    if (pfv->pres == NULL) {
+	pfv->iTile = iTileNone;
+	return NULL;
+    }
+    pfv->iTile = iTile;
+
+Found:
+    pfv->stamp = pff->stamp;
+    return pfv->pres + (iGuess % cGuessTile)*cCodeTile + iCode % cCodeTile;
+}
+
+
+/***    FilterCodes - Keep only codes consistent with a guess
+ *
+ *      Entry
+ *          pbd      - board
+ *          aiCode   - indexes of candidate codes
+ *          c        - count of candidates
+ *          ppkGuess - guess
+ *          res      - RESULT of guess
+ *
+ *      Exit
+ *          Returns count of candidates left.  They are moved, in order,
+ *          to the front of aiCode.
+ */
+DWORD FilterCodes(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+		  RESULT res)
+{
+    DWORD   i;
+    DWORD   iKeep = 0;
+
+    for (i=0; i<c; i++)
+	if (ScorePacked(pbd,ppkGuess,&pbd->apacked[aiCode[i]]) == res)
+	    aiCode[iKeep++] = aiCode[i];
+    return iKeep;
+}
+
+
+/***    FilterCodesFeed - FilterCodes using the Feedback File
+ *
+ *      Entry
+ *          pbd    - board, pbd->pff open
+ *          aiCode - indexes of codes to filter
+ *          c      - count of codes in aiCode
+ *          iGuess - index of guess
+ *          res    - RESULT the guess got
+ *
+ *      Exit
+ *          Returns count of codes kept, moved to front of aiCode in
+ *          order.
+ *
+ *      Looks up a new row only when a code is outside the last one, so
+ *      codes in order cost one FeedRow per tile.  Falls back on
+ *      ScorePacked for a tile that cannot be mapped.
+ */
+DWORD FilterCodesFeed(PBOARD pbd, DWORD *aiCode, DWORD c, DWORD iGuess,
+		      RESULT res)
+{
+    DWORD   i;
+    DWORD   iCode;
+    DWORD   iCodeRow = 0;       // First code in pres
+    DWORD   iKeep = 0;
+    PCPACKED ppkGuess = &pbd->apacked[iGuess];
+    RESULT *pres = NULL;        // Row segment for this guess
+
+    for (i=0; i<c; i++) {
+	iCode = aiCode[i];
+	if ((pres == NULL) || (iCode < iCodeRow) ||
+	    (iCode >= iCodeRow + cCodeTile)) {
+	    iCodeRow = iCode - iCode % cCodeTile;
+	    pres = FeedRow(pbd,iGuess,iCodeRow);
+	}
+	if (pres != NULL ? (pres[iCode - iCodeRow] == res) :
+	    (ScorePacked(pbd,ppkGuess,&pbd->apacked[iCode]) == res))
+	    aiCode[iKeep++] = iCode;
+    }
+    return iKeep;
+}
+
+
+/***    FilterCodesSliced - FilterCodes using bit-sliced codes
+ *
+ *      Entry
+ *          pbd      - board, sliced by BoardSlice
+ *          aiCode   - indexes of candidate codes
+ *          c        - count of candidates
+ *          ppkGuess - guess
+ *          res      - RESULT of guess
+ *
+ *      Exit
+ *          Same as FilterCodes.
+ *
+ *      Scores a whole slice when at least cRunSlice codes in a row are
+ *      in it, so codes in order cost one ScoreSliced per slice while
+ *      there are many; ScorePacked scores the rest.  See "Performance
+ *      Notes (19)" above.
+ */
+DWORD FilterCodesSliced(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+			RESULT res)
+{
+    ULONGLONG aqwRes[maxResult]; // Lanes getting each RESULT
+    BOOL    fSlice = FALSE;     // TRUE => qwKeep is for iSlice
+    DWORD   i;
+    DWORD   iCode;
+    DWORD   iKeep = 0;
+    DWORD   iRun;
+    DWORD   iSlice = 0;
+    ULONGLONG qwKeep = 0;       // Lanes of iSlice that get res
+
+    for (i=0; i<c; i++) {
+	iCode = aiCode[i];
+	if (!fSlice || (iCode/cLaneSlice != iSlice)) {
+	    iSlice = iCode/cLaneSlice;
+	    for (iRun=i; (iRun < c) && (iRun-i < cRunSlice) &&
+			 (aiCode[iRun]/cLaneSlice == iSlice); iRun++)
+		;
+	    fSlice = (iRun-i == cRunSlice);
+	    if (fSlice) {
+		ScoreSliced(pbd,ppkGuess,
+			    &pbd->aqwSlice[iSlice*cqwSlice(pbd)],
+			    ~(ULONGLONG)0,aqwRes);
+		qwKeep = aqwRes[res];
+	    }
+	}
+	if (fSlice ? ((qwKeep >> (iCode % cLaneSlice)) & 1) :
+	    (ScorePacked(pbd,ppkGuess,&pbd->apacked[iCode]) == res))
+	    aiCode[iKeep++] = iCode;
+    }
+    return iKeep;
+}
+
+
+/***    FilterCodesTable - FilterCodes using the Feedback Table
+ *
+ *      Entry
+ *          pbd    - board, with Feedback Table
+ *          aiCode - indexes of candidate codes
+ *          c      - count of candidates
+ *          iGuess - index of guess
+ *          res    - RESULT of guess
+ *
+ *      Exit
+ *          Same as FilterCodes.
+ */
+DWORD FilterCodesTable(PBOARD pbd, DWORD *aiCode, DWORD c, DWORD iGuess,
+		       RESULT res)
+{
+    DWORD   i;
+    DWORD   iKeep = 0;
+    const RESULT *pres = &ScoreTable(pbd,iGuess,0); // Row for this guess
+
+    for (i=0; i<c; i++)
+	if (pres[aiCode[i]] == res)
+	    aiCode[iKeep++] = aiCode[i];
+    return iKeep;
+}
+
+
+/***    FitCodes - Find codes that fit the moves so far
+ *
+ *      Entry
+ *          aiCode - room for g.bd.cCode DWORDs; may be g.spec.aiCode
+ *          piBest - receives best next guess, iCodeNone if not known
+ *
+ *      Exit
+ *          Returns count of codes in aiCode that fit every move before
+ *          g.iMove.  When g.spec speculated on the last move, they and
+ *          the best next guess come straight from it.
+ */
+DWORD FitCodes(DWORD *aiCode, DWORD *piBest)
+{
+    DWORD   c;
+    CODE    code;
+    int     i;
+    DWORD   iGuess;
+    int     iy;
+    PACKED  pk;
+    PSPEC   pspec = &g.spec;
+    RESULT  res;
+
+    iy = g.iMove-1;
+    if ((iy >= 0) && (pspec->iMove == iy) && pspec->fGrouped) {
+	for (i=0; (i<nPeg) && (pspec->asmove[iy].apeg[i] ==
+			       (BYTE)g.amove[iy].guess[i]); i++)
+	    ;
+	if (i == nPeg) {                // Speculated on this very guess
+	    res = g.bd.mpPosClrToResult[g.amove[iy].cPosition]
+				       [g.amove[iy].cColor];
+	    c = pspec->ac[res];
+	    memmove(aiCode,&pspec->aiCode[pspec->aiFirst[res]],
+		    c*sizeof(DWORD));
+	    *piBest = pspec->aiBest[res];
+	    return c;
+	}
+    }
+
+    *piBest = iCodeNone;
+    if (g.fAdvGame) {                   // Adversary keeps them
+	memcpy(aiCode,g.aiAdv,g.cAdv*sizeof(DWORD));
+	return g.cAdv;
+    }
+
+    for (c=0; c<g.bd.cCode; c++)
+	aiCode[c] = c;
+    for (iy=0; iy<g.iMove; iy++) {
+	for (i=0; i<nPeg; i++)
+	    code.apeg[i] = (BYTE)g.amove[iy].guess[i];
+	res = g.bd.mpPosClrToResult[g.amove[iy].cPosition][g.amove[iy].cColor];
+	iGuess = RankCode(&g.bd,&code);
+	if ((iGuess != iCodeNone) && (g.bd.presTable != NULL))
+	    c = FilterCodesTable(&g.bd,aiCode,c,iGuess,res);
+	else {
+	    PackCode(&g.bd,&code,&pk);
+	    c = FilterCodes(&g.bd,aiCode,c,&pk,res);
+	}
+    }
+    return c;
+}
+
+
+/***    GameMoves - Copy the moves of our game for the Solver Engine
+ *
+ *      Entry
+ *          asmove - room for maxMove SMOVEs
+ *
+ *      Exit
+ *          Returns g.iMove; asmove has every move before it, then the
+ *          play row with no feedback.
+ */
+int GameMoves(PSMOVE asmove)
+{
+    int     i;
+    int     iy;
+
+    memset(asmove,0,maxMove*sizeof(SMOVE));
+    for (iy=0; iy<=g.iMove; iy++) {
+	for (i=0; i<nPeg; i++)
+	    asmove[iy].apeg[i] = (BYTE)g.amove[iy].guess[i];
+	if (iy < g.iMove) {
+	    asmove[iy].cPosition = (BYTE)g.amove[iy].cPosition;
+	    asmove[iy].cColor = (BYTE)g.amove[iy].cColor;
+	}
+    }
+    return g.iMove;
+}
+
+
+/***    GenBook - Write Opening Book for a board and strategy
+ *
+ *      Entry
+ *          g.tny has board, and strategy in g.tny.astrat[0].
+ *          g.cPlyBook - guesses to put in book
+ *
+ *      Exit
+ *          Returns TRUE; book written, named by BookName.
+ *          Returns FALSE if book could not be made; user has been told.
+ *
+ *      Nodes are made breadth first, so the cResult children of a node
+ *      are together.  The strategy is asked for each node's guess as a
+ *      game of its own: the first guess, then the guess after every
+ *      move leading to the node.  See "Performance Notes (17)" above.
+ */
+BOOL GenBook(VOID)
+{
+    char    ach[cbMaxString+cbMaxPath];
+    char    achFile[cbMaxPath];
+    DWORD  *aiParent = NULL;    // Parent of each node
+    PBOOKNODE abn = NULL;       // Nodes
+    SMOVE   asmove[maxPlyBook]; // Moves leading to node
+    BOOKHDR bh;
+    BOARD   bd;
+    DWORD   c;
+    DWORD   cb;
+    CODE    code;               // Guess from strategy
+    int     cMove;
+    DWORD   cNode;
+    DWORD   cNodeMax;
+    BOOL    fOK = FALSE;
+    HANDLE  hfile = INVALID_HANDLE_VALUE;
+    DWORD   i;
+    DWORD   iGuess;
+    int     iMove;
+    DWORD   iNode;
+    DWORD   iParent;
+    PSTRATEGY pstrat = &g.tny.astrat[0];
+    void   *pv;                 // Strategy state
+    int     res;
+
+    if (!BoardBegin(&bd,g.tny.cPeg,g.tny.cColor,g.tny.fDup,TRUE))
+	bd.acode = NULL;
+    else if (bd.acode == NULL)
+	BoardEnd(&bd);
+    if (bd.acode == NULL) {
+	MessageBox(NULL,"Board is too big to list every code.","MasterMind",
+		   MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+    memset(&bh,0,sizeof(bh));
+    BookName(&bd,pstrat->pszName,achFile,bh.achStrat);
+    if (!StrategyLoad(pstrat)) {
+	BoardEnd(&bd);
+	return FALSE;
+    }
+    pv = (*pstrat->pfnBegin)(bd.cPeg,bd.cColor,bd.fDup);
+    if (pv == NULL) {
+	sprintf(ach,"Strategy %s cannot play this board.",pstrat->pszName);
+	MessageBox(NULL,ach,"MasterMind",MB_ICONEXCLAMATION | MB_OK);
+	if (pstrat->hmod != NULL)
+	    FreeLibrary(pstrat->hmod);
+	BoardEnd(&bd);
+	return FALSE;
+    }
+
+    // Room for every node the book could have
+    cNodeMax = 0;
+    for (iMove=0, c=1; iMove<g.cPlyBook; iMove++, c*=bd.cResult)
+	cNodeMax += c;
+    abn = malloc(cNodeMax*sizeof(BOOKNODE));
+    aiParent = malloc(cNodeMax*sizeof(DWORD));
+    if ((abn == NULL) || (aiParent == NULL))
+	goto Done;
+
+    cNode = 1;                          // Root, before any move
+    for (iNode=0; iNode<cNode; iNode++) {
+	abn[iNode].iGuess = iCodeNone;
+	abn[iNode].iChild = 0;
+
+	// Moves leading here, found by walking up to the root
+	cMove = 0;
+	for (i=iNode; i != 0; i=aiParent[i])
+	    cMove++;
+	for (i=iNode, iMove=cMove; i != 0; i=iParent) {
+	    iParent = aiParent[i];
+	    res = i - abn[iParent].iChild;
+	    iMove--;
+	    memcpy(asmove[iMove].apeg,bd.acode[abn[iParent].iGuess].apeg,
+		   bd.cPeg);
+	    asmove[iMove].cPosition = bd.mpResultToPos[res];
+	    asmove[iMove].cColor = bd.mpResultToClr[res];
+	}
+	if ((cMove > 0) &&
+	    (bd.mpPosClrToResult[asmove[cMove-1].cPosition]
+				[asmove[cMove-1].cColor] == bd.resWin))
+	    continue;                   // Game already won
+
+	// Ask strategy, as a new game, what it guesses here
+	if ((cMove > 0) && !(*pstrat->pfnGuess)(pv,asmove,0,code.apeg))
+	    continue;
+	if (!(*pstrat->pfnGuess)(pv,asmove,cMove,code.apeg))
+	    continue;                   // No code fits these moves
+	iGuess = RankCode(&bd,&code);
+	if (iGuess == iCodeNone)        // Not a code on this board
+	    continue;
+	abn[iNode].iGuess = iGuess;
+
+	if (cMove+1 < g.cPlyBook) {     // One child for each RESULT
+	    abn[iNode].iChild = cNode;
+	    for (res=0; res<bd.cResult; res++)
+		aiParent[cNode++] = iNode;
+	}
+    }
+
+    hfile = CreateFile(achFile,GENERIC_WRITE,0,NULL,CREATE_ALWAYS,
+		       FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+    if (hfile == INVALID_HANDLE_VALUE)
+	goto Done;
+    bh.sig = sigBook;
+    bh.cCode = bd.cCode;
+    bh.cResult = bd.cResult;
+    bh.cNode = cNode;
+    bh.cPeg = (BYTE)bd.cPeg;
+    bh.cColor = (BYTE)bd.cColor;
+    bh.fDup = (BYTE)bd.fDup;
+    bh.cPly = (BYTE)g.cPlyBook;
+    fOK = WriteFile(hfile,&bh,sizeof(bh),&cb,NULL) && (cb == sizeof(bh)) &&
+	  WriteFile(hfile,abn,cNode*sizeof(BOOKNODE),&cb,NULL) &&
+	  (cb == cNode*sizeof(BOOKNODE));
+
+Done:
+    if (hfile != INVALID_HANDLE_VALUE)
+	CloseHandle(hfile);
+    (*pstrat->pfnEnd)(pv);
+    if (pstrat->hmod != NULL)
+	FreeLibrary(pstrat->hmod);
+    free(abn);
+    free(aiParent);
+    BoardEnd(&bd);
+    if (fOK)
+	sprintf(ach,"Opening Book written to %s.",achFile);
+    else
+	sprintf(ach,"Could not write Opening Book %s.",achFile);
+    MessageBox(NULL,ach,"MasterMind",
+	       fOK ? MB_ICONINFORMATION | MB_OK : MB_ICONEXCLAMATION | MB_OK);
+    return fOK;
+}
+
+
+/***    GenFeedback - Write Feedback File for a board
+ *
+ *      Entry
+ *          pbsz - board
+ *
+ *      Exit
+ *          Returns TRUE; file written, named by FeedName.
+ *          Returns FALSE if board is the wrong size or file could not be
+ *          written; user has been told.
+ *
+ *      The header goes in last, so a file cut short is never taken for
+ *      a whole one.  See "Performance Notes (13)" above.
+ */
+BOOL GenFeedback(PBOARDSIZE pbsz)
+{
+    char    ach[cbMaxString+cbMaxPath];
+    char    achFile[cbMaxPath];
+    BOARD   bd;
+    DWORD   cb;
+    DWORD   cBand;
+    DWORD   cBlock;
+    BOOL    fBoard;             // TRUE => BoardBegin worked
+    BOOL    fOK = FALSE;
+    FEEDHDR fh;
+    HANDLE  hfile = INVALID_HANDLE_VALUE;
+    DWORD   iBand;
+    DWORD   iBlock;
+    DWORD   iCode;
+    DWORD   iGuess;
+    RESULT *pres;
+    RESULT *presTile = NULL;
+
+    fBoard = BoardBegin(&bd,pbsz->cPeg,pbsz->cColor,pbsz->fDup,TRUE);
+    if (!fBoard || (bd.acode == NULL) || (bd.cCode <= maxCodeTable)) {
+	if (fBoard)
+	    BoardEnd(&bd);
+	sprintf(ach,"A Feedback File is for boards of %d to %ld codes.",
+		maxCodeTable+1,maxCodeList);
+	MessageBox(NULL,ach,"MasterMind",MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+
+    FeedName(&bd,achFile);
+    presTile = malloc(cbTile);
+    if (presTile != NULL)
+	hfile = CreateFile(achFile,GENERIC_WRITE,0,NULL,CREATE_ALWAYS,
+			   FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+    if (hfile == INVALID_HANDLE_VALUE)
+	goto Done;
+
+    // Header block, zeroed until the tiles are all written
+    memset(presTile,0,cbFeedHeader);
+    if (!WriteFile(hfile,presTile,cbFeedHeader,&cb,NULL))
+	goto Done;
+
+    // Tiles, band by band, each tile row-major
+    cBand = (bd.cCode + cGuessTile-1)/cGuessTile;
+    cBlock = (bd.cCode + cCodeTile-1)/cCodeTile;
+    for (iBand=0; iBand<cBand; iBand++)
+	for (iBlock=0; iBlock<cBlock; iBlock++) {
+	    memset(presTile,RESULT_NONE,cbTile); // Past last code or guess
+	    pres = presTile;
+	    for (iGuess=iBand*cGuessTile;
+		 iGuess<min((iBand+1)*cGuessTile,bd.cCode);
+		 iGuess++, pres += cCodeTile)
+		for (iCode=iBlock*cCodeTile;
+		     iCode<min((iBlock+1)*cCodeTile,bd.cCode); iCode++)
+		    pres[iCode % cCodeTile] = ScorePacked(&bd,
+						&bd.apacked[iGuess],
+						&bd.apacked[iCode]);
+	    if (!WriteFile(hfile,presTile,cbTile,&cb,NULL) || (cb != cbTile))
+		goto Done;
+	}
+
+    memset(&fh,0,sizeof(fh));
+    fh.sig = sigFeed;
+    fh.cCode = bd.cCode;
+    fh.cPeg = bd.cPeg;
+    fh.cColor = bd.cColor;
+    fh.fDup = bd.fDup;
+    fh.cTileGuess = cGuessTile;
+    fh.cTileCode = cCodeTile;
+    SetFilePointer(hfile,0,NULL,FILE_BEGIN);
+    fOK = WriteFile(hfile,&fh,sizeof(fh),&cb,NULL) && (cb == sizeof(fh));
+
+Done:
+    if (hfile != INVALID_HANDLE_VALUE)
+	CloseHandle(hfile);
+    free(presTile);
+    BoardEnd(&bd);
+    if (fOK)
+	sprintf(ach,"Feedback File written to %s.",achFile);
+    else
+	sprintf(ach,"Could not write Feedback File %s.",achFile);
+    MessageBox(NULL,ach,"MasterMind",
+	       fOK ? MB_ICONINFORMATION | MB_OK : MB_ICONEXCLAMATION | MB_OK);
+    return fOK;
+}
+
+
+/***    GenTables - Write built-in tables to MMTABLES.H
+ *
+ *      Entry
+ *          pszFile - file to write, NULL => mmtables.h
+ *
+ *      Exit
+ *          Returns TRUE; tables written for every board in abszBuiltIn.
+ *          Returns FALSE if file or tables could not be made; user has
+ *          been told.
+ *
+ *      See "Performance Notes (12)" above.
+ */
+BOOL GenTables(char *pszFile)
+{
+    char    ach[cbMaxString+cbMaxPath];
+    char    achName[32];        // Board name, as in "6x4u"
+    BOARD   bd;
+    BOOL    fOK = FALSE;
+    int     i;
+    DWORD   iCode;
+    DWORD   iRes;
+    int     iClr;
+    int     iPos;
+    int     iSize;
+    PCPACKED ppk;
+    FILE   *pfile;
+    PBOARDSIZE pbsz;
+
+    if (pszFile == NULL)
+	pszFile = "mmtables.h";
+    pfile = fopen(pszFile,"w");
+    if (pfile == NULL) {
+	MessageBox(NULL,"Could not create tables file.",
+		   "MasterMind",MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+
+    fprintf(pfile,
+	"/***\tMMTABLES.H - Built-in tables for MM.C\n"
+	" *\n"
+	" *\tWritten by mastmind /gentables -- do not edit.  Run it again\n"
+	" *\tafter changing abszBuiltIn, or how BoardBegin lists codes or\n"
+	" *\tnumbers RESULTs.  See \"Performance Notes (12)\" in MM.C.\n"
+	" */\n\n\n");
+
+    // Image index of each Result Pin Pattern, numbered like our RESULTs
+    if (!BoardBegin(&bd,nPeg,nColor,FALSE,FALSE))
+	goto Done;
+    fprintf(pfile,"const int mpResultToLibrary[nPeg+1][nPeg+1] = {\n");
+    for (iPos=0; iPos<=nPeg; iPos++) {
+	fprintf(pfile,"    {");
+	for (iClr=0; iClr<=nPeg; iClr++)
+	    fprintf(pfile,"%3d%s",
+		    (bd.mpPosClrToResult[iPos][iClr] == RESULT_NONE) ? -1 :
+			nColor + 1 + bd.mpPosClrToResult[iPos][iClr],
+		    (iClr < nPeg) ? "," : "");
+	fprintf(pfile,"},\n");
+    }
+    fprintf(pfile,"};\n");
+    BoardEnd(&bd);
+
+    for (iSize=0; iSize<nBoardBuiltIn; iSize++) {
+	pbsz = &abszBuiltIn[iSize];
+	if (!BoardBegin(&bd,pbsz->cPeg,pbsz->cColor,pbsz->fDup,TRUE))
+	    goto Done;
+	if ((bd.acode == NULL) || !BoardTable(&bd)) {
+	    BoardEnd(&bd);
+	    goto Done;
+	}
+	sprintf(achName,"%dx%d%s",bd.cColor,bd.cPeg,bd.fDup ? "" : "u");
+
+	fprintf(pfile,"\nconst CODE acode%s[%lu] = {\n",achName,bd.cCode);
+	for (iCode=0; iCode<bd.cCode; iCode++) {
+	    fprintf(pfile,"    {{");
+	    for (i=0; i<bd.cPeg; i++)
+		fprintf(pfile,"%s%d",i ? "," : "",bd.acode[iCode].apeg[i]);
+	    fprintf(pfile,"}},\n");
+	}
+	fprintf(pfile,"};\n");
+
+	fprintf(pfile,"\nconst PACKED apacked%s[%lu] = {\n",achName,bd.cCode);
+	for (iCode=0; iCode<bd.cCode; iCode++) {
+	    ppk = &bd.apacked[iCode];
+	    fprintf(pfile,"    {QW(0x%08lX,0x%08lX),{QW(0x%08lX,0x%08lX),"
+			  "QW(0x%08lX,0x%08lX)}},\n",
+		    (DWORD)(ppk->qwPos >> 32),
+		    (DWORD)(ppk->qwPos & 0xFFFFFFFF),
+		    (DWORD)(ppk->aqwClr[0] >> 32),
+		    (DWORD)(ppk->aqwClr[0] & 0xFFFFFFFF),
+		    (DWORD)(ppk->aqwClr[1] >> 32),
+		    (DWORD)(ppk->aqwClr[1] & 0xFFFFFFFF));
+	}
+	fprintf(pfile,"};\n");
+
+	fprintf(pfile,"\nconst RESULT aresTable%s[%lu*%lu] = {",achName,
+		bd.cCode,bd.cCode);
+	for (iRes=0; iRes<bd.cCode*bd.cCode; iRes++)
+	    fprintf(pfile,"%s%d,",(iRes % 24) ? "" : "\n    ",
+		    bd.presTable[iRes]);
+	fprintf(pfile,"\n};\n");
+	BoardEnd(&bd);
+    }
+
+    fprintf(pfile,"\nconst BUILTIN abiBuiltIn[] = {\n");
+    for (iSize=0; iSize<nBoardBuiltIn; iSize++) {
+	pbsz = &abszBuiltIn[iSize];
+	BoardBegin(&bd,pbsz->cPeg,pbsz->cColor,pbsz->fDup,FALSE);
+	sprintf(achName,"%dx%d%s",bd.cColor,bd.cPeg,bd.fDup ? "" : "u");
+	fprintf(pfile,"    {%d,%d,%s,%lu,acode%s,apacked%s,aresTable%s},\n",
+		bd.cPeg,bd.cColor,bd.fDup ? "TRUE" : "FALSE",bd.cCode,
+		achName,achName,achName);
+    }
+    fprintf(pfile,"};\n"
+		  "#define nBuiltIn (sizeof(abiBuiltIn)/sizeof(BUILTIN))\n");
+    fOK = TRUE;
+
+Done:
+    if (fclose(pfile) != 0)
+	fOK = FALSE;
+    if (!fOK) {
+	sprintf(ach,"Could not write tables to %s.",pszFile);
+	MessageBox(NULL,ach,"MasterMind",MB_ICONEXCLAMATION | MB_OK);
+    }
+    return fOK;
+}
+
+
+/***    GeneBreed - Breed the next generation of an island
+ *
+ *      Entry
+ *          pgs - state
+ *          pgi - island, with afit filled in for its codes
+ *
+ *      Exit
+ *          pgi->acode is the next generation: the cGeneElite best codes
+ *          as they were, and children of codes picked two at a time,
+ *          the fitter of each pair (lower afit) as parent.
+ *          See "Performance Notes (24)" above.
+ */
+VOID GeneBreed(PGENESTATE pgs, PGENEISLAND pgi)
+{
+    CODE    acodeNew[cGenePop];
+    BYTE    afElite[cGenePop];  // TRUE => code kept as it is
+    int     cPeg = pgs->bd.cPeg;
+    int     i;
+    int     iBest;
+    int     iCode;
+    int     iFirst;
+    int     iLast;
+    int     iParent[2];
+    int     j;
+    BYTE    peg;
+    PCODE   pcode;
+
+    memset(afElite,0,sizeof(afElite));
+    for (i=0; i<cGeneElite; i++) {
+	iBest = -1;
+	for (iCode=0; iCode<cGenePop; iCode++)
+	    if (!afElite[iCode] &&
+		((iBest < 0) || (pgi->afit[iCode] < pgi->afit[iBest])))
+		iBest = iCode;
+	afElite[iBest] = TRUE;
+	acodeNew[i] = pgi->acode[iBest];
+    }
+
+    for (i=cGeneElite; i<cGenePop; i++) {
+	for (j=0; j<2; j++) {           // Fitter of two, for each parent
+	    iParent[j] = GeneRandom(&pgi->seed,cGenePop);
+	    iCode = GeneRandom(&pgi->seed,cGenePop);
+	    if (pgi->afit[iCode] < pgi->afit[iParent[j]])
+		iParent[j] = iCode;
+	}
+
+	// Two-point crossover: pegs iFirst..iLast from the second parent
+	pcode = &acodeNew[i];
+	*pcode = pgi->acode[iParent[0]];
+	iFirst = GeneRandom(&pgi->seed,cPeg);
+	iLast = GeneRandom(&pgi->seed,cPeg);
+	if (iFirst > iLast) {
+	    j = iFirst;
+	    iFirst = iLast;
+	    iLast = j;
+	}
+	memcpy(&pcode->apeg[iFirst],&pgi->acode[iParent[1]].apeg[iFirst],
+	       iLast-iFirst+1);
+
+	// Then one of: recolor a peg, swap two, or reverse a run of them
+	switch (GeneRandom(&pgi->seed,8)) {
+	case 0: case 1: case 2: case 3:
+	    pcode->apeg[GeneRandom(&pgi->seed,cPeg)] =
+		(BYTE)GeneRandom(&pgi->seed,pgs->bd.cColor);
+	    break;
+	case 4: case 5:
+	    iFirst = GeneRandom(&pgi->seed,cPeg);
+	    iLast = GeneRandom(&pgi->seed,cPeg);
+	    peg = pcode->apeg[iFirst];
+	    pcode->apeg[iFirst] = pcode->apeg[iLast];
+	    pcode->apeg[iLast] = peg;
+	    break;
+	case 6:
+	    iFirst = GeneRandom(&pgi->seed,cPeg);
+	    iLast = GeneRandom(&pgi->seed,cPeg);
+	    for (; iFirst < iLast; iFirst++, iLast--) {
+		peg = pcode->apeg[iFirst];
+		pcode->apeg[iFirst] = pcode->apeg[iLast];
+		pcode->apeg[iLast] = peg;
+	    }
+	    break;
+	}
+	GeneRepair(&pgs->bd,pcode,&pgi->seed);
+    }
+    memcpy(pgi->acode,acodeNew,sizeof(acodeNew));
+}
+
+
+/***    GeneEvolve - Evolve one island until a code fits
+ *
+ *      Entry
+ *          pgs - state
+ *          pgi - island
+ *
+ *      Exit
+ *          Stops when any island has found a code that fits every move,
+ *          or after cGeneMax generations.  The best code found by any
+ *          island is in codeBest.
+ *
+ *      Every cGeneMigrate generations it sends a copy of its best code
+ *      to the next island, and takes in the one the island before sent,
+ *      in place of its worst.  See "Performance Notes (24)" above.
+ */
+VOID GeneEvolve(PGENESTATE pgs, PGENEISLAND pgi)
+{
+    int     iBest;
+    int     iCode;
+    int     iGen;
+    int     iWorst;
+    PGENEISLAND pgiNext;
+
+    pgiNext = &pgs->agi[(pgi - pgs->agi + 1) % pgs->cIsland];
+    for (iGen=0; (iGen < cGeneMax) && !pgs->fFound; iGen++) {
+	if (iGen > 0)                   // Codes from last guess go first
+	    GeneBreed(pgs,pgi);
+	GeneFitness(pgs,pgi);
+	pgi->cGen++;
+
+	iBest = 0;
+	iWorst = 0;
+	for (iCode=1; iCode<cGenePop; iCode++) {
+	    if (pgi->afit[iCode] < pgi->afit[iBest])
+		iBest = iCode;
+	    if (pgi->afit[iCode] > pgi->afit[iWorst])
+		iWorst = iCode;
+	}
+
+	EnterCriticalSection(&pgs->cs);
+	if (!pgs->fFound && (pgi->afit[iBest] < pgs->fitBest)) {
+	    pgs->fitBest = pgi->afit[iBest];
+	    pgs->codeBest = pgi->acode[iBest];
+	    pgs->fFound = (pgs->fitBest == 0);
+	}
+	if (iGen % cGeneMigrate == cGeneMigrate-1) {
+	    pgiNext->codeMigrant = pgi->acode[iBest];
+	    pgiNext->fitMigrant = pgi->afit[iBest];
+	    pgiNext->fMigrant = TRUE;
+	    if (pgi->fMigrant) {
+		pgi->acode[iWorst] = pgi->codeMigrant;
+		pgi->afit[iWorst] = pgi->fitMigrant;
+		pgi->fMigrant = FALSE;
+	    }
+	}
+	LeaveCriticalSection(&pgs->cs);
+    }
+}
+
+
+/***    GeneFitness - Score an island's codes against every move
+ *
+ *      Entry
+ *          pgs - state
+ *          pgi - island
+ *
+ *      Exit
+ *          pgi->afit[i] is how far pgi->acode[i] is from fitting every
+ *          move: the sum over moves of how far off its cPosition and
+ *          cColor would be.  0 => it fits.
+ *
+ *      The codes are sliced cLaneSlice at a time and each move is
+ *      scored against a whole slice with ScoreSliced.
+ *      See "Performance Notes (24)" above.
+ */
+VOID GeneFitness(PGENESTATE pgs, PGENEISLAND pgi)
+{
+    ULONGLONG aqw[maxPegBoard*maxColorBoard]; // One slice of codes
+    ULONGLONG aqwRes[maxResult];        // Lanes getting each RESULT
+    BYTE   *acDist;
+    int     cqw = cqwSlice(&pgs->bd);
+    int     i;
+    int     iCode;
+    int     iMove;
+    int     iPeg;
+    int     res;
+    ULONGLONG qw;
+    ULONGLONG qwBit;
+
+    memset(pgi->afit,0,sizeof(pgi->afit));
+    for (iCode=0; iCode<cGenePop; iCode+=cLaneSlice) {
+	memset(aqw,0,cqw*sizeof(ULONGLONG));
+	for (i=0; i<cLaneSlice; i++)
+	    for (iPeg=0; iPeg<pgs->bd.cPeg; iPeg++)
+		aqw[iPeg*pgs->bd.cColor + pgi->acode[iCode+i].apeg[iPeg]] |=
+		    (ULONGLONG)1 << i;
+	for (iMove=0; iMove<pgs->cMove; iMove++) {
+	    ScoreSliced(&pgs->bd,&pgs->agm[iMove].pk,aqw,~(ULONGLONG)0,
+			aqwRes);
+	    acDist = pgs->agm[iMove].acDist;
+	    for (res=0; res<pgs->bd.cResult; res++)
+		if (acDist[res] != 0)
+		    for (qw=aqwRes[res]; qw != 0; qw ^= qwBit) {
+			qwBit = qw & (~qw+1);
+			pgi->afit[iCode + CountLanes(qwBit-1)] += acDist[res];
+		    }
+	}
+    }
+    pgi->cEval += cGenePop;
+}
+
+
+/***    GeneRandom - Next random number of an island
+ *
+ *      Entry
+ *          pseed - island's seed
+ *          n     - count of numbers to pick from
+ *
+ *      Exit
+ *          Returns 0..n-1; *pseed stepped.
+ *
+ *      Each island keeps its own seed, so threads need not share rand.
+ */
+int GeneRandom(DWORD *pseed, int n)
+{
+    *pseed = *pseed*214013L + 2531011L;
+    return (int)((*pseed >> 16) & 0x7FFF) % n;
+}
+
+
+/***    GeneRepair - Make a code legal on its board
+ *
+ *      Entry
+ *          pbd   - board
+ *          pcode - code; colors may repeat
+ *          pseed - island's seed
+ *
+ *      Exit
+ *          If the board has no repeated colors, each repeat is given a
+ *          random color not yet used.
+ */
+VOID GeneRepair(PBOARD pbd, PCODE pcode, DWORD *pseed)
+{
+    WORD    fUsed = 0;          // Colors used so far, bit each
+    int     iPeg;
+    int     peg;
+
+    if (pbd->fDup)
+	return;
+    for (iPeg=0; iPeg<pbd->cPeg; iPeg++) {
+	peg = pcode->apeg[iPeg];
+	while (fUsed & (1 << peg))
+	    peg = GeneRandom(pseed,pbd->cColor);
+	pcode->apeg[iPeg] = (BYTE)peg;
+	fUsed |= 1 << peg;
+    }
+}
+
+
+/***    GeneThread - Evolve an island for each guess, until told to quit
+ *
+ *      Entry
+ *          pv - GENEISLAND
+ *
+ *      Exit
+ *          Returns 0 once its GENESTATE's fQuit is set.
+ *
+ *      Waits for hevGo, evolves the island with GeneEvolve, and sets
+ *      hevDone.  StratGeneticBegin starts one per island but the first,
+ *      and StratGeneticEnd ends them, so a game starts no threads.
+ *      See "Performance Notes (24)" above.
+ */
+unsigned __stdcall GeneThread(void *pv)
+{
+    PGENEISLAND pgi = pv;
+
+    for (;;) {
+	WaitForSingleObject(pgi->hevGo,INFINITE);
+	if (pgi->pgs->fQuit)
+	    break;
+	GeneEvolve(pgi->pgs,pgi);
+	SetEvent(pgi->hevDone);
+    }
+    return 0;
+}
+
+
+/***    GetClientDC - Get DC for painting client area outside WM_PAINT
+ *
+ *      Entry
+ *          hwnd - main window
+ *
+ *      Exit
+ *          Returns screen DC, or off-screen DC during replay.
+ *          Caller must free it with ReleaseClientDC.
+ */
+HDC GetClientDC(HWND hwnd)
+{
+    if (g.hdcReplay)
+	return g.hdcReplay;
+    return GetDC(hwnd);
+}
+
+
+/***    GetTime - Get time in milliseconds for animation
+ *
+ *      Exit
+ *          Returns GetTickCount(), or the recorded time during replay.
+ */
+DWORD GetTime(VOID)
+{
+    if (g.fReplay)
+	return g.msReplay;
+    return GetTickCount();
+}
+
+
+/***    GroupCodes - Group codes by the RESULT a guess gets, in place
+ *
+ *      Entry
+ *          pbd      - board, codes listed
+ *          aiCode   - indexes of codes
+ *          c        - count of codes
+ *          ppkGuess - guess
+ *          ares     - room for c RESULTs
+ *          aiFirst  - room for pbd->cResult DWORDs
+ *          acPart   - room for pbd->cResult DWORDs
+ *
+ *      Exit
+ *          aiCode reordered so codes giving each RESULT res are together,
+ *          acPart[res] of them from aiCode[aiFirst[res]] on, and ares[i]
+ *          is still the RESULT of aiCode[i].
+ *
+ *      One scoring pass counts each group, then every code is swapped
+ *      straight to the next free place in its group, so no code moves
+ *      twice and no second array is needed.  See "Performance Notes
+ *      (20)" above.
+ */
+VOID GroupCodes(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+		RESULT *ares, DWORD *aiFirst, DWORD *acPart)
+{
+    DWORD   aiNext[maxResult];  // Next place to fill in each group
+    DWORD   i;
+    DWORD   iCode;
+    DWORD   iEnd;
+    DWORD   j;
+    int     res;
+    RESULT  resCode;
+
+    PartitionCodes(pbd,aiCode,c,ppkGuess,ares,acPart);
+    for (res=0, i=0; res<pbd->cResult; res++) {
+	aiFirst[res] = i;
+	aiNext[res] = i;
+	i += acPart[res];
+    }
+
+    for (res=0; res<pbd->cResult; res++) {
+	iEnd = aiFirst[res] + acPart[res];
+	while ((i = aiNext[res]) < iEnd) {
+	    resCode = ares[i];
+	    if (resCode == res) {       // Already in its group
+		aiNext[res]++;
+		continue;
+	    }
+	    j = aiNext[resCode]++;      // Swap it into its group
+	    iCode = aiCode[i];
+	    aiCode[i] = aiCode[j];
+	    aiCode[j] = iCode;
+	    ares[i] = ares[j];
+	    ares[j] = resCode;
+	}
+    }
+}
+
+
+/***    HintFree - Free a HINTJOB
+ *
+ *      Entry
+ *          phj - hint job, or NULL
+ */
+VOID HintFree(PHINTJOB phj)
+{
+    int     i;
+
+    if (phj == NULL)
+	return;
+    free(phj->aiCode);
+    for (i=0; i<maxMove; i++) {
+	free(phj->ahl[i].aiGuess);
+	free(phj->ahl[i].acPart);
+	free(phj->ahl[i].ares);
+    }
+    free(phj);
+}
+
+
+/***    HintShow - Put a hint in the play row
+ *
+ *      Entry
+ *          hwnd  - main window
+ *          gen   - g.genHint when hint was asked for
+ *          iCode - code to show
+ *
+ *      Exit
+ *          Play row holds code iCode, and Guess button is enabled.  Stale
+ *          hints are ignored, and so are hints once the player has moved
+ *          pegs in the row since the last one.
+ */
+VOID HintShow(HWND hwnd, LONG gen, DWORD iCode)
+{
+    int     i;
+    PMOVE   pmove = &g.amove[g.iMove];
+
+    if ((gen != g.genHint) || g.fGameOver ||
+	(iCode >= g.bd.cCode) || (iCode == g.iHint))
+	return;
+
+    if (g.iHint != iCodeNone)           // Player may have changed it
+	for (i=0; i<nPeg; i++)
+	    if (pmove->guess[i] != g.bd.acode[g.iHint].apeg[i])
+		return;
+
+    for (i=0; i<nPeg; i++) {
+	pmove->guess[i] = g.bd.acode[iCode].apeg[i];
+	PaintPeg(hwnd,i,g.iMove);
+    }
+    g.iHint = iCode;
+
+    // Turn on Guess button
+    EnableWindow(abutton[iButtonGuess].hwnd,TRUE);
+    g.fGuessAllowed = TRUE;
+    SpecStart();
+}
+
+
+/***    HintSolve - Find a guess sure to win within k guesses
+ *
+ *      Entry
+ *          phj     - hint job
+ *          iLevel  - level; work space is phj->ahl[iLevel]
+ *          aiCode  - codes left, a group of the level above; regrouped
+ *          c       - count of codes
+ *          k       - guesses left, counting the one that wins
+ *          piGuess - receives guess
+ *
+ *      Exit
+ *          Returns TRUE; *piGuess is sure to leave each code solvable in
+ *              the guesses after it.
+ *          Returns FALSE if there is no such guess, or phj->fAbort was
+ *              set because time ran out or the hint is no longer wanted.
+ *
+ *      Guesses are tried fewest codes in the biggest part first, and any
+ *      guess leaving a part bigger than k-1 guesses could be sure of is
+ *      skipped.  Each guess groups aiCode by RESULT in place, so each
+ *      part is handed to the next level as it lies.  See "Performance
+ *      Notes (15)" and (20) above.
+ */
+BOOL HintSolve(PHINTJOB phj, int iLevel, DWORD *aiCode, DWORD c, int k,
+	       DWORD *piGuess)
+{
+    DWORD   acPart[maxResult];  // Count of codes giving each RESULT
+    DWORD   aiFirst[maxResult]; // Where codes giving each RESULT start
+    DWORD   cKeep;
+    DWORD   cMax;               // Biggest part for a guess
+    BOOL    fIn;                // TRUE => guess is one of the codes
+    DWORD   i;
+    DWORD   iGuess;
+    DWORD   iGuessNext;
+    DWORD   j;
+    PBOARD  pbd = &g.bd;
+    DWORD  *pc;
+    PHINTLEVEL phl = &phj->ahl[iLevel];
+    int     res;
+
+    if (c > phj->acSolve[k])            // Too many codes for k guesses
+	return FALSE;
+    if (c <= 2) {                       // Guess one, then the other
+	*piGuess = aiCode[0];
+	return TRUE;
+    }
+
+    if ((phj->gen != g.genHint) ||
+	(GetTickCount() - phj->msStart > msHintBudget)) {
+	phj->fAbort = TRUE;
+	return FALSE;
+    }
+
+    // Keep guesses leaving no part too big, keyed to try best first
+    for (i=0; i<pbd->cCode; i++)
+	phl->aiGuess[i] = i;
+    PartitionGuesses(pbd,phl->aiGuess,pbd->cCode,aiCode,c,phl->acPart);
+    cKeep = 0;
+    for (i=0, pc=phl->acPart; i<pbd->cCode; i++, pc+=pbd->cResult) {
+	cMax = 0;
+	for (res=0; res<pbd->cResult; res++)
+	    if (res != pbd->resWin)
+		cMax = max(cMax,pc[res]);
+	fIn = (pc[pbd->resWin] != 0);
+	if ((cMax <= phj->acSolve[k-1]) && (cMax < c))
+	    phl->aiGuess[cKeep++] = (cMax*2 + !fIn)*pbd->cCode + i;
+    }
+    qsort(phl->aiGuess,cKeep,sizeof(DWORD),CompareKey);
+
+    for (j=0; j<cKeep; j++) {
+	iGuess = phl->aiGuess[j] % pbd->cCode;
+	if (k == 2) {                   // Every part has one code at most
+	    *piGuess = iGuess;
+	    return TRUE;
+	}
+
+	// Every part must be solvable in the guesses left
+	GroupCodes(pbd,aiCode,c,&pbd->apacked[iGuess],phl->ares,aiFirst,
+		   acPart);
+	for (res=0; res<pbd->cResult; res++) {
+	    if ((res == pbd->resWin) || (acPart[res] <= 2))
+		continue;
+	    if (!HintSolve(phj,iLevel+1,&aiCode[aiFirst[res]],acPart[res],k-1,
+			   &iGuessNext))
+		break;
+	}
+	if (phj->fAbort)
+	    return FALSE;
+	if (res == pbd->cResult) {      // Every part was solvable
+	    *piGuess = iGuess;
+	    return TRUE;
+	}
+    }
+    return FALSE;
+}
+
+
+/***    HintStart - Show a hint now, and start refining it
+ *
+ *      Entry
+ *          hwnd - main window
+ *
+ *      Exit
+ *          Play row holds the minimax guess if SpecThread or the Opening
+ *          Book has it, else a code that fits the moves so far.
+ *          HintThread posts MSG_HINT as it finds better ones.
+ *
+ *      See "Performance Notes (15)" above.
+ */
+VOID HintStart(HWND hwnd)
+{
+    DWORD  *aiCode;
+    SMOVE   asmove[maxMove];
+    DWORD   c;
+    int     i;
+    DWORD   iBest;
+    unsigned idThread;
+    int     k;
+    PHINTJOB phj;
+    PHINTLEVEL phl;
+
+    HintStop();                         // Old hint is no longer wanted
+
+    phj = calloc(1,sizeof(HINTJOB));
+    if (phj == NULL)
+	return;
+    phj->aiCode = malloc(g.bd.cCode*sizeof(DWORD));
+    if (phj->aiCode == NULL) {
+	HintFree(phj);
+	return;
+    }
+    for (i=0; i<maxMove; i++) {
+	phl = &phj->ahl[i];
+	phl->aiGuess = malloc(g.bd.cCode*sizeof(DWORD));
+	phl->acPart = malloc(g.bd.cCode*g.bd.cResult*sizeof(DWORD));
+	phl->ares = malloc(g.bd.cCode*sizeof(RESULT));
+	if ((phl->aiGuess == NULL) || (phl->acPart == NULL) ||
+	    (phl->ares == NULL)) {
+	    HintFree(phj);
+	    return;
+	}
+    }
+
+    aiCode = phj->aiCode;
+    c = FitCodes(aiCode,&iBest);
+    if (c == 0) {
+	HintFree(phj);
+	return;
+    }
+    if (iBest == iCodeNone)             // Not speculated; try the book
+	iBest = BookGuess(&g.bk,&g.bd,asmove,GameMoves(asmove));
+
+    phj->hwnd = hwnd;
+    phj->gen = g.genHint;
+    phj->msStart = GetTickCount();
+    phj->c = c;
+    phj->cGuessLeft = maxMove - g.iMove;
+    phj->iBest = iBest;
+    phj->acSolve[1] = 1;
+    for (k=2; k<=maxMove; k++)          // One code, or one per RESULT left
+	phj->acSolve[k] = min(g.bd.cCode,1+(g.bd.cResult-1)*phj->acSolve[k-1]);
+
+    // Speculated or book guess, or any code that fits, will do for now
+    g.iHint = iCodeNone;
+    HintShow(hwnd,phj->gen,(iBest != iCodeNone) ? iBest : aiCode[0]);
+
+    if (g.fReplay) {                    // Recording has the better hints
+	HintFree(phj);
+	return;
+    }
+    g.hthHint = (HANDLE)_beginthreadex(NULL,0,HintThread,phj,0,&idThread);
+    if (g.hthHint == NULL)              // First hint will have to do
+	HintFree(phj);
+}
+
+
+/***    HintStop - Stop refining the hint
+ *
+ *      Exit
+ *          Hints not yet shown will be ignored, and HintThread is gone.
+ */
+VOID HintStop(VOID)
+{
+    InterlockedIncrement(&g.genHint);
+    if (g.hthHint != NULL) {            // Quits at its next check
+	WaitForSingleObject(g.hthHint,INFINITE);
+	CloseHandle(g.hthHint);
+	g.hthHint = NULL;
+    }
+}
+
+
+/***    HintThread - Refine a hint until time runs out
+ *
+ *      Entry
+ *          pv - HINTJOB; this thread frees it
+ *
+ *      Exit
+ *          Returns 0.  MSG_HINT posted for the minimax guess, then for a
+ *          guess sure to win in as few guesses as can be, if one is found
+ *          within msHintBudget.
+ */
+unsigned __stdcall HintThread(void *pv)
+{
+    DWORD   iGuess;
+    int     k;
+    PHINTJOB phj = pv;
+    PHINTLEVEL phl = &phj->ahl[0];
+
+    if (phj->iBest == iCodeNone) {      // Minimax guess not shown yet
+	iGuess = ChooseGuess(&g.bd,phj->aiCode,phj->c,phl->aiGuess,
+			     phl->acPart);
+	PostMessage(phj->hwnd,MSG_HINT,(WPARAM)phj->gen,(LPARAM)iGuess);
+    }
+
+    for (k=1; (k <= phj->cGuessLeft) && !phj->fAbort; k++) {
+	if (HintSolve(phj,0,phj->aiCode,phj->c,k,&iGuess)) {
+	    PostMessage(phj->hwnd,MSG_HINT,(WPARAM)phj->gen,(LPARAM)iGuess);
+	    break;
+	}
+    }
+
+    HintFree(phj);
+    return 0;
+}
+
+
+/***	MouseInArea - Test if mouse coordinate is in rectangular area
+ *
+ *	Entry
+ *	    xM,yM - mouse coordinate
+ *	    x,y   - left upper corner of area
+ *	    cx,cy - width and height of area
+ *
+ *	Exit
+ *	    Returns TRUE if coordinate is in area.
+ *	    Returns FALSE if coordinate is NOT in area.
+ */
+BOOL MouseInArea(int xM,int yM,int x,int y,int cx,int cy)
+{
+    if ((x <= xM) && (xM < (x+cx)) &&
+	(y <= yM) && (yM < (y+cy)) )
+
+	return TRUE;
+    else
+	return FALSE;
+}
+
+
+/***    NewGame - Start a new game
+ *
+ */
+VOID NewGame(VOID)
+{
+    int ix;
+    int iy;
+
+    HintStop();
+    SpecStop();
+    g.spec.iMove = -1;                  // Nothing speculated
+
+    g.iMove = 0;
+    for (iy=0; iy<maxMove; iy++) {
+	for (ix=0; ix<nPeg; ix++) {
+	    g.amove[iy].guess[ix] = PEG_BLANK;
+	}
+	g.amove[iy].cPosition = 0;
+	g.amove[iy].cColor = 0;
+    }
+
+    // Pick a new code
+    PickCode();
+
+    // Adversary starts with every code, and changes guessCode as it goes
+    g.fAdvGame = g.fAdversary;
+    for (g.cAdv=0; g.cAdv<g.bd.cCode; g.cAdv++)
+	g.aiAdv[g.cAdv] = g.cAdv;
+
+    // Disable Guess button
+    EnableWindow(abutton[iButtonGuess].hwnd,FALSE);
+    g.fGuessAllowed = FALSE;
+
+    // Game not over
+    g.fGameOver = FALSE;
+    g.fGameWon = FALSE;
+
+}
+
+
+/***    NextCode - Step a code on to the code with the next index
+ *
+ *      Entry
+ *          pbd   - board; codes need not be listed
+ *          pcode - code on the board
+ *
+ *      Exit
+ *          Returns TRUE; pcode is the code with the next index.
+ *          Returns FALSE; pcode was the last code, and is now the first.
+ *
+ *      Same as UnrankCode of RankCode+1, but mostly only the last peg
+ *      changes.  See "Performance Notes (22)" above.
+ */
+BOOL NextCode(PBOARD pbd, PCODE pcode)
+{
+    BOOL    fNext = TRUE;       // FALSE => wrapped round to first code
+    WORD    fUsed = 0;          // Bit for each color left of iPeg
+    int     i;
+    int     iPeg;
+    int     peg;
+
+    if (pbd->fDup) {                    // Odometer, last peg fastest
+	for (iPeg=pbd->cPeg-1; iPeg>=0; iPeg--) {
+	    if (++pcode->apeg[iPeg] < pbd->cColor)
+		return TRUE;
+	    pcode->apeg[iPeg] = 0;
+	}
+	return FALSE;
+    }
+
+    // Find the last peg that can take a higher color not used to its
+    // left, then give the pegs after it the lowest colors left
+    for (i=0; i<pbd->cPeg; i++)
+	fUsed |= 1 << pcode->apeg[i];
+    for (iPeg=pbd->cPeg-1; iPeg>=0; iPeg--) {
+	fUsed &= ~(1 << pcode->apeg[iPeg]);
+	for (peg=pcode->apeg[iPeg]+1;
+	     (peg < pbd->cColor) && (fUsed & (1 << peg)); peg++)
+	    ;
+	if (peg < pbd->cColor)
+	    break;
+    }
+    if (iPeg < 0) {                     // Was the last code; fUsed is 0
+	fNext = FALSE;
+	iPeg = 0;
+	peg = 0;
+    }
+    pcode->apeg[iPeg] = (BYTE)peg;
+    fUsed |= 1 << peg;
+    for (i=iPeg+1; i<pbd->cPeg; i++) {
+	for (peg=0; fUsed & (1 << peg); peg++)
+	    ;
+	pcode->apeg[i] = (BYTE)peg;
+	fUsed |= 1 << peg;
+    }
+    return fNext;
+}
+
+
+/***    PackCode - Pack a CODE for ScorePacked
+ *
+ *      Entry
+ *          pbd   - board
+ *          pcode - code to pack
+ *          ppk   - receives packed code
+ */
+VOID PackCode(PBOARD pbd, PCODE pcode, PPACKED ppk)
+{
+    int     i;
+    int     peg;
+
+    ppk->qwPos = 0;
+    ppk->aqwClr[0] = 0;
+    ppk->aqwClr[1] = 0;
+    for (i=0; i<pbd->cPeg; i++) {
+	peg = pcode->apeg[i];
+	ppk->qwPos |= ((ULONGLONG)peg) << (4*i);
+	ppk->aqwClr[peg >> 3] += ((ULONGLONG)1) << (8*(peg & 7));
+    }
+}
+
+
+/***    PoolAlloc - Get a slot from a POOL
+ *
+ *      Entry
+ *          ppool - pool
+ *
+ *      Exit-Success
+ *          Returns slot, cache line aligned; contents undefined.
+ *
+ *      Exit-Failure
+ *          Returns NULL; pool is at its limit, or out of memory.
+ */
+void *PoolAlloc(PPOOL ppool)
+{
+    BYTE   *pb;
+    BYTE   *pbSlab;
+    DWORD   i;
+    void   *pv;
+
+    if (ppool->pvFree == NULL) {        // Add a slab
+	if (ppool->cSlab == ppool->maxSlab)
+	    return NULL;
+	pbSlab = malloc(ppool->cbSlot*ppool->cSlotSlab + cbCacheLine-1);
+	if (pbSlab == NULL)
+	    return NULL;
+	ppool->apvSlab[ppool->cSlab++] = pbSlab;
+
+	// Align first slot, then put every slot on free list, in order
+	pb = pbSlab + ((cbCacheLine - ((size_t)pbSlab & (cbCacheLine-1))) &
+		       (cbCacheLine-1));
+	pb += ppool->cbSlot*ppool->cSlotSlab;
+	for (i=0; i<ppool->cSlotSlab; i++) {
+	    pb -= ppool->cbSlot;
+	    *(void **)pb = ppool->pvFree;
+	    ppool->pvFree = pb;
+	}
+    }
+
+    pv = ppool->pvFree;
+    ppool->pvFree = *(void **)pv;
+    return pv;
+}
+
+
+/***    PoolBegin - Set up a POOL
+ *
+ *      Entry
+ *          ppool     - pool
+ *          cb        - bytes per slot
+ *          cSlotSlab - slots per slab
+ *          maxSlot   - most slots pool will hand out (rounded up to a slab)
+ *
+ *      Exit
+ *          Returns TRUE on success; no slabs allocated yet.
+ *          Returns FALSE if out of memory.
+ */
+BOOL PoolBegin(PPOOL ppool, DWORD cb, DWORD cSlotSlab, DWORD maxSlot)
+{
+    cb = max(cb,sizeof(void *));        // Room for free list link
+    ppool->cbSlot = (cb + cbCacheLine-1) & ~(cbCacheLine-1);
+    ppool->cSlotSlab = cSlotSlab;
+    ppool->cSlab = 0;
+    ppool->maxSlab = (maxSlot + cSlotSlab-1) / cSlotSlab;
+    ppool->pvFree = NULL;
+    ppool->apvSlab = malloc(ppool->maxSlab*sizeof(void *));
+    return (ppool->apvSlab != NULL);
+}
+
+
+/***    PoolEnd - Free a POOL and every slot in it
+ *
+ */
+VOID PoolEnd(PPOOL ppool)
+{
+    int     i;
+
+    for (i=0; i<ppool->cSlab; i++)
+	free(ppool->apvSlab[i]);
+    free(ppool->apvSlab);
+    ppool->apvSlab = NULL;
+    ppool->cSlab = 0;
+    ppool->pvFree = NULL;
+}
+
+
+/***    PoolFree - Return a slot to its POOL
+ *
+ *      Entry
+ *          ppool - pool
+ *          pv    - slot from PoolAlloc(ppool)
+ */
+VOID PoolFree(PPOOL ppool, void *pv)
+{
+    *(void **)pv = ppool->pvFree;
+    ppool->pvFree = pv;
+}
+
+
+/***	ParseCommandLine - Process command line switches
+ *
+ *	Entry
+ *	    lpszCmdLine - command line from WinMain
+ *
+ *	Exit
+ *	    Returns TRUE if command line is valid.  Switches are:
+ *		/record file	    - Record input to file
+ *		/replay file [rpt]  - Replay input from file, report to rpt
+ *		/bench [file]	    - Run benchmarks, write JSON to file
+ *		/gentables [file]   - Write built-in tables to file
+ *		/genfeedback [CxP[u]] - Write Feedback File for board
+ *		/genbook [/board CxP[u]] [/plies n] [/sliced] [strategy]
+ *				    - Write Opening Book for board and
+ *				      strategy (default minimax)
+ *		/server [pipe]	    - Host games on named pipe
+ *		/tournament [/board CxP[u]] [/sample n] [/seed s]
+ *			    [/adversary] [/sliced] [/report file]
+ *			    [plugin.dll ...]
+ *				    - Rank codebreaker strategies
+ *		/analyze file [/board CxP[u]] [/sliced] [/report file]
+ *			    [plugin.dll ...]
+ *				    - Guesses each strategy needs for
+ *				      every code, kept in file
+ *		/static [/board CxP[u]] [/report file]
+ *				    - Fewest guesses that, made all at
+ *				      once, tell every code apart
+ *	    /sliced has the built-in strategies score bit-sliced.
+ *	    Returns FALSE if command line is bad; user has been told.
+ */
+BOOL ParseCommandLine(LPSTR lpszCmdLine)
+{
+    static char achCmdLine[3*cbMaxPath]; // Copy for strtok, keeps pszReport
+    char       *psz;
+    char       *pszFile;
+
+    strncpy(achCmdLine,lpszCmdLine,sizeof(achCmdLine)-1);
+    psz = strtok(achCmdLine," \t");
+    if (psz == NULL)                    // No switches
+	return TRUE;
+
+    pszFile = strtok(NULL," \t");
+    if (lstrcmpi(psz,"/bench") == 0) {
+	g.fBench = TRUE;
+	g.pszBench = pszFile;           // Optional
+	return TRUE;
+    }
+
+    if (lstrcmpi(psz,"/gentables") == 0) {
+	g.fGenTables = TRUE;
+	g.pszTables = pszFile;          // Optional
+	return TRUE;
+    }
+
+    if (lstrcmpi(psz,"/genfeedback") == 0) {
+	g.fGenFeed = TRUE;
+	g.bszFeed.cPeg = 5;             // Super MasterMind, unless told
+	g.bszFeed.cColor = 8;
+	g.bszFeed.fDup = TRUE;
+	if (pszFile == NULL)
+	    return TRUE;
+	if (sscanf(pszFile,"%dx%d",&g.bszFeed.cColor,&g.bszFeed.cPeg) == 2) {
+	    g.bszFeed.fDup = (strchr(pszFile,'u') == NULL);
+	    return TRUE;
+	}
+    }
+
+    if (lstrcmpi(psz,"/genbook") == 0) {
+	g.fGenBook = TRUE;
+	g.tny.cPeg = nPeg;              // Our game, unless told otherwise
+	g.tny.cColor = nColor;
+	g.tny.fDup = FALSE;
+	g.tny.astrat[0].pszName = pszStratBook;
+	g.cPlyBook = cPlyBookDefault;
+	for (psz=pszFile; psz != NULL; psz=strtok(NULL," \t")) {
+	    if (lstrcmpi(psz,"/board") == 0) {
+		psz = strtok(NULL," \t");
+		if ((psz == NULL) ||
+		    (sscanf(psz,"%dx%d",&g.tny.cColor,&g.tny.cPeg) != 2))
+		    break;
+		g.tny.fDup = (strchr(psz,'u') == NULL);
+	    }
+	    else if (lstrcmpi(psz,"/plies") == 0) {
+		psz = strtok(NULL," \t");
+		if (psz == NULL)
+		    break;
+		g.cPlyBook = atoi(psz);
+		if ((g.cPlyBook < 1) || (g.cPlyBook > maxPlyBook))
+		    break;
+	    }
+	    else if (lstrcmpi(psz,"/sliced") == 0)
+		g.tny.fSliced = TRUE;
+	    else if (*psz == '/')       // Unknown switch
+		break;
+	    else
+		g.tny.astrat[0].pszName = psz;
+	}
+	if (psz == NULL)                // Used every word
+	    return TRUE;
+    }
+
+    if (lstrcmpi(psz,"/server") == 0) {
+	g.fServer = TRUE;
+	g.pszPipe = pszFile ? pszFile : pszPipeDefault;
+	return TRUE;
+    }
+
+    if (lstrcmpi(psz,"/static") == 0) {
+	g.fStatic = TRUE;
+	for (psz=pszFile; psz != NULL; psz=strtok(NULL," \t")) {
+	    if (lstrcmpi(psz,"/board") == 0) {
+		psz = strtok(NULL," \t");
+		if ((psz == NULL) ||
+		    (sscanf(psz,"%dx%d",&g.bszStatic.cColor,
+			    &g.bszStatic.cPeg) != 2))
+		    break;
+		g.bszStatic.fDup = (strchr(psz,'u') == NULL);
+	    }
+	    else if (lstrcmpi(psz,"/report") == 0) {
+		if ((g.pszStaticReport = strtok(NULL," \t")) == NULL)
+		    break;
+	    }
+	    else                        // Unknown switch
+		break;
+	}
+	if (psz == NULL)                // Used every word
+	    return TRUE;
+    }
+
+    if (lstrcmpi(psz,"/analyze") == 0) {   // Takes /tournament options
+	g.fAnalyze = TRUE;
+	g.tny.pszAnalysis = pszFile;
+	pszFile = strtok(NULL," \t");
+    }
+
+    if (g.fAnalyze || (lstrcmpi(psz,"/tournament") == 0)) {
+	g.fTourney = !g.fAnalyze;
+	g.tny.cPeg = nPeg;              // Our game, unless told otherwise
+	g.tny.cColor = nColor;
+	g.tny.fDup = FALSE;
+	for (psz=pszFile; psz != NULL; psz=strtok(NULL," \t")) {
+	    if (lstrcmpi(psz,"/board") == 0) {
+		psz = strtok(NULL," \t");
+		if ((psz == NULL) ||
+		    (sscanf(psz,"%dx%d",&g.tny.cColor,&g.tny.cPeg) != 2))
+		    break;
+		g.tny.fDup = (strchr(psz,'u') == NULL);
+	    }
+	    else if (lstrcmpi(psz,"/sample") == 0) {
+		psz = strtok(NULL," \t");
+		if (psz == NULL)
+		    break;
+		g.tny.cSample = atol(psz);
+	    }
+	    else if (lstrcmpi(psz,"/seed") == 0) {
+		psz = strtok(NULL," \t");
+		if (psz == NULL)
+		    break;
+		g.tny.seed = atoi(psz);
+	    }
+	    else if (lstrcmpi(psz,"/adversary") == 0)
+		g.tny.fAdversary = TRUE;
+	    else if (lstrcmpi(psz,"/sliced") == 0)
+		g.tny.fSliced = TRUE;
+	    else if (lstrcmpi(psz,"/report") == 0) {
+		if ((g.tny.pszReport = strtok(NULL," \t")) == NULL)
+		    break;
+	    }
+	    else {
+		if (*psz == '/')        // Unknown switch
+		    break;
+		if (g.tny.cStrat == maxStrategy-cStratBuiltIn) // Leave room
+		    break;
+		g.tny.astrat[g.tny.cStrat++].pszName = psz;
+	    }
+	}
+	if ((psz == NULL) &&            // Used every word
+	    (!g.fAnalyze || (g.tny.pszAnalysis != NULL)))
+	    return TRUE;
+    }
+
+    if (pszFile != NULL) {
+	if (lstrcmpi(psz,"/record") == 0) {
+	    g.pszRecord = pszFile;      // RecordBegin opens it
+	    return TRUE;
+	}
+
+	if (lstrcmpi(psz,"/replay") == 0) {
+	    g.pszReport = strtok(NULL," \t"); // Optional
+	    if (ReplayLoad(pszFile))
+		return TRUE;
+	    MessageBox(NULL,"Cannot read recording file.","MasterMind",
+		       MB_ICONEXCLAMATION | MB_OK);
+	    return FALSE;
+	}
+    }
+
+    MessageBox(NULL,"Usage: mastmind [/record file | /replay file [report] | "
+		    "/bench [file] | /gentables [file] |\n"
+		    " /genfeedback [CxP[u]] |\n"
+		    " /genbook [/board CxP[u]] [/plies n] [/sliced] "
+		    "[strategy] | /server [pipe] |\n"
+		    " /tournament [/board CxP[u]] [/sample n] [/seed s] "
+		    "[/adversary] [/sliced] [/report file] [plugin.dll ...] |\n"
+		    " /analyze file [/board CxP[u]] [/sliced] [/report file] "
+		    "[plugin.dll ...] |\n"
+		    " /static [/board CxP[u]] [/report file]]",
+	       "MasterMind",MB_ICONEXCLAMATION | MB_OK);
+    return FALSE;
+}
+
+
+/***    PartitionCodes - Split codes by the RESULT a guess gets
+ *
+ *      Entry
+ *          pbd      - board, with codes listed
+ *          aiCode   - codes
+ *          c        - count of codes
+ *          ppkGuess - guess
+ *          ares     - receives RESULT for each code in aiCode
+ *          acPart   - receives count of codes for each RESULT
+ */
+VOID PartitionCodes(PBOARD pbd, DWORD *aiCode, DWORD c, PCPACKED ppkGuess,
+		    RESULT *ares, DWORD *acPart)
+{
+    DWORD   i;
+    RESULT  res;
+
+    memset(acPart,0,pbd->cResult*sizeof(DWORD));
+    for (i=0; i<c; i++) {
+	res = ScorePacked(pbd,ppkGuess,&pbd->apacked[aiCode[i]]);
+	ares[i] = res;
+	acPart[res]++;
+    }
+}
+
+
+/***    PartitionGuesses - Count partitions of codes for many guesses
+ *
+ *      Entry
+ *          pbd     - board, codes listed
+ *          aiGuess - guesses
+ *          cGuess  - count of guesses
+ *          aiCode  - codes to partition
+ *          c       - count of codes
+ *          acPart  - room for cGuess*pbd->cResult DWORDs
+ *
+ *      Exit
+ *          acPart[iGuess*pbd->cResult + res] is the count of codes in
+ *          aiCode for which guess aiGuess[iGuess] gets res.
+ *
+ *      Big jobs are split among threads, one per processor.
+ *      See "Performance Notes (14)" above.
+ */
+VOID PartitionGuesses(PBOARD pbd, DWORD *aiGuess, DWORD cGuess,
+		      DWORD *aiCode, DWORD c, DWORD *acPart)
+{
+    HANDLE  ahThread[maxPartThread];
+    DWORD   cThread = 0;
+    unsigned idThread;
+    PARTJOB pj;
+    SYSTEM_INFO si;
+
+    pj.pbd = pbd;
+    pj.aiGuess = aiGuess;
+    pj.cGuess = cGuess;
+    pj.aiCode = aiCode;
+    pj.c = c;
+    pj.acPart = acPart;
+    pj.iGuessNext = 0;
+
+    if ((double)cGuess*c >= cPairThread) {
+	GetSystemInfo(&si);
+	for (cThread=0;
+	     (cThread < si.dwNumberOfProcessors-1) &&
+	     (cThread < maxPartThread) &&
+	     (cThread*cGuessBlock < cGuess);
+	     cThread++) {
+	    ahThread[cThread] = (HANDLE)_beginthreadex(NULL,0,PartitionThread,
+						       &pj,0,&idThread);
+	    if (ahThread[cThread] == NULL)
+		break;
+	}
+    }
+    PartitionThread(&pj);               // This thread helps too
+    if (cThread != 0) {
+	WaitForMultipleObjects(cThread,ahThread,TRUE,INFINITE);
+	while (cThread-- > 0)
+	    CloseHandle(ahThread[cThread]);
+    }
+}
+
+
+/***    PartitionThread - Count partitions for blocks of guesses
+ *
+ *      Entry
+ *          pv - PARTJOB
+ *
+ *      Exit
+ *          Returns 0; acPart filled in for every block this thread took.
+ *
+ *      Takes cGuessBlock guesses at a time.  The codes are copied a tile
+ *      of cCodeBlock at a time into apkTile, which stays in L1 cache
+ *      while every guess in the block is scored against it.  Counts go
+ *      in this thread's acHist, which is small enough to stay in L1 too,
+ *      and are copied to acPart when the block is done.
+ *
+ *      If the board is sliced, the tile is sliced instead of packed, and
+ *      ScoreSliced scores each guess against it cLaneSlice codes at a
+ *      time.  See "Performance Notes (19)" above.
+ */
+unsigned __stdcall PartitionThread(void *pv)
+{
+    DWORD   acHist[cGuessBlock*maxResult]; // Counts for this block
+    PACKED  apkTile[cCodeBlock];        // Codes in this tile
+    ULONGLONG aqwRes[maxResult];        // Lanes getting each RESULT
+    ULONGLONG aqwTile[cCodeBlock/cLaneSlice*maxPegBoard*maxColorBoard];
+					// Codes in this tile, sliced
+    DWORD   cGuess;
+    int     cResult;
+    DWORD   cTile;
+    BOOL    fSliced;
+    DWORD   i;
+    DWORD   iCode;
+    DWORD   iGuess;
+    DWORD   iGuessFirst;
+    DWORD  *pc;
+    PPARTJOB pj = pv;
+    PBOARD  pbd = pj->pbd;
+    PCPACKED ppkGuess;
+    int     res;
+
+    cResult = pbd->cResult;
+    fSliced = (pbd->aqwSlice != NULL);
+    while ((iGuessFirst = (DWORD)InterlockedExchangeAdd(&pj->iGuessNext,
+							cGuessBlock)) <
+	   pj->cGuess) {
+	cGuess = min(cGuessBlock,pj->cGuess - iGuessFirst);
+	memset(acHist,0,cGuess*cResult*sizeof(DWORD));
+	for (iCode=0; iCode<pj->c; iCode+=cTile) {
+	    cTile = min(cCodeBlock,pj->c - iCode);
+	    if (fSliced)
+		SliceCodes(pbd,&pj->aiCode[iCode],cTile,aqwTile);
+	    else
+		for (i=0; i<cTile; i++)
+		    apkTile[i] = pbd->apacked[pj->aiCode[iCode+i]];
+	    for (iGuess=0; iGuess<cGuess; iGuess++) {
+		ppkGuess = &pbd->apacked[pj->aiGuess[iGuessFirst+iGuess]];
+		pc = &acHist[iGuess*cResult];
+		if (!fSliced) {
+		    for (i=0; i<cTile; i++)
+			pc[ScorePacked(pbd,ppkGuess,&apkTile[i])]++;
+		    continue;
+		}
+		for (i=0; i<cTile; i+=cLaneSlice) {
+		    ScoreSliced(pbd,ppkGuess,
+				&aqwTile[i/cLaneSlice*cqwSlice(pbd)],
+				(cTile-i < cLaneSlice) ?
+				    ((ULONGLONG)1 << (cTile-i)) - 1 :
+				    ~(ULONGLONG)0,
+				aqwRes);
+		    for (res=0; res<cResult; res++)
+			pc[res] += CountLanes(aqwRes[res]);
+		}
+	    }
+	}
+	memcpy(&pj->acPart[iGuessFirst*cResult],acHist,
+	       cGuess*cResult*sizeof(DWORD));
+    }
+    return 0;
+}
+
+
+/***	QueryResignGame - See if player wants to resign game
+ *
+ *	Entry
+ *	    hwnd - main window
+ *
+ *	Exit
+ *	    Returns TRUE if player wants to resign.
+ *	    Returns FALSE if player does NOT want to resign.
+ */
+BOOL QueryResignGame(HWND hwnd)
+{
+    char    achText[cbMaxString];
+    char    achCaption[cbMaxString];
+    int     i;
+    FILE   *pfileRecord;
+
+    if (g.fReplay)                      // Use answer from recording
+	return ReplayResign();
+
+    // The box's modal loop sends WM_PAINT and WM_TIMER to WndProc.
+    // Replay shows no box, so keep them out of the recording.
+    pfileRecord = g.pfileRecord;
+    g.pfileRecord = NULL;
+    LoadString(g.hInstance,IDS_RESIGN,achText,sizeof(achText));
+    LoadString(g.hInstance,IDS_APP_TITLE,achCaption,sizeof(achCaption));
+    i = MessageBox(hwnd,achText,achCaption,MB_ICONQUESTION | MB_YESNO);
+    g.pfileRecord = pfileRecord;
+
+    if (g.pfileRecord)                  // Record answer
+	RecordMessage(MSG_RESIGN,(i == IDYES),0L);
+
+    return (i == IDYES);
+}
+
+
+/***	PaintAnswer - Paint the answer on board
+ *
+ *      Entry
+ *	    hwnd - hwnd of main window
+ */
+VOID PaintAnswer(HWND hwnd)
+{
+    HDC     hdc;
+
+    hdc = GetClientDC(hwnd);
+    PaintAnswerSub(hdc);
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***	PaintAnswerSub - Paint the answer on board
+ *
+ *      Entry
+ *          hdc - DC of client area
+ */
+VOID PaintAnswerSub(HDC hdc)
+{
+    int i;
+    int x;
+
+    x = xAnswer;
+    for (i=0; i<nPeg; i++) {
+	PaintLibrary(hdc,x,yAnswer,g.guessCode[i]); // Paint a peg
+	x += cxPegBox;
+    }
+}
+
+
+/***    PaintBoard - Paint the game board
+ *
+ *      Entry
+ *          hdc - DC of client area
+ */
+VOID PaintBoard(HDC hdc)
+{
+    HBRUSH  hbrush;
+    HPEN    hpen;
+    int     i,ix,iy;
+    int     x;
+
+    // Set desired pen/brush and save default pen/brush
+
+    hpen = SelectObject(hdc,GetStockObject(BLACK_PEN));
+    hbrush = SelectObject(hdc,GetStockObject(LTGRAY_BRUSH));
+
+    // Draw Well, Move, Fun, and Result Areas
+
+    Rectangle(hdc,xWell,yWell,xWell+cxWell,yWell+cyWell);
+    if (g.hdcMove == NULL)
+	Rectangle(hdc,xMove,yMove,xMove+cxMove,yMove+cyMove);
+    Rectangle(hdc,xAnswer,yAnswer,xAnswer+cxAnswer,yAnswer+cyAnswer);
+    Rectangle(hdc,g.xFun,g.yFun,g.xFun+g.cxFun,g.yFun+g.cyFun);
+    Rectangle(hdc,xResult,yResult,xResult+cxResult,yResult+cyResult);
+
+    // Draw pegs in Well Area
+
+    x = xWell;
+    for (i=0; i<nColor; i++) {
+	PaintLibrary(hdc,x,yWell,i);  // Paint a peg
+	x += cxPegBox;
+    }
+
+    // BUGBUG 02-Jul-1991 bens	Assert(g.iMove < maxMove);
+
+    // Paint Moves
+
+    if (g.hdcMove)                      // Use Back Buffer
+	PaintMoveArea(hdc);
+    else {
+	for (iy=0; iy<=g.iMove; iy++) { // Paint pegs in move area
+	    for (ix=0; ix<nPeg; ix++) {
+		PaintPegSub(hdc,ix,iy);
+	    }
+	}
+    }
+
+    // Paint answer, if appropriate
+
+    if (g.fGameOver) {
+	PaintAnswerSub(hdc);
+	if (g.fGameWon)
+	    PlayerWonSub(hdc);
+	else
+	    PlayerLostSub(hdc);
+    }
+
+
+    // Paint Results
+
+    for (i=0; i<=g.iMove; i++) {
+	PaintResultSub(hdc,i);
+    }
+
+    // Restore default pen and brush
+
+    SelectObject(hdc,hpen);
+    SelectObject(hdc,hbrush);
+}
+
+
+/***    PaintLibrary - Paint an Image from the Image Library
+ *
+ *      Entry
+ *          hdc - Destination of paint
+ *          x   - Left
+ *          y   - Top
+ *          i   - Image index =
+ *                  0..nColor-1         : Paint peg of color i
+ *                  nColor              : Paint peg hole
+ *                  nColor+1..nColor+15 : Paint a Result Pin Pattern
+ *                                        (see mpResultToLibrary)
+ */
+VOID PaintLibrary(HDC hdc, int x, int y, int iLibrary)
+{
+    BitBlt(hdc,                 // Destination DC
+	   x+cxImageBoxOffset,  // Destination x left
+	   y+cyImageBoxOffset,  // Destination y top
+	   cxImageBox,          // Width of BLT
+	   cyImageBox,          // Height of BLT
+	   g.hdcLibrary,        // Source DC
+	   0,                   // Source x left
+	   iLibrary*cyImageBox, // Source y top
+	   SRCCOPY);            // RasterOp (Copy Src to Dst)
+}
+
+
+/***    PaintHolesForPegs - Paint Peg holes for Next Guess
+ *
+ */
+VOID PaintHolesForPegs(HWND hwnd)
+{
+    HDC     hdc;
+    int     ix;
+
+    hdc = GetClientDC(hwnd);
+
+    for (ix=0; ix<nPeg; ix++) {
+	PaintPegSub(hdc,ix,g.iMove);
+    }
+
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***    PaintMoveArea - Paint Move Area through the Back Buffer
+ *
+ *      Entry
+ *          hdc - DC of client area
+ *          g.anim - swap and drag peg to draw
+ *
+ *      Exit
+ *          Move Area composed in g.hdcMove from the Image Library, then
+ *          copied to hdc with one BitBlt.
+ */
+VOID PaintMoveArea(HDC hdc)
+{
+    int     i;
+    int     ix,iy;
+    PEG     peg;
+    PSPRITE pspr;
+    int     x;
+
+    // Outline and background -- pen and brush selected by CreateBackBuffer
+    Rectangle(g.hdcMove,0,0,cxMove,cyMove);
+
+    // Pegs, leaving holes where swapped pegs are in flight
+    for (iy=0; iy<=g.iMove; iy++) {
+	for (ix=0; ix<nPeg; ix++) {
+	    peg = g.amove[iy].guess[ix];
+	    if ((g.anim.cTick > 0) && (iy == g.anim.iy) &&
+		((ix == g.anim.asprite[0].ixFrom) ||
+		 (ix == g.anim.asprite[0].ixTo)) )
+		peg = PEG_BLANK;
+	    PaintLibrary(g.hdcMove,ix*cxPegBox,iy*cyPegBox,peg);
+	}
+    }
+
+    // Swapped pegs, part way along their row
+    if (g.anim.cTick > 0) {
+	for (i=0; i<2; i++) {
+	    pspr = &g.anim.asprite[i];
+	    if (pspr->peg == PEG_BLANK) // Peg moved into an empty hole
+		continue;
+	    x = pspr->ixFrom*cxPegBox +
+		((pspr->ixTo-pspr->ixFrom)*cxPegBox*g.anim.iTick)/g.anim.cTick;
+	    PaintSprite(g.hdcMove,x,g.anim.iy*cyPegBox,pspr->peg);
+	}
+    }
+
+    // Dragged peg goes on top of everything
+    if (g.anim.fDrag)
+	PaintSprite(g.hdcMove,g.anim.xDrag,g.anim.yDrag,g.anim.pegDrag);
+
+    BitBlt(hdc,xMove,yMove,cxMove,cyMove,g.hdcMove,0,0,SRCCOPY);
+    g.anim.fDirty = FALSE;
+
+#ifdef TIMING
+    if (g.fDragPending) {               // Drag move is now on screen
+	TimingRecord(EV_DRAGTOFRAME,&g.liDrag);
+	g.fDragPending = FALSE;
+    }
+#endif
+}
+
+
+/***    PaintPeg - Paint a peg in the Move Area
+ *
+ *      Entry
+ *          hwnd = client window
+ *          ix   = Column in Move box
+ *          iy   = Row in Move box
+ */
+VOID PaintPeg(HWND hwnd, int ix, int iy)
+{
+    HDC     hdc;
+
+    hdc = GetClientDC(hwnd);
+    PaintPegSub(hdc,ix,iy);             // Paint the peg
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***    PaintPegSub - Worker routine to pain a Peg in the Move Area
+ *
+ *      Entry
+ *          hdc = client window
+ *          ix  = Column in Move box
+ *          iy  = Row in Move box
+ */
+VOID PaintPegSub(HDC hdc, int ix, int iy)
+{
+    PEG     peg;
+    int     x,y;
+
+    peg = g.amove[iy].guess[ix];        // Peg value
+
+    x = xMove + ix*cxPegBox;
+    y = yMove + iy*cyPegBox;
+
+    PaintLibrary(hdc,x,y,peg);          // Paint the peg (or peg hole)
+}
+
+
+/***    PaintResult - Paint a the results for a move
+ *
+ *      Entry
+ *          hwnd = client window
+ *          g.iMove = move to paint results for
+ */
+VOID PaintResult(HWND hwnd)
+{
+    HDC     hdc;
+
+    hdc = GetClientDC(hwnd);
+    PaintResultSub(hdc,g.iMove);        // Paint the result
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***    PaintResultSub - Worker Routine to paint results for a move
+ *
+ *      Entry
+ *          hdc   = client window DC
+ *          iMove = move to paint result for
+ *
+ *      Exit
+ *          returns hbrush of DC at entry.
+ */
+VOID PaintResultSub(HDC hdc, int iMove)
+{
+    int     iPos,iClr;
+    int     x,y;
+
+    x = xResult;
+    y = yResult + iMove*cyPinBox;
+
+    iPos = g.amove[iMove].cPosition;
+    iClr = g.amove[iMove].cColor;
+
+    PaintLibrary(hdc,x,y,mpResultToLibrary[iPos][iClr]);
+}
+
+
+/***    PaintSprite - Paint a peg transparently
+ *
+ *      Entry
+ *          hdc - Destination of paint (Back Buffer)
+ *          x   - Left of Peg Box
+ *          y   - Top of Peg Box
+ *          peg - Peg to paint
+ *
+ *      Exit
+ *          Peg painted without disturbing pixels around it.
+ *          See "Performance Notes (3)" above.
+ */
+VOID PaintSprite(HDC hdc, int x, int y, PEG peg)
+{
+    x += cxImageBoxOffset;
+    y += cyImageBoxOffset;
+
+    BitBlt(hdc,x,y,cxImageBox,cyImageBox,
+	   g.hdcLibrary,0,peg*cyImageBox,SRCINVERT);          // dst ^= peg
+    BitBlt(hdc,x,y,cxImageBox,cyImageBox,
+	   g.hdcLibrary,0,iLibraryMask*cyImageBox,SRCAND);    // dst &= mask
+    BitBlt(hdc,x,y,cxImageBox,cyImageBox,
+	   g.hdcLibrary,0,peg*cyImageBox,SRCINVERT);          // dst ^= peg
+}
+
+
+/***    RandomCode - Pick a random code for a BOARD
+ *
+ *      Entry
+ *          pbd   - board
+ *          pcode - receives code
+ */
+VOID RandomCode(PBOARD pbd, PCODE pcode)
+{
+    BOOL    fColor[maxColorBoard]; // Keep track of colors already picked
+    int     i;
+    int     j;
+
+    memset(fColor,0,sizeof(fColor));
+
+    // Loop until we have filled in all the pegs
+    i = 0;
+    while (i < pbd->cPeg) {
+	j = rand() % pbd->cColor;       // Pick a color
+	if (pbd->fDup || !fColor[j]) {  // Color allowed, use it
+	    pcode->apeg[i] = (BYTE)j;   // Set peg color
+	    fColor[j] = TRUE;           // Remember we used this color
+	    i++;                        // Get color for next peg
+	}
+    }
+}
+
+
+/***	Randomize - Initialize random number generator
+ *
+ *	Exit
+ *	    g.seed is the seed used, so it can be recorded.
+ */
+VOID Randomize(VOID)
+{
+    time_t  t;
+
+    if (!g.fReplay) {   // Replay uses the seed that was recorded
+	time(&t);
+	g.seed = (unsigned)(t>>16);
+    }
+    srand(g.seed);      // Set seed of random number generator
+}
+
+
+/***    RankCode - Get index of a code
+ *
+ *      Entry
+ *          pbd   - board; codes need not be listed
+ *          pcode - code
+ *
+ *      Exit
+ *          Returns index the code has (or would have) in pbd->acode.
+ *          Returns iCodeNone if it is not a code on this board: a color
+ *          out of range, or repeated when colors may not repeat.
+ *
+ *      See "Performance Notes (18)" above.
+ */
+DWORD RankCode(PBOARD pbd, PCCODE pcode)
+{
+    WORD    fBelow;             // Bits for colors below this peg's
+    WORD    fUsed = 0;          // Bit for each color used so far
+    int     i;
+    DWORD   iCode = 0;
+    int     peg;
+
+    if (pbd->cCode == 0)                // Too many codes to index
+	return iCodeNone;
+    for (i=0; i<pbd->cPeg; i++) {
+	peg = pcode->apeg[i];
+	if (peg >= pbd->cColor)
+	    return iCodeNone;
+	if (!pbd->fDup) {               // Skip colors used before
+	    fBelow = (WORD)((1 << peg) - 1);
+	    if (fUsed & (1 << peg))
+		return iCodeNone;
+	    fBelow &= fUsed;
+	    peg -= acBitNibble[fBelow & 0xF] + acBitNibble[(fBelow>>4) & 0xF] +
+		   acBitNibble[(fBelow>>8) & 0xF] + acBitNibble[fBelow>>12];
+	    fUsed |= 1 << pcode->apeg[i];
+	}
+	iCode += peg * pbd->aiPlace[i];
+    }
+    return iCode;
+}
+
+
+/***    PickCode - Create a new Code
+ *
+ */
+VOID PickCode(VOID)
+{
+    int     fColor[nColor]; // Keep track of colors already picked
+    int     i;
+    int     j;
+
+    // Zero color flags
+    for (i=0; i<nColor; i++) {
+	fColor[i] = 0;
+    }
+
+    // Loop until we have filled in all the pegs
+    i = 0;
+    while (i < nPeg) {
+	j = rand() % nColor;    // Pick a color
+	if (fColor[j] == 0) {   // Color not already used, use it
+	    g.guessCode[i] = j; // Set peg color
+	    fColor[j] = 1;      // Remember we used this color
+	    i++;                // Get color for next peg
+	}
+    }
+}
+
+
+/***	PlayerLost - Indicate visually that player lost
+ *
+ */
+VOID PlayerLost(HWND hwnd)
+{
+    HDC     hdc;
+
+    hdc = GetClientDC(hwnd);
+    PlayerLostSub(hdc);
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***	PlayerLostSub - Indicate visually that player lost
+ *
+ */
+VOID   PlayerLostSub(HDC hdc)
+{
+    PlayerTextOut(hdc,"Loser!");
+}
+
+
+/***	PlayerTextOut - Indicate win/lose
+ *
+ */
+VOID PlayerTextOut(HDC hdc, char *psz)
+{
+    HFONT   hfnt;
+    int     nBkMode;
+    int     x,y;
+
+    hfnt = SelectObject(hdc,g.hfntButton);
+    nBkMode = SetBkMode(hdc,TRANSPARENT);
+
+    x = g.xFun + 8; // BUGBUG 02-Jul-1991 bens Hack positioning
+    y = g.yFun + g.cyFun/2;
+
+    TextOut(hdc,x,y,psz,strlen(psz));
+
+    SetBkMode(hdc,nBkMode);	// Restore original background mode
+    SelectObject(hdc,hfnt);	// Restore original font
+}
+
+
+/***	PlayerWon - Indicate visually that player won
+ *
+ */
+VOID PlayerWon(HWND hwnd)
+{
+    HDC     hdc;
+
+    hdc = GetClientDC(hwnd);
+    PlayerWonSub(hdc);
+    ReleaseClientDC(hwnd,hdc);
+}
+
+
+/***	PlayerWonSub - Indicate visually that player won
+ *
+ */
+VOID   PlayerWonSub(HDC hdc)
+{
+    PlayerTextOut(hdc,"Winner!");
+}
+
+
+/***    PlayGame - Play one game of a strategy against a code
+ *
+ *      Entry
+ *          pbd       - Board, codes listed
+ *          pstrat    - Strategy to play
+ *          pvStrat   - State from strategy's StratBegin
+ *          ppkSecret - Code to break; NULL => play the Adversary
+ *          aiAdv     - Room for pbd->cCode codes, if playing Adversary
+ *          aresAdv   - Room for pbd->cCode RESULTs, if playing Adversary
+ *
+ *      Exit
+ *          Returns guesses strategy took to win.
+ *          Returns 0 if strategy gave up, made a bad guess, or ran out of
+ *          guesses.
+ */
+int PlayGame(PBOARD pbd, PSTRATEGY pstrat, void *pvStrat, PCPACKED ppkSecret,
+	     DWORD *aiAdv, RESULT *aresAdv)
+{
+    SMOVE   asmove[maxGuessTourney];
+    CODE    code;
+    DWORD   cAdv;
+    int     cMove;
+    int     i;
+    DWORD   iGuess;
+    PACKED  pkGuess;            // Guess, if codes are not listed
+    PCPACKED ppkGuess;
+    RESULT  res;
+
+    if (ppkSecret == NULL)
+	for (cAdv=0; cAdv<pbd->cCode; cAdv++)
+	    aiAdv[cAdv] = cAdv;
+    res = RESULT_NONE;
+    for (cMove=0; (cMove < maxGuessTourney) && (res != pbd->resWin); ) {
+	if (!(*pstrat->pfnGuess)(pvStrat,asmove,cMove,asmove[cMove].apeg))
+	    return 0;                   // Strategy gave up
+
+	// Check guess is legal on this board; bad guess loses game
+	for (i=0; i<pbd->cPeg; i++)
+	    code.apeg[i] = asmove[cMove].apeg[i];
+	if (pbd->apacked != NULL) {
+	    iGuess = RankCode(pbd,&code);
+	    if (iGuess == iCodeNone)
+		return 0;
+	    ppkGuess = &pbd->apacked[iGuess];
+	}
+	else {                          // Too many codes to list
+	    if (!CheckCode(pbd,&code))
+		return 0;
+	    PackCode(pbd,&code,&pkGuess);
+	    ppkGuess = &pkGuess;
+	}
+
+	if (ppkSecret == NULL)
+	    res = AdversaryAnswer(pbd,aiAdv,&cAdv,ppkGuess,aresAdv);
+	else
+	    res = ScorePacked(pbd,ppkGuess,ppkSecret);
+	asmove[cMove].cPosition = pbd->mpResultToPos[res];
+	asmove[cMove].cColor = pbd->mpResultToClr[res];
+	cMove++;
+    }
+    return (res == pbd->resWin) ? cMove : 0;
+}
+
+
+/***    PropFill - Make a guess from where PropSearch got furthest
+ *
+ *      Entry
+ *          pprs - state, afBest filled in
+ *
+ *      Exit
+ *          pprs->code is a code on the board.  Pegs afBest leaves one
+ *          color are it; the rest take the lowest color afBest leaves
+ *          them that the board allows, or any color it allows.
+ *          See "Performance Notes (23)" above.
+ */
+VOID PropFill(PPROPSTATE pprs)
+{
+    WORD    f;
+    WORD    fUsed = 0;          // Colors taken, if no repeats
+    int     i;
+    int     iClr;
+
+    for (i=0; i<pprs->bd.cPeg; i++)
+	if (!(pprs->afBest[i] & (pprs->afBest[i]-1))) {
+	    for (iClr=0; pprs->afBest[i] != (1 << iClr); iClr++)
+		;
+	    pprs->code.apeg[i] = (BYTE)iClr;
+	    fUsed |= pprs->afBest[i];
+	}
+    for (i=0; i<pprs->bd.cPeg; i++) {
+	if (!(pprs->afBest[i] & (pprs->afBest[i]-1)))
+	    continue;
+	f = pprs->bd.fDup ? pprs->afBest[i] : pprs->afBest[i] & ~fUsed;
+	if (f == 0)                     // Its colors are all taken
+	    f = (WORD)(((1L << pprs->bd.cColor) - 1) & ~fUsed);
+	for (iClr=0; !(f & (1 << iClr)); iClr++)
+	    ;
+	pprs->code.apeg[i] = (BYTE)iClr;
+	if (!pprs->bd.fDup)
+	    fUsed |= 1 << iClr;
+    }
+}
+
+
+/***    PropMove - Take in a move for "propagate"
+ *
+ *      Entry
+ *          pprs   - state
+ *          psmove - move, a code on the board
+ *
+ *      Exit
+ *          Move added to pprs->apm.  Colors it rules out for each peg
+ *          are gone from afRoot, and acMin and acMax are narrowed by
+ *          what it says about how many pegs of each color there are.
+ *          See "Performance Notes (23)" above.
+ */
+VOID PropMove(PPROPSTATE pprs, PSMOVE psmove)
+{
+    int     c;                  // Pegs of a color in guess
+    int     cPeg = pprs->bd.cPeg;
+    int     i;
+    int     iClr;
+    PPROPMOVE ppm = &pprs->apm[pprs->cMove++];
+
+    memset(ppm,0,sizeof(PROPMOVE));
+    for (i=0; i<cPeg; i++) {
+	ppm->apeg[i] = psmove->apeg[i];
+	ppm->acClr[psmove->apeg[i]]++;
+    }
+    ppm->cPosition = psmove->cPosition;
+    ppm->cMatch = psmove->cPosition + psmove->cColor;
+
+    if (ppm->cPosition == 0)            // No peg is the color guessed there
+	for (i=0; i<cPeg; i++)
+	    pprs->afRoot[i] &= (WORD)~(1 << ppm->apeg[i]);
+
+    // Each color in the guess matches min(c,pegs of it in code) times
+    for (iClr=0; iClr<pprs->bd.cColor; iClr++) {
+	c = ppm->acClr[iClr];
+	if (c == 0)                     // Can only be on pegs not matched
+	    pprs->acMax[iClr] = (BYTE)min(pprs->acMax[iClr],
+					  cPeg - ppm->cMatch);
+	else {
+	    if (c > ppm->cMatch)        // Matched only cMatch times at most
+		pprs->acMax[iClr] = (BYTE)min(pprs->acMax[iClr],ppm->cMatch);
+	    if (ppm->cMatch - (cPeg - c) > pprs->acMin[iClr])
+		pprs->acMin[iClr] = (BYTE)(ppm->cMatch - (cPeg - c));
+	}
+    }
+}
+
+
+/***    PropNarrow - Narrow colors of pegs and counts of colors
+ *
+ *      Entry
+ *          pprs         - state
+ *          afDom        - colors each peg can have, bit each
+ *          acMin, acMax - fewest and most pegs each color can have
+ *
+ *      Exit-Success
+ *          Returns TRUE; afDom, acMin and acMax narrowed by every move
+ *          and by each other, until none narrows further.  If every
+ *          peg has one color left, that code fits every move.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; no code within them fits.
+ *
+ *      See "Performance Notes (23)" above.
+ */
+BOOL PropNarrow(PPROPSTATE pprs, WORD *afDom, BYTE *acMin, BYTE *acMax)
+{
+    BYTE    acCan[maxColorBoard]; // Pegs that are or could be each color
+    BYTE    acLo[maxColorBoard];  // Pegs that must be each color
+    int     cColor = pprs->bd.cColor;
+    int     cExact;             // Pegs that must be right in position
+    int     cHi;                // Most color matches a move can get
+    int     cLo;                // Fewest color matches a move can get
+    int     cMaybe;             // Loose pegs that may be right in position
+    int     cMin;               // Sum of acMin
+    int     cMax;               // Sum of acMax
+    int     cPeg = pprs->bd.cPeg;
+    int     cClrHi;             // This color's most matches
+    int     cClrLo;             // This color's fewest matches
+    int     d;
+    BOOL    fChanged;
+    WORD    fClr;
+    WORD    fPeg;
+    int     i;
+    int     iClr;
+    int     iMove;
+    PPROPMOVE ppm;
+
+    do {
+	fChanged = FALSE;
+
+	// Pegs left with one color are it; pegs left with several may be
+	// any of them.  Counts of each color must allow for both.
+	memset(acLo,0,sizeof(acLo));
+	memset(acCan,0,sizeof(acCan));
+	for (i=0; i<cPeg; i++)
+	    for (iClr=0; iClr<cColor; iClr++)
+		if (afDom[i] & (1 << iClr)) {
+		    acCan[iClr]++;
+		    if (afDom[i] == (1 << iClr))
+			acLo[iClr]++;
+		}
+	cMin = 0;
+	cMax = 0;
+	for (iClr=0; iClr<cColor; iClr++) {
+	    acMin[iClr] = max(acMin[iClr],acLo[iClr]);
+	    acMax[iClr] = min(acMax[iClr],acCan[iClr]);
+	    if (acMin[iClr] > acMax[iClr])
+		return FALSE;
+	    cMin += acMin[iClr];
+	    cMax += acMax[iClr];
+	}
+	if ((cMin > cPeg) || (cMax < cPeg))
+	    return FALSE;
+	for (iClr=0; iClr<cColor; iClr++) { // Others' counts limit this one
+	    d = cPeg - (cMax - acMax[iClr]);
+	    if (d > acMin[iClr]) {
+		acMin[iClr] = (BYTE)d;
+		fChanged = TRUE;
+	    }
+	    d = cPeg - (cMin - acMin[iClr]);
+	    if (d < acMax[iClr]) {
+		acMax[iClr] = (BYTE)d;
+		fChanged = TRUE;
+	    }
+	    if (acMin[iClr] > acMax[iClr])
+		return FALSE;
+	}
+
+	// Each move's color matches are the sum over colors of min(pegs in
+	// guess,pegs in code), so each color's share is bounded by the rest
+	for (iMove=0; iMove<pprs->cMove; iMove++) {
+	    ppm = &pprs->apm[iMove];
+	    cLo = 0;
+	    cHi = 0;
+	    for (iClr=0; iClr<cColor; iClr++) {
+		cLo += min(ppm->acClr[iClr],acMin[iClr]);
+		cHi += min(ppm->acClr[iClr],acMax[iClr]);
+	    }
+	    if ((cLo > ppm->cMatch) || (cHi < ppm->cMatch))
+		return FALSE;
+	    for (iClr=0; iClr<cColor; iClr++) {
+		if (ppm->acClr[iClr] == 0)
+		    continue;
+		cClrLo = min(ppm->acClr[iClr],acMin[iClr]);
+		cClrHi = min(ppm->acClr[iClr],acMax[iClr]);
+		d = ppm->cMatch - (cHi - cClrHi); // Fewest this color must give
+		if (d > acMin[iClr]) {
+		    acMin[iClr] = (BYTE)d;
+		    fChanged = TRUE;
+		}
+		d = ppm->cMatch - (cLo - cClrLo); // Most it may give
+		if ((d < ppm->acClr[iClr]) && (d < acMax[iClr])) {
+		    acMax[iClr] = (BYTE)d;
+		    fChanged = TRUE;
+		}
+		if (acMin[iClr] > acMax[iClr])
+		    return FALSE;
+	    }
+	}
+
+	// Counts narrow the colors pegs can have: a color with all the
+	// pegs it may have takes no more, and one that needs every peg
+	// that can be it gets them all
+	for (iClr=0; iClr<cColor; iClr++) {
+	    fClr = (WORD)(1 << iClr);
+	    if ((acLo[iClr] == acMax[iClr]) && (acCan[iClr] > acLo[iClr]))
+		for (i=0; i<cPeg; i++)
+		    if ((afDom[i] & fClr) && (afDom[i] != fClr)) {
+			afDom[i] &= ~fClr;
+			fChanged = TRUE;
+		    }
+	    if ((acCan[iClr] == acMin[iClr]) && (acCan[iClr] > acLo[iClr]))
+		for (i=0; i<cPeg; i++)
+		    if ((afDom[i] & fClr) && (afDom[i] != fClr)) {
+			afDom[i] = fClr;
+			fChanged = TRUE;
+		    }
+	}
+
+	// Position matches of each move
+	for (iMove=0; iMove<pprs->cMove; iMove++) {
+	    ppm = &pprs->apm[iMove];
+	    cExact = 0;
+	    cMaybe = 0;
+	    for (i=0; i<cPeg; i++) {
+		fPeg = (WORD)(1 << ppm->apeg[i]);
+		if (afDom[i] == fPeg)
+		    cExact++;
+		else if (afDom[i] & fPeg)
+		    cMaybe++;
+	    }
+	    if ((cExact > ppm->cPosition) ||
+		(cExact + cMaybe < ppm->cPosition))
+		return FALSE;
+	    if (cMaybe == 0)
+		continue;
+	    if (cExact == ppm->cPosition) // No other peg may be right
+		for (i=0; i<cPeg; i++) {
+		    fPeg = (WORD)(1 << ppm->apeg[i]);
+		    if ((afDom[i] & fPeg) && (afDom[i] != fPeg)) {
+			afDom[i] &= ~fPeg;
+			fChanged = TRUE;
+		    }
+		}
+	    else if (cExact + cMaybe == ppm->cPosition) // All must be right
+		for (i=0; i<cPeg; i++) {
+		    fPeg = (WORD)(1 << ppm->apeg[i]);
+		    if ((afDom[i] & fPeg) && (afDom[i] != fPeg)) {
+			afDom[i] = fPeg;
+			fChanged = TRUE;
+		    }
+		}
+	}
+	for (i=0; i<cPeg; i++)
+	    if (afDom[i] == 0)
+		return FALSE;
+    } while (fChanged);
+    return TRUE;
+}
+
+
+/***    PropSearch - Find a code that fits every move
+ *
+ *      Entry
+ *          pprs                   - state
+ *          afDomAbove             - colors each peg can have
+ *          acMinAbove, acMaxAbove - fewest and most pegs of each color
+ *
+ *      Exit
+ *          Returns TRUE; pprs->code is a code within them that fits
+ *          every move.
+ *          Returns FALSE if there is none, or once pprs->cNode reaches
+ *          maxPropNode.  pprs->afBest is the furthest it got.
+ *
+ *      Settles how many pegs of each color there are before coloring
+ *      any peg, since moves say far more about counts than places.
+ *      See "Performance Notes (23)" above.
+ */
+BOOL PropSearch(PPROPSTATE pprs, WORD *afDomAbove, BYTE *acMinAbove,
+		BYTE *acMaxAbove)
+{
+    BYTE    acMax[maxColorBoard];
+    BYTE    acMin[maxColorBoard];
+    WORD    afDom[maxPegBoard];         // afDomAbove, narrowed
+    int     c;
+    int     cBest;
+    int     cHi;
+    int     cLo;
+    int     i;
+    int     iClr;
+    int     iBest;
+    WORD    f;
+
+    if (pprs->cNode >= maxPropNode)     // Out of time; unwind
+	return FALSE;
+    pprs->cNode++;
+    memcpy(afDom,afDomAbove,pprs->bd.cPeg*sizeof(WORD));
+    memcpy(acMin,acMinAbove,pprs->bd.cColor);
+    memcpy(acMax,acMaxAbove,pprs->bd.cColor);
+    if (!PropNarrow(pprs,afDom,acMin,acMax))
+	return FALSE;
+    for (c=0, i=0; i<pprs->bd.cPeg; i++) // Furthest yet?
+	if (!(afDom[i] & (afDom[i]-1)))
+	    c++;
+    if (c > pprs->cPegBest) {
+	pprs->cPegBest = c;
+	memcpy(pprs->afBest,afDom,pprs->bd.cPeg*sizeof(WORD));
+    }
+
+    // Settle how many pegs of each color first, fewest choices first
+    cBest = maxPegBoard+1;
+    iBest = -1;
+    for (iClr=0; iClr<pprs->bd.cColor; iClr++)
+	if ((acMin[iClr] < acMax[iClr]) && (acMax[iClr]-acMin[iClr] < cBest)) {
+	    cBest = acMax[iClr]-acMin[iClr];
+	    iBest = iClr;
+	}
+    if (iBest >= 0) {
+	cLo = acMin[iBest];
+	cHi = acMax[iBest];
+	for (c=cLo; c<=cHi; c++) {
+	    acMin[iBest] = (BYTE)c;
+	    acMax[iBest] = (BYTE)c;
+	    if (PropSearch(pprs,afDom,acMin,acMax))
+		return TRUE;
+	}
+	return FALSE;
+    }
+
+    // Then color the peg with fewest colors left
+    cBest = maxColorBoard+1;
+    iBest = -1;
+    for (i=0; i<pprs->bd.cPeg; i++) {
+	if (!(afDom[i] & (afDom[i]-1)))
+	    continue;
+	for (c=0, f=afDom[i]; f != 0; f &= f-1)
+	    c++;
+	if (c < cBest) {
+	    cBest = c;
+	    iBest = i;
+	}
+    }
+    if (iBest < 0) {                    // Every peg colored, and it fits
+	for (i=0; i<pprs->bd.cPeg; i++)
+	    for (iClr=0; iClr<pprs->bd.cColor; iClr++)
+		if (afDom[i] == (1 << iClr))
+		    pprs->code.apeg[i] = (BYTE)iClr;
+	return TRUE;
+    }
+    f = afDom[iBest];
+    for (iClr=0; iClr<pprs->bd.cColor; iClr++) {
+	if (!(f & (1 << iClr)))
+	    continue;
+	afDom[iBest] = (WORD)(1 << iClr);
+	if (PropSearch(pprs,afDom,acMin,acMax))
+	    return TRUE;
+    }
+    return FALSE;
+}
+
+
+/***	RecordBegin - Start input recording
+ *
+ *	Entry
+ *	    g.pszRecord - recording file name
+ *	    g.seed	- seed given to srand
+ *
+ *	Exit
+ *	    g.pfileRecord open, with header written.  If file cannot be
+ *	    created, user is told and we play without recording.
+ */
+VOID RecordBegin(VOID)
+{
+    g.pfileRecord = fopen(g.pszRecord,"w");
+    if (g.pfileRecord == NULL) {
+	MessageBox(NULL,"Cannot create recording file.","MasterMind",
+		   MB_ICONEXCLAMATION | MB_OK);
+	return;
+    }
+    fprintf(g.pfileRecord,"MMREPLAY 1\nseed %u\n",g.seed);
+    g.msRecord = GetTickCount();
+}
+
+
+/***	RecordMessage - Record a message reaching WndProc
+ *
+ *	Entry
+ *	    msg,wParam,lParam - message
+ *
+ *	Exit
+ *	    Message written to g.pfileRecord, if it is one we replay.
+ */
+VOID RecordMessage(UINT msg,UINT wParam,LONG lParam)
+{
+    int     i;
+
+    if ((msg != MSG_RESIGN) && (msg != MSG_HINT)) {
+	for (i=0; (i<nReplayStat) && (arstat[i].msg != msg); i++)
+	    ;
+	if (i == nReplayStat)           // Not a message we replay
+	    return;
+    }
+
+    if (msg == WM_COMMAND)              // Button hwnd differs in replay
+	lParam = 0;
+
+    fprintf(g.pfileRecord,"%lu %x %x %lx\n",
+	    GetTickCount()-g.msRecord,msg,wParam,lParam);
+}
+
+
+/***	ReleaseClientDC - Free DC from GetClientDC
+ *
+ *	Entry
+ *	    hwnd - main window
+ *	    hdc  - DC returned by GetClientDC
+ */
+VOID ReleaseClientDC(HWND hwnd, HDC hdc)
+{
+    if (hdc != g.hdcReplay)
+	ReleaseDC(hwnd,hdc);
+}
+
+
+/***    ReleaseMouse - Release mouse capture and unrestrict mouse motion
+ *
+ */
+VOID ReleaseMouse(VOID)
+{
+    if (g.fReplay)                  // Mouse was never captured
+	return;
+    ClipCursor(NULL);               // Restore mouse mobility
+    ReleaseCapture();               // Release mouse capture
+}
+
+
+/***	ReplayLoad - Read input recording into memory
+ *
+ *	Entry
+ *	    pszFile - recording file
+ *
+ *	Exit
+ *	    Returns TRUE if recording read; g.arec, g.crec, g.seed filled in,
+ *	    and g.fReplay set.
+ *	    Returns FALSE if file could not be read.
+ */
+BOOL ReplayLoad(char *pszFile)
+{
+    int     cAlloc;
+    FILE   *pfile;
+    PRECORD prec;
+    RECORD  rec;
+    int     ver;
+
+    pfile = fopen(pszFile,"r");
+    if (pfile == NULL)
+	return FALSE;
+
+    if ((fscanf(pfile,"MMREPLAY %d seed %u",&ver,&g.seed) != 2) ||
+	(ver != 1)) {
+	fclose(pfile);
+	return FALSE;
+    }
+
+    // Read whole recording now, so replay timing does not include file I/O
+    cAlloc = 0;
+    while (fscanf(pfile,"%lu %x %x %lx",
+		  &rec.ms,&rec.msg,&rec.wParam,&rec.lParam) == 4) {
+	if (g.crec == cAlloc) {         // Grow array
+	    cAlloc = cAlloc ? 2*cAlloc : 256;
+	    prec = realloc(g.arec,cAlloc*sizeof(RECORD));
+	    if (prec == NULL) {
+		fclose(pfile);
+		return FALSE;
+	    }
+	    g.arec = prec;
+	}
+	g.arec[g.crec++] = rec;
+    }
+    fclose(pfile);
+
+    g.fReplay = TRUE;
+    return TRUE;
+}
+
+
+/***	ReplayResign - Get recorded answer to QueryResignGame
+ *
+ *	Exit
+ *	    Returns recorded answer, and skips over its record.
+ *	    Returns FALSE if next record is not an answer.
+ */
+BOOL ReplayResign(VOID)
+{
+    if ((g.irec < g.crec) && (g.arec[g.irec].msg == MSG_RESIGN))
+	return g.arec[g.irec++].wParam;
+    return FALSE;
+}
+
+
+/***	ReplayRun - Replay input recording against off-screen client area
+ *
+ *	Entry
+ *	    g.arec - recording; g.hwnd created, but not shown
+ *
+ *	Exit
+ *	    Report of total and per-event time written to g.pszReport, or
+ *	    shown in a message box.  See "Performance Notes (6)" above.
+ */
+VOID ReplayRun(VOID)
+{
+    char	ach[(nReplayStat+2)*64];
+    HDC 	hdc;
+    int 	i;
+    LARGE_INTEGER liFreq;
+    LARGE_INTEGER liStart;
+    LARGE_INTEGER liStop;
+    LONGLONG	liTotal;
+    FILE       *pfile;
+    PRECORD	prec;
+    char       *psz;
+
+    // Create off-screen client area
+    hdc = GetDC(NULL);
+    g.hdcReplay = CreateCompatibleDC(hdc);
+    g.hbmReplay = CreateCompatibleBitmap(hdc,g.cxClient,g.cyClient);
+    ReleaseDC(NULL,hdc);
+    SelectObject(g.hdcReplay,g.hbmReplay);
+    PatBlt(g.hdcReplay,0,0,g.cxClient,g.cyClient,WHITENESS);
+
+    QueryPerformanceFrequency(&liFreq);
+    if (liFreq.QuadPart == 0)           // No performance counter
+	liFreq.QuadPart = 1;
+
+    // Feed each message straight to WndProc
+    liTotal = 0;
+    g.irec = 0;
+    while (g.irec < g.crec) {
+	prec = &g.arec[g.irec++];
+	if (prec->msg == MSG_RESIGN)    // Answer with no question
+	    continue;
+	g.msReplay = prec->ms;
+
+	QueryPerformanceCounter(&liStart);
+	if (prec->msg == WM_PAINT)      // No BeginPaint on hidden window
+	    PaintBoard(g.hdcReplay);
+	else
+	    WndProc(g.hwnd,prec->msg,prec->wParam,prec->lParam);
+	QueryPerformanceCounter(&liStop);
+
+	for (i=0; i<nReplayStat; i++) {
+	    if (arstat[i].msg == prec->msg) {
+		arstat[i].c++;
+		arstat[i].liTotal += liStop.QuadPart - liStart.QuadPart;
+		break;
+	    }
+	}
+	liTotal += liStop.QuadPart - liStart.QuadPart;
+    }
+
+    // Report
+    psz = ach;
+    psz += wsprintf(psz,"Replayed %d events in %lu us\n",g.crec,
+		    (DWORD)((liTotal*1000000)/liFreq.QuadPart));
+    psz += wsprintf(psz,"Message\tCount\tns/event\n");
+    for (i=0; i<nReplayStat; i++) {
+	if (arstat[i].c == 0)
+	    continue;
+	psz += wsprintf(psz,"%s\t%lu\t%lu\n",arstat[i].psz,arstat[i].c,
+		(DWORD)((arstat[i].liTotal*1e9)/
+			((double)liFreq.QuadPart*arstat[i].c)));
+    }
+
+    pfile = g.pszReport ? fopen(g.pszReport,"w") : NULL;
+    if (pfile != NULL) {
+	fputs(ach,pfile);
+	fclose(pfile);
+    }
+    else
+	MessageBox(NULL,ach,"MasterMind Replay",MB_OK);
+
+    // Free off-screen client area; painting goes back to the screen
+    DeleteDC(g.hdcReplay);
+    DeleteObject(g.hbmReplay);
+    g.hdcReplay = NULL;
+    free(g.arec);
+}
+
+
+/***    ScoreCode - Score a guess against a code
+ *
+ *      Entry
+ *          pbd        - board
+ *          pcodeGuess - guess
+ *          pcodeCode  - code
+ *
+ *      Exit
+ *          Returns RESULT.  Pegs matched by color and position are not
+ *          counted again for color only.
+ */
+RESULT ScoreCode(PBOARD pbd, PCCODE pcodeGuess, PCCODE pcodeCode)
+{
+    int cColor = 0;             // Count of color-only matches
+    int codeColors[maxColorBoard];  // Count of each color in code
+    int cPosition = 0;          // Count of color-and-position matches
+    int guessColors[maxColorBoard]; // Count of each color in guess
+    int i;
+    int j;
+
+    // Zero color counts
+    for (i=0; i<pbd->cColor; i++) {
+	guessColors[i] = 0;
+	codeColors[i] = 0;
+    }
+
+    // Count colors in guess and code
+    for (i=0; i<pbd->cPeg; i++) {
+	guessColors[pcodeGuess->apeg[i]]++;
+	codeColors[pcodeCode->apeg[i]]++;
+    }
+
+    // Count exact matches
+    for (i=0; i<pbd->cPeg; i++) {
+	j = pcodeGuess->apeg[i];    // Get guess color
+	if (j == pcodeCode->apeg[i]) {  // Exact match!
+	    // Begin Assert
+	    if ((guessColors[j] <= 0) || (codeColors[j] <= 0)) {
+		AssertMsg("Found exact match, but color count <= 0.");
+	    }
+	    // End Assert
+	    guessColors[j]--;       // Reduce color count in guess
+	    codeColors[j]--;        // Reduce color count in code
+	    cPosition++;            // Count exact match
+	}
+    }
+
+    // Count color matches that remain after exact matches
+    for (i=0; i<pbd->cColor; i++) {
+	cColor += min(codeColors[i],guessColors[i]);
+    }
+
+    return pbd->mpPosClrToResult[cPosition][cColor];
+}
+
+
+/***    ScorePacked - Score a packed guess against a packed code
+ *
+ *      Entry
+ *          pbd      - board
+ *          ppkGuess - guess
+ *          ppkCode  - code
+ *
+ *      Exit
+ *          Returns RESULT, same as ScoreCode.  See "Performance Notes (7)".
+ */
+RESULT ScorePacked(PBOARD pbd, PCPACKED ppkGuess, PCPACKED ppkCode)
+{
+    ULONGLONG a;
+    ULONGLONG b;
+    int     cMatch;             // Color matches, including exact matches
+    int     cPosition;
+    ULONGLONG d;
+    int     i;
+    ULONGLONG x;
+
+    // Exact matches: a nibble of XOR is zero where pegs match
+    x = ppkGuess->qwPos ^ ppkCode->qwPos;
+    x = (x | (x >> 1) | (x >> 2) | (x >> 3)) & QW(0x11111111,0x11111111);
+    x = (x + (x >> 4)) & QW(0x0F0F0F0F,0x0F0F0F0F); // Mismatches per byte
+    cPosition = pbd->cPeg -
+		(int)((x * QW(0x01010101,0x01010101)) >> 56);
+
+    // Color matches: sum over colors of min(guess count,code count)
+    cMatch = 0;
+    for (i=0; i<2; i++) {
+	a = ppkGuess->aqwClr[i];
+	b = ppkCode->aqwClr[i];
+	d = ((a | QW(0x80808080,0x80808080)) - b) & QW(0x80808080,0x80808080);
+	d = (d >> 7) * 0xFF;    // 0xFF in each byte where a >= b
+	x = (b & d) | (a & ~d); // min(a,b) in each byte
+	cMatch += (int)((x * QW(0x01010101,0x01010101)) >> 56);
+    }
+
+    return pbd->mpPosClrToResult[cPosition][cMatch - cPosition];
+}
+
+
+/***    ScoreSliced - Score a packed guess against a slice of codes
+ *
+ *      Entry
+ *          pbd      - board
+ *          ppkGuess - guess
+ *          aqw      - slice, from SliceCodes
+ *          qwLanes  - lanes holding codes
+ *          aqwRes   - receives, for each RESULT, the lanes getting it
+ *
+ *      Exit
+ *          aqwRes[0..pbd->cResult-1] filled in; lanes not in qwLanes are
+ *          in none of them.  See "Performance Notes (19)" above.
+ */
+VOID ScoreSliced(PBOARD pbd, PCPACKED ppkGuess, ULONGLONG *aqw,
+		 ULONGLONG qwLanes, ULONGLONG *aqwRes)
+{
+    ULONGLONG aqwAtLeast[maxPegBoard+1]; // Lanes with at least n so far
+    ULONGLONG aqwIsMatch[maxPegBoard+1]; // Lanes with n color matches
+    ULONGLONG aqwIsPos[maxPegBoard+1];   // Lanes with n exact matches
+    ULONGLONG aqwMatch[maxBitCount];     // Color matches, bit-sliced
+    ULONGLONG aqwPos[maxBitCount];       // Exact matches, bit-sliced
+    int     cBit;               // Bits needed to count to cPeg
+    int     cClr;               // Pegs of this color in guess
+    int     cPeg = pbd->cPeg;
+    int     i;
+    int     iBit;
+    int     iClr;
+    int     iPeg;
+    int     res;
+    ULONGLONG qw;
+    ULONGLONG qwCarry;
+
+    for (cBit=1; (1 << cBit) <= cPeg; cBit++)
+	;
+    memset(aqwPos,0,sizeof(aqwPos));
+    memset(aqwMatch,0,sizeof(aqwMatch));
+
+    // Exact matches: add up the plane for each guess peg's color
+    for (iPeg=0; iPeg<cPeg; iPeg++) {
+	iClr = (int)(ppkGuess->qwPos >> (4*iPeg)) & 0xF;
+	qwCarry = aqw[iPeg*pbd->cColor + iClr];
+	for (iBit=0; (iBit < cBit) && (qwCarry != 0); iBit++) {
+	    qw = aqwPos[iBit] & qwCarry;
+	    aqwPos[iBit] ^= qwCarry;
+	    qwCarry = qw;
+	}
+    }
+
+    // Color matches: for each color, add min(guess count,code count) as
+    // the lanes having at least 1, 2, ... cClr pegs of it
+    for (iClr=0; iClr<pbd->cColor; iClr++) {
+	cClr = (int)(ppkGuess->aqwClr[iClr >> 3] >> (8*(iClr & 7))) & 0xFF;
+	if (cClr == 0)
+	    continue;
+	aqwAtLeast[0] = ~(ULONGLONG)0;
+	memset(&aqwAtLeast[1],0,cClr*sizeof(ULONGLONG));
+	for (iPeg=0; iPeg<cPeg; iPeg++) {
+	    qw = aqw[iPeg*pbd->cColor + iClr];
+	    for (i=cClr; i>0; i--)
+		aqwAtLeast[i] |= aqwAtLeast[i-1] & qw;
+	}
+	for (i=1; i<=cClr; i++) {
+	    qwCarry = aqwAtLeast[i];
+	    for (iBit=0; (iBit < cBit) && (qwCarry != 0); iBit++) {
+		qw = aqwMatch[iBit] & qwCarry;
+		aqwMatch[iBit] ^= qwCarry;
+		qwCarry = qw;
+	    }
+	}
+    }
+
+    // Decode both counts, then pair them up into RESULTs
+    for (i=0; i<=cPeg; i++) {
+	aqwIsPos[i] = qwLanes;
+	aqwIsMatch[i] = ~(ULONGLONG)0;
+	for (iBit=0; iBit<cBit; iBit++) {
+	    aqwIsPos[i] &= ((i >> iBit) & 1) ? aqwPos[iBit] : ~aqwPos[iBit];
+	    aqwIsMatch[i] &= ((i >> iBit) & 1) ? aqwMatch[iBit] :
+						 ~aqwMatch[iBit];
+	}
+    }
+    for (res=0; res<pbd->cResult; res++)
+	aqwRes[res] = aqwIsPos[pbd->mpResultToPos[res]] &
+		      aqwIsMatch[pbd->mpResultToPos[res] +
+				 pbd->mpResultToClr[res]];
+}
+
+
+/***    Server - Host games on a named pipe
+ *
+ *      Entry
+ *          pszPipe - pipe name
+ *
+ *      Exit-Success
+ *          Returns TRUE; a client sent SOP_QUIT.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; could not start server, user has been told.
+ *
+ *      See "Performance Notes (8)" above.
+ */
+BOOL Server(char *pszPipe)
+{
+    DWORD   c;
+    DWORD   cb;
+    DWORD   cRetry = 0;         // Pipes waiting to reconnect
+    BOOL    fOK;
+    BOOL    fQuit = FALSE;
+    DWORD   i;
+    ULONG_PTR key;
+    DWORD   ms;
+    DWORD   msRetryStart;       // When the first of cRetry pipes failed
+    DWORD   msWait;
+    LPOVERLAPPED pov;
+    PPIPE   ppipe;
+    PPIPE   apipe = NULL;
+
+    Randomize();
+    apipe = malloc(cPipe*sizeof(PIPE));
+    g.hiocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE,NULL,0,1);
+    if ((apipe == NULL) || (g.hiocp == NULL) || !ServerBegin())
+	goto Error;
+
+    // Create pipe instances and wait for clients on all of them
+    for (i=0; i<cPipe; i++) {
+	apipe[i].h = INVALID_HANDLE_VALUE;
+	apipe[i].fRetry = FALSE;
+	apipe[i].pses = NULL;
+    }
+    for (i=0; i<cPipe; i++) {
+	ppipe = &apipe[i];
+	ppipe->h = CreateNamedPipe(pszPipe,
+				   PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+				   PIPE_TYPE_BYTE | PIPE_READMODE_BYTE |
+				   PIPE_WAIT,
+				   PIPE_UNLIMITED_INSTANCES,
+				   cbPipeBuf,cbPipeBuf,0,NULL);
+	if ((ppipe->h == INVALID_HANDLE_VALUE) ||
+	    (CreateIoCompletionPort(ppipe->h,g.hiocp,0,0) == NULL))
+	    goto Error;
+	ServerConnect(ppipe);
+    }
+
+    // Serve until told to quit
+    for (;;) {
+	msWait = INFINITE;
+	if (cRetry > 0) {
+	    ms = GetTickCount() - msRetryStart;
+	    msWait = (ms < msRetry) ? msRetry - ms : 0;
+	}
+	fOK = GetQueuedCompletionStatus(g.hiocp,&cb,&key,&pov,msWait);
+	if (pov == NULL) {
+	    if (GetLastError() != WAIT_TIMEOUT) // Port itself failed
+		goto Error;
+
+	    // Retry wait is up; any pipe that fails again waits again
+	    cRetry = 0;
+	    for (i=0; i<cPipe; i++)
+		if (apipe[i].fRetry) {
+		    apipe[i].fRetry = FALSE;
+		    ServerConnect(&apipe[i]);
+		}
+	    continue;
+	}
+	ppipe = (PPIPE)pov;             // ov is first in PIPE
+	if (key == keyRetry) {          // See ServerConnect
+	    ppipe->fRetry = TRUE;
+	    if (cRetry++ == 0)
+		msRetryStart = GetTickCount();
+	    continue;
+	}
+
+	switch (ppipe->ps) {
+
+	case PS_CONNECT:
+	    if (!fOK) {
+		ServerConnect(ppipe);
+		break;
+	    }
+	    ppipe->cbIn = 0;
+	    goto Read;
+
+	case PS_READ:
+	    if (!fOK || (cb == 0)) {    // Client went away
+		ServerDisconnect(ppipe);
+		break;
+	    }
+
+	    // Answer every whole request, up to any SOP_QUIT; keep any
+	    // partial one
+	    ppipe->cbIn += cb;
+	    i = ppipe->cbIn / sizeof(SREQUEST);
+	    c = i;
+	    if (!ServerBatch(ppipe,(PSREQUEST)ppipe->abIn,
+			     (PSREPLY)ppipe->abOut,&c))
+		fQuit = TRUE;
+	    ppipe->cbIn -= i*sizeof(SREQUEST);
+	    memmove(ppipe->abIn,&ppipe->abIn[i*sizeof(SREQUEST)],ppipe->cbIn);
+
+	    cb = c*sizeof(SREPLY);
+	    if (cb == 0)                // Only part of a request so far
+		goto Read;
+	    ppipe->ps = PS_WRITE;
+	    if (!WriteFile(ppipe->h,ppipe->abOut,cb,NULL,&ppipe->ov) &&
+		(GetLastError() != ERROR_IO_PENDING)) {
+		if (fQuit)
+		    goto Done;
+		ServerDisconnect(ppipe);
+	    }
+	    break;
+
+	case PS_WRITE:
+	    if (fQuit)                  // Reply to SOP_QUIT is out
+		goto Done;
+	    if (!fOK) {
+		ServerDisconnect(ppipe);
+		break;
+	    }
+	    goto Read;
+	}
+	continue;
+
+Read:
+	ppipe->ps = PS_READ;
+	if (!ReadFile(ppipe->h,&ppipe->abIn[ppipe->cbIn],
+		      cbPipeBuf - ppipe->cbIn,NULL,&ppipe->ov) &&
+	    (GetLastError() != ERROR_IO_PENDING))
+	    ServerDisconnect(ppipe);
+    }
+
+Error:
+    MessageBox(NULL,"Could not run server.","MasterMind",
+	       MB_ICONEXCLAMATION | MB_OK);
+
+Done:
+    if (apipe != NULL)
+	for (i=0; i<cPipe; i++)
+	    if (apipe[i].h != INVALID_HANDLE_VALUE)
+		CloseHandle(apipe[i].h);
+    if (g.hiocp != NULL)
+	CloseHandle(g.hiocp);
+    free(apipe);
+    ServerEnd();
+    return fQuit;
+}
+
+
+/***    ServerBatch - Answer a batch of server requests
+ *
+ *      Entry
+ *          ppipe - pipe the requests came on, NULL if none
+ *          asreq - requests
+ *          asrep - receives one reply per request answered
+ *          pc    - count of requests
+ *
+ *      Exit-Success
+ *          Returns TRUE; every request answered.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; a request was SOP_QUIT, and it is the last one
+ *          answered.  *pc is set to the count answered.
+ *
+ *      Runs of SOP_GUESS go to ServerGuesses together; other requests
+ *      are answered one at a time, in order.
+ */
+BOOL ServerBatch(PPIPE ppipe, PSREQUEST asreq, PSREPLY asrep, DWORD *pc)
+{
+    DWORD   i = 0;
+    DWORD   j;
+
+    while (i < *pc) {
+	if (asreq[i].op == SOP_GUESS) {
+	    for (j=i+1; (j < *pc) && (asreq[j].op == SOP_GUESS); j++)
+		;
+	    ServerGuesses(&asreq[i],&asrep[i],j-i);
+	    i = j;
+	}
+	else if (!ServerRequest(ppipe,&asreq[i],&asrep[i])) {
+	    *pc = i+1;
+	    return FALSE;
+	}
+	else
+	    i++;
+    }
+    return TRUE;
+}
+
+
+/***    ServerBegin - Set up server session table
+ *
+ *      Exit
+ *          Returns TRUE on success, every session slot free, and
+ *          g.bdServer listed with its Feedback Table.
+ *          Returns FALSE if out of memory.
+ */
+BOOL ServerBegin(VOID)
+{
+    DWORD   i;
+
+    g.apses = malloc(maxSession*sizeof(PSESSION));
+    g.aiSesFree = malloc(maxSession*sizeof(DWORD));
+    if ((g.apses == NULL) || (g.aiSesFree == NULL) ||
+	!PoolBegin(&g.poolSession,sizeof(SESSION),cSesSlab,maxSession) ||
+	!BoardBegin(&g.bd,nPeg,nColor,FALSE,FALSE) ||
+	!BoardBegin(&g.bdServer,nPeg,nColor,TRUE,TRUE) ||
+	!BoardTable(&g.bdServer)) {
+	ServerEnd();
+	return FALSE;
+    }
+
+    for (i=0; i<maxSession; i++) {
+	g.apses[i] = NULL;
+	g.aiSesFree[i] = maxSession-1 - i;  // Hand out low slots first
+    }
+    g.ciSesFree = maxSession;
+    return TRUE;
+}
+
+
+/***    ServerConnect - Wait for a client on a server pipe instance
+ *
+ *      Entry
+ *          ppipe - pipe instance, not connected
+ *
+ *      Exit
+ *          Completion for PS_CONNECT will come through g.hiocp.
+ */
+VOID ServerConnect(PPIPE ppipe)
+{
+    memset(&ppipe->ov,0,sizeof(OVERLAPPED));
+    ppipe->ps = PS_CONNECT;
+    if (ConnectNamedPipe(ppipe->h,&ppipe->ov))
+	return;                         // Completion is queued
+
+    switch (GetLastError()) {
+
+    case ERROR_IO_PENDING:
+	break;
+
+    case ERROR_PIPE_CONNECTED:          // Client beat us; no completion
+	PostQueuedCompletionStatus(g.hiocp,0,0,&ppipe->ov);
+	break;
+
+    default:                            // Stale client; try again later
+	DisconnectNamedPipe(ppipe->h);
+	PostQueuedCompletionStatus(g.hiocp,0,keyRetry,&ppipe->ov);
+	break;
+    }
+}
+
+
+/***    ServerDisconnect - Drop a server pipe's client
+ *
+ *      Entry
+ *          ppipe - pipe instance, connected
+ *
+ *      Exit
+ *          Every session the client started is ended, and the pipe waits
+ *          for a new client.
+ */
+VOID ServerDisconnect(PPIPE ppipe)
+{
+    while (ppipe->pses != NULL)
+	SessionEnd(ppipe->pses);
+    ppipe->cbIn = 0;
+    DisconnectNamedPipe(ppipe->h);
+    ServerConnect(ppipe);
+}
+
+
+/***    ServerEnd - Free server session table and every session
+ *
+ */
+VOID ServerEnd(VOID)
+{
+    PoolEnd(&g.poolSession);            // Frees every session
+    free(g.apses);
+    free(g.aiSesFree);
+    g.apses = NULL;
+    g.aiSesFree = NULL;
+    g.ciSesFree = 0;
+    BoardEnd(&g.bd);
+    BoardEnd(&g.bdServer);
+}
+
+
+/***    ServerGuesses - Score a batch of SOP_GUESS requests
+ *
+ *      Entry
+ *          asreq - SOP_GUESS requests
+ *          asrep - receives one reply per request
+ *          c     - count of requests
+ *
+ *      Exit
+ *          Replies filled in; sessions updated.  See "Performance Notes
+ *          (8)" above.
+ */
+VOID ServerGuesses(PSREQUEST asreq, PSREPLY asrep, DWORD c)
+{
+    DWORD   aiGuess[maxBatch];  // Guesses' code indexes on g.bdServer
+    WORD    aiNext[maxBatch];   // Next guess for same session
+    PSESSION apses[maxBatch];   // Sessions with guesses in this batch
+    DWORD   cses;
+    DWORD   cThis;              // Guesses in this part of batch
+    DWORD   i;
+    DWORD   ig;                 // Guess's pegs, in base nColor
+    int     iPeg;
+    DWORD   ises;
+    const RESULT *pres;         // Feedback Table row for session's code
+    PSREPLY psrep;
+    PSREQUEST psreq;
+    PSESSION pses;
+    RESULT  res;
+
+    for (; c > 0; asreq+=cThis, asrep+=cThis, c-=cThis) {
+	cThis = min(c,maxBatch);
+	if (++g.stampBatch == 0)        // 0 means "no batch yet"
+	    g.stampBatch = 1;
+
+	// Check and pack guesses, chaining them by session, in order sent
+	cses = 0;
+	for (i=0; i<cThis; i++) {
+	    psreq = &asreq[i];
+	    psrep = &asrep[i];
+	    psrep->op = psreq->op;
+	    psrep->err = SERR_NONE;
+	    psrep->cPosition = 0;
+	    psrep->cColor = 0;
+	    psrep->id = psreq->id;
+
+	    pses = SessionFind(psreq->id);
+	    if (pses == NULL) {
+		psrep->err = SERR_SESSION;
+		continue;
+	    }
+	    ig = 0;
+	    for (iPeg=0; iPeg<nPeg; iPeg++) {
+		if (psreq->apeg[iPeg] >= nColor)
+		    break;
+		ig = ig*nColor + psreq->apeg[iPeg];
+	    }
+	    if (iPeg < nPeg) {
+		psrep->err = SERR_GUESS;
+		continue;
+	    }
+	    aiGuess[i] = ig;            // RankCode, as colors may repeat
+
+	    aiNext[i] = 0xFFFF;         // End of chain
+	    if (pses->stampBatch != g.stampBatch) { // First for session
+		pses->stampBatch = g.stampBatch;
+		pses->iFirst = (WORD)i;
+		apses[cses++] = pses;
+	    }
+	    else
+		aiNext[pses->iLast] = (WORD)i;
+	    pses->iLast = (WORD)i;
+	}
+
+	// Score each session's guesses together, from the row of the
+	// Feedback Table for its code (scores are the same both ways round)
+	for (ises=0; ises<cses; ises++) {
+	    pses = apses[ises];
+	    pres = &ScoreTable(&g.bdServer,pses->iCode,0);
+	    for (i=pses->iFirst; i != 0xFFFF; i=aiNext[i]) {
+		if (pses->fOver) {
+		    asrep[i].err = SERR_OVER;
+		    continue;
+		}
+		res = pres[aiGuess[i]];
+		asrep[i].cPosition = g.bd.mpResultToPos[res];
+		asrep[i].cColor = g.bd.mpResultToClr[res];
+		pses->cGuess++;
+		pses->fOver = (res == g.bd.resWin) ||
+			      (pses->cGuess == maxMove);
+	    }
+	}
+    }
+}
+
+
+/***    ServerRequest - Answer one server request
+ *
+ *      Entry
+ *          ppipe - pipe the request came on, NULL if none
+ *          psreq - request
+ *          psrep - receives reply
+ *
+ *      Exit
+ *          Returns FALSE if request is SOP_QUIT, else TRUE.
+ */
+BOOL ServerRequest(PPIPE ppipe, PSREQUEST psreq, PSREPLY psrep)
+{
+    CODE    code;
+    int     i;
+    PACKED  pk;
+    PSESSION pses;
+    RESULT  res;
+
+    psrep->op = psreq->op;
+    psrep->err = SERR_NONE;
+    psrep->cPosition = 0;
+    psrep->cColor = 0;
+    psrep->id = psreq->id;
+
+    switch (psreq->op) {
+
+    case SOP_NEW:
+	pses = SessionNew(ppipe);
+	if (pses == NULL)
+	    psrep->err = SERR_FULL;
+	else
+	    psrep->id = pses->id;
+	break;
+
+    case SOP_GUESS:                     // ServerBatch sends runs of
+	pses = SessionFind(psreq->id);  // these to ServerGuesses
+	if (pses == NULL) {
+	    psrep->err = SERR_SESSION;
+	    break;
+	}
+	for (i=0; i<nPeg; i++) {
+	    if (psreq->apeg[i] >= nColor) {
+		psrep->err = SERR_GUESS;
+		return TRUE;
+	    }
+	    code.apeg[i] = psreq->apeg[i];
+	}
+	if (pses->fOver) {
+	    psrep->err = SERR_OVER;
+	    break;
+	}
+	PackCode(&g.bd,&code,&pk);
+	res = ScorePacked(&g.bd,&pk,&pses->pkCode);
+	psrep->cPosition = g.bd.mpResultToPos[res];
+	psrep->cColor = g.bd.mpResultToClr[res];
+	pses->cGuess++;
+	pses->fOver = (res == g.bd.resWin) || (pses->cGuess == maxMove);
+	break;
+
+    case SOP_END:
+	pses = SessionFind(psreq->id);
+	if (pses == NULL)
+	    psrep->err = SERR_SESSION;
+	else
+	    SessionEnd(pses);
+	break;
+
+    case SOP_QUIT:
+	return FALSE;
+
+    default:
+	psrep->err = SERR_OP;
+	break;
+    }
+    return TRUE;
+}
+
+
+/***    SessionEnd - End a server session
+ *
+ *      Entry
+ *          pses - session
+ *
+ *      Exit
+ *          Session freed; its slot is free.
+ */
+VOID SessionEnd(PSESSION pses)
+{
+    DWORD   i = pses->id & ((1L << cbitSession) - 1);
+
+    if (pses->ppsesPrev != NULL) {      // Unlink from its pipe
+	*pses->ppsesPrev = pses->psesNext;
+	if (pses->psesNext != NULL)
+	    pses->psesNext->ppsesPrev = pses->ppsesPrev;
+    }
+    g.apses[i] = NULL;
+    g.aiSesFree[g.ciSesFree++] = i;
+    PoolFree(&g.poolSession,pses);
+}
+
+
+/***    SessionFind - Find a server session by id
+ *
+ *      Entry
+ *          id - session id from client
+ *
+ *      Exit
+ *          Returns session, or NULL if id is not a live session.
+ */
+PSESSION SessionFind(DWORD id)
+{
+    DWORD   i = id & ((1L << cbitSession) - 1);
+    PSESSION pses;
+
+    if (i >= maxSession)
+	return NULL;
+    pses = g.apses[i];
+    if ((pses == NULL) || (pses->id != id))  // Free, or reused slot
+	return NULL;
+    return pses;
+}
+
+
+/***    SessionNew - Start a server session with a new code
+ *
+ *      Entry
+ *          ppipe - pipe of client starting it, NULL if none
+ *
+ *      Exit-Success
+ *          Returns session.
+ *
+ *      Exit-Failure
+ *          Returns NULL; too many sessions, or out of memory.
+ */
+PSESSION SessionNew(PPIPE ppipe)
+{
+    DWORD   i;
+    PSESSION pses;
+
+    if (g.ciSesFree == 0)
+	return NULL;
+    pses = PoolAlloc(&g.poolSession);
+    if (pses == NULL)
+	return NULL;
+
+    i = g.aiSesFree[--g.ciSesFree];
+    g.apses[i] = pses;
+    pses->id = (++g.genSession << cbitSession) | i;
+    RandomCode(&g.bd,&pses->code);
+    PackCode(&g.bd,&pses->code,&pses->pkCode);
+    pses->iCode = RankCode(&g.bdServer,&pses->code);
+    pses->cGuess = 0;
+    pses->fOver = FALSE;
+    pses->stampBatch = 0;               // Batch stamps start at 1
+
+    pses->psesNext = NULL;              // Ended with pipe's client
+    pses->ppsesPrev = NULL;
+    if (ppipe != NULL) {
+	pses->psesNext = ppipe->pses;
+	if (pses->psesNext != NULL)
+	    pses->psesNext->ppsesPrev = &pses->psesNext;
+	pses->ppsesPrev = &ppipe->pses;
+	ppipe->pses = pses;
+    }
+    return pses;
+}
+
+
+/***    SetAnd - Keep only codes in a CODESET also in another CODESET
+ *
+ *      Entry
+ *          pcs      - set
+ *          pcsOther - set of the same board
+ *
+ *      Exit-Success
+ *          Returns TRUE; pcs holds only the codes in both sets.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; out of memory.  pcs holds no codes.
+ *
+ *      See "Performance Notes (21)" above.
+ */
+BOOL SetAnd(PCODESET pcs, PCODESET pcsOther)
+{
+    ULONGLONG *aqw;             // Scratch for ChunkAnd
+    DWORD   i;
+    DWORD   iChunk;
+    DWORD   iKeep = 0;
+    DWORD   iOther = 0;
+    PCHUNK  pch;
+
+    aqw = malloc(cqwChunk*sizeof(ULONGLONG));
+    if (aqw == NULL) {
+	SetEnd(pcs);
+	return FALSE;
+    }
+
+    pcs->c = 0;
+    pcs->cb = 0;
+    for (iChunk=0; iChunk<pcs->cChunk; iChunk++) {
+	pch = &pcs->ach[iChunk];
+	while ((iOther < pcsOther->cChunk) &&
+	       (pcsOther->ach[iOther].iChunk < pch->iChunk))
+	    iOther++;
+	if ((iOther == pcsOther->cChunk) ||
+	    (pcsOther->ach[iOther].iChunk != pch->iChunk)) {
+	    ChunkFree(pch);             // Other set has none of these
+	    continue;
+	}
+	if (!ChunkAnd(pch,&pcsOther->ach[iOther],aqw)) {
+	    for (i=iChunk+1; i<pcs->cChunk; i++)
+		ChunkFree(&pcs->ach[i]);
+	    pcs->cChunk = iKeep;
+	    free(aqw);
+	    SetEnd(pcs);
+	    return FALSE;
+	}
+	if (pch->c == 0)                // Chunk is empty; drop it
+	    continue;
+	pcs->ach[iKeep++] = *pch;
+	pcs->c += pch->c;
+	pcs->cb += cbChunk(pch);
+    }
+    pcs->cChunk = iKeep;
+    free(aqw);
+    return TRUE;
+}
+
+
+/***    SetBegin - Start a CODESET holding every code
+ *
+ *      Entry
+ *          pcs - set
+ *          pbd - board; codes need not be listed
+ *
+ *      Exit-Success
+ *          Returns TRUE; pcs holds every code, a run per chunk.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; too many codes to index, or out of memory.
+ *
+ *      See "Performance Notes (21)" above.
+ */
+BOOL SetBegin(PCODESET pcs, PBOARD pbd)
+{
+    DWORD   i;
+    PCHUNK  pch;
+
+    memset(pcs,0,sizeof(CODESET));
+    if (pbd->cCode == 0)
+	return FALSE;
+    pcs->ach = calloc((pbd->cCode+cChunkCode-1) >> cbitChunk,sizeof(CHUNK));
+    if (pcs->ach == NULL)
+	return FALSE;
+
+    for (i=0; i<pbd->cCode; i+=cChunkCode) {
+	pch = &pcs->ach[pcs->cChunk++];
+	pch->iChunk = i >> cbitChunk;
+	pch->ct = CT_RUN;
+	pch->c = min(cChunkCode,pbd->cCode - i);
+	pch->cw = 2;
+	pch->aw = malloc(2*sizeof(WORD));
+	if (pch->aw == NULL) {
+	    SetEnd(pcs);
+	    return FALSE;
+	}
+	pch->aw[0] = 0;
+	pch->aw[1] = (WORD)(pch->c - 1);
+	pcs->cb += sizeof(CHUNK) + 2*sizeof(WORD);
+    }
+    pcs->c = pbd->cCode;
+    return TRUE;
+}
+
+
+/***    SetEnd - Free a CODESET
+ *
+ */
+VOID SetEnd(PCODESET pcs)
+{
+    DWORD   i;
+
+    for (i=0; i<pcs->cChunk; i++)
+	ChunkFree(&pcs->ach[i]);
+    free(pcs->ach);
+    memset(pcs,0,sizeof(CODESET));
+}
+
+
+/***    SetFilter - Keep only codes in a CODESET consistent with a guess
+ *
+ *      Entry
+ *          pcs      - set
+ *          pbd      - board the set is of
+ *          ppkGuess - guess
+ *          res      - RESULT of guess
+ *
+ *      Exit-Success
+ *          Returns TRUE; pcs holds only the codes for which the guess
+ *          gets res, each chunk in its smallest form.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; out of memory.  pcs holds no codes.
+ *
+ *      See "Performance Notes (21)" above.
+ */
+BOOL SetFilter(PCODESET pcs, PBOARD pbd, PCPACKED ppkGuess, RESULT res)
+{
+    ULONGLONG *aqw;             // Chunk being filtered, as a bitmap
+    ULONGLONG *aqwRes;          // Its codes by RESULT, from ChunkScore
+    DWORD   i;
+    DWORD   iChunk;
+    DWORD   iKeep = 0;
+    DWORD   iq;
+    PCHUNK  pch;
+
+    aqw = malloc((1 + pbd->cResult)*cqwChunk*sizeof(ULONGLONG));
+    if (aqw == NULL) {
+	SetEnd(pcs);
+	return FALSE;
+    }
+    aqwRes = &aqw[cqwChunk];
+
+    pcs->c = 0;
+    pcs->cb = 0;
+    for (iChunk=0; iChunk<pcs->cChunk; iChunk++) {
+	pch = &pcs->ach[iChunk];
+	ChunkSpread(pch,aqw);
+	ChunkFree(pch);
+	ChunkScore(pbd,pch->iChunk,aqw,ppkGuess,aqwRes);
+	pch->c = 0;
+	for (iq=0; iq<cqwChunk; iq++)
+	    pch->c += CountLanes(aqwRes[res*cqwChunk + iq]);
+	if (pch->c == 0)                // Chunk is empty; drop it
+	    continue;
+	if (!ChunkPack(pch,&aqwRes[res*cqwChunk])) { // Free chunks kept
+	    for (i=iChunk+1; i<pcs->cChunk; i++)     //  and not done
+		ChunkFree(&pcs->ach[i]);
+	    pcs->cChunk = iKeep;
+	    free(aqw);
+	    SetEnd(pcs);
+	    return FALSE;
+	}
+	pcs->ach[iKeep++] = *pch;
+	pcs->c += pch->c;
+	pcs->cb += cbChunk(pch);
+    }
+    pcs->cChunk = iKeep;
+    free(aqw);
+    return TRUE;
+}
+
+
+/***    SetFirst - Get lowest code in a CODESET
+ *
+ *      Entry
+ *          pcs - set
+ *
+ *      Exit
+ *          Returns index of lowest code, iCodeNone if set is empty.
+ */
+DWORD SetFirst(PCODESET pcs)
+{
+    DWORD   i;
+    PCHUNK  pch;
+
+    if (pcs->cChunk == 0)
+	return iCodeNone;
+    pch = &pcs->ach[0];
+    if (pch->ct != CT_BITMAP)           // First offset, or start of run
+	return (pch->iChunk << cbitChunk) + pch->aw[0];
+    for (i=0; pch->aqw[i] == 0; i++)    // Chunk never empty
+	;
+    return (pch->iChunk << cbitChunk) + i*64 +
+	   CountLanes((pch->aqw[i] & (~pch->aqw[i]+1)) - 1);
+}
+
+
+/***    SetMouse - Capture mouse and set ClipCursor area
+ *
+ *	Entry
+ *	    hwnd - window handle of main window
+ */
+VOID SetMouse(HWND hwnd)
+{
+    RECT    rc;
+
+    if (g.fReplay)                  // Leave real mouse alone in replay
+	return;
+
+    SetCapture(hwnd);               // Capture that mouse
+
+    rc.left   = xCursorLeft;
+    rc.top    = yCursorTop;
+    rc.right  = xCursorRight;
+    rc.bottom = yCursorBottom;
+
+    ClientToScreen(hwnd,(NPPOINT)(&rc)); // Convert left,top coordinates
+    ClientToScreen(hwnd,&(((NPPOINT)(&rc))[1])); // Convert right,bottom
+
+    ClipCursor(&rc);                // Restrict mouse movements
+}
+
+
+/***    SetPartition - Split a CODESET by the RESULT a guess gets
+ *
+ *      Entry
+ *          pcs      - set
+ *          pbd      - board the set is of
+ *          ppkGuess - guess
+ *          acsPart  - receives pbd->cResult sets
+ *
+ *      Exit-Success
+ *          Returns TRUE; acsPart[res] holds the codes of pcs for which
+ *          the guess gets res.  pcs is as it was.
+ *
+ *      Exit-Failure
+ *          Returns FALSE; out of memory.  acsPart hold no codes.
+ *
+ *      Each code is scored once, where a SetFilter for each RESULT
+ *      would score it pbd->cResult times.
+ *      See "Performance Notes (21)" above.
+ */
+BOOL SetPartition(PCODESET pcs, PBOARD pbd, PCPACKED ppkGuess,
+		  PCODESET acsPart)
+{
+    ULONGLONG *aqw;             // Chunk being split, as a bitmap
+    ULONGLONG *aqwRes;          // Its codes by RESULT, from ChunkScore
+    CHUNK   ch;
+    DWORD   iChunk;
+    DWORD   iq;
+    PCODESET pcsPart;
+    int     res;
+
+    memset(acsPart,0,pbd->cResult*sizeof(CODESET));
+    aqw = malloc((1 + pbd->cResult)*cqwChunk*sizeof(ULONGLONG));
+    if (aqw == NULL)
+	return FALSE;
+    aqwRes = &aqw[cqwChunk];
+    for (res=0; res<pbd->cResult; res++) {
+	acsPart[res].ach = malloc(max(pcs->cChunk,1)*sizeof(CHUNK));
+	if (acsPart[res].ach == NULL)
+	    goto Error;
+    }
+
+    for (iChunk=0; iChunk<pcs->cChunk; iChunk++) {
+	ChunkSpread(&pcs->ach[iChunk],aqw);
+	ChunkScore(pbd,pcs->ach[iChunk].iChunk,aqw,ppkGuess,aqwRes);
+	for (res=0; res<pbd->cResult; res++) {
+	    memset(&ch,0,sizeof(CHUNK));
+	    ch.iChunk = pcs->ach[iChunk].iChunk;
+	    for (iq=0; iq<cqwChunk; iq++)
+		ch.c += CountLanes(aqwRes[res*cqwChunk + iq]);
+	    if (ch.c == 0)
+		continue;
+	    if (!ChunkPack(&ch,&aqwRes[res*cqwChunk]))
+		goto Error;
+	    pcsPart = &acsPart[res];
+	    pcsPart->ach[pcsPart->cChunk++] = ch;
+	    pcsPart->c += ch.c;
+	    pcsPart->cb += cbChunk(&ch);
+	}
+    }
+    free(aqw);
+    return TRUE;
+
+Error:
+    for (res=0; res<pbd->cResult; res++)
+	SetEnd(&acsPart[res]);
+    free(aqw);
+    return FALSE;
+}
+
+
+/***    SliceCodes - Slice codes for ScoreSliced
+ *
+ *      Entry
+ *          pbd    - board, with codes listed
+ *          aiCode - indexes of codes to slice
+ *          c      - count of codes
+ *          aqw    - receives (c+cLaneSlice-1)/cLaneSlice slices, each
+ *                   cqwSlice(pbd) ULONGLONGs
+ *
+ *      Exit
+ *          Code aiCode[i] is lane i%cLaneSlice of slice i/cLaneSlice.
+ *          Lanes past c are empty.
+ */
+VOID SliceCodes(PBOARD pbd, DWORD *aiCode, DWORD c, ULONGLONG *aqw)
+{
+    DWORD   i;
+    int     iPeg;
+    PCCODE  pcode;
+    ULONGLONG *pqw;             // Slice for code i
+
+    memset(aqw,0,(c+cLaneSlice-1)/cLaneSlice*cqwSlice(pbd)*sizeof(ULONGLONG));
+    for (i=0; i<c; i++) {
+	pqw = &aqw[i/cLaneSlice*cqwSlice(pbd)];
+	pcode = &pbd->acode[aiCode[i]];
+	for (iPeg=0; iPeg<pbd->cPeg; iPeg++)
+	    pqw[iPeg*pbd->cColor + pcode->apeg[iPeg]] |=
+		(ULONGLONG)1 << (i % cLaneSlice);
+    }
+}
+
+
+/***    SolveCode - Solve a code, always guessing the first candidate left
+ *
+ *      Entry
+ *          pbd      - board, with codes listed
+ *          iSecret  - index of code to find
+ *          aiWork   - room for pbd->cCode candidates
+ *
+ *      Exit
+ *          Returns number of guesses needed.
+ */
+int SolveCode(PBOARD pbd, DWORD iSecret, DWORD *aiWork)
+{
+    DWORD   c;
+    int     cGuess = 0;
+    DWORD   iGuess;
+    RESULT  res;
+
+    for (c=0; c<pbd->cCode; c++)
+	aiWork[c] = c;
+
+    for (;;) {
+	iGuess = aiWork[0];     // First code still consistent
+	cGuess++;
+	if (pbd->presTable != NULL) {
+	    res = ScoreTable(pbd,iGuess,iSecret);
+	    if (res == pbd->resWin)
+		return cGuess;
+	    c = FilterCodesTable(pbd,aiWork,c,iGuess,res);
+	}
+	else {
+	    res = ScorePacked(pbd,&pbd->apacked[iGuess],
+			      &pbd->apacked[iSecret]);
+	    if (res == pbd->resWin)
+		return cGuess;
+	    if (pbd->pff != NULL)
+		c = FilterCodesFeed(pbd,aiWork,c,iGuess,res);
+	    else
+		c = FilterCodes(pbd,aiWork,c,&pbd->apacked[iGuess],res);
+	}
+    }
+}
+
+
+/***    SolveCodeSet - SolveCode for a board too big to list
+ *
+ *      Entry
+ *          pbd     - board; codes need not be listed
+ *          iSecret - index of code to find
+ *          pcs     - room for a CODESET
+ *          pcbMax  - receives most bytes the set took
+ *
+ *      Exit
+ *          Returns number of guesses needed, always guessing the lowest
+ *          code left; 0 if out of memory.
+ */
+int SolveCodeSet(PBOARD pbd, DWORD iSecret, PCODESET pcs, DWORD *pcbMax)
+{
+    CODE    code;
+    int     cGuess = 0;
+    PACKED  pkGuess;
+    PACKED  pkSecret;
+    RESULT  res;
+
+    UnrankCode(pbd,iSecret,&code);
+    PackCode(pbd,&code,&pkSecret);
+    if (!SetBegin(pcs,pbd))
+	return 0;
+    *pcbMax = pcs->cb;
+
+    for (;;) {
+	UnrankCode(pbd,SetFirst(pcs),&code);
+	PackCode(pbd,&code,&pkGuess);
+	cGuess++;
+	res = ScorePacked(pbd,&pkGuess,&pkSecret);
+	if (res == pbd->resWin)
+	    break;
+	if (!SetFilter(pcs,pbd,&pkGuess,res))
+	    return 0;
+	*pcbMax = max(*pcbMax,pcs->cb);
+    }
+    SetEnd(pcs);
+    return cGuess;
+}
+
+
+/***    SolveCodeStream - SolveCodeSet, streaming the codes for each guess
+ *
+ *      Entry
+ *          pbd     - board; codes need not be listed
+ *          iSecret - index of code to find
+ *
+ *      Exit
+ *          Returns number of guesses needed, always guessing the lowest
+ *          code left; 0 if not found in maxMove guesses.
+ *          See "Performance Notes (22)" above.
+ */
+int SolveCodeStream(PBOARD pbd, DWORD iSecret)
+{
+    SMOVE   asmove[maxMove];    // Guesses so far
+    CODE    code;
+    int     cMove;
+    DWORD   iGuess;
+    PACKED  pkGuess;
+    PACKED  pkSecret;
+    RESULT  res;
+
+    UnrankCode(pbd,iSecret,&code);
+    PackCode(pbd,&code,&pkSecret);
+    memset(asmove,0,sizeof(asmove));
+
+    for (cMove=0; cMove<maxMove; cMove++) {
+	iGuess = iCodeNone;
+	StreamCodes(pbd,asmove,cMove,StreamFirst,&iGuess);
+	if (iGuess == iCodeNone)        // Cannot happen; secret always fits
+	    break;
+	UnrankCode(pbd,iGuess,&code);
+	PackCode(pbd,&code,&pkGuess);
+	res = ScorePacked(pbd,&pkGuess,&pkSecret);
+	if (res == pbd->resWin)
+	    return cMove+1;
+	memcpy(asmove[cMove].apeg,code.apeg,pbd->cPeg);
+	asmove[cMove].cPosition = pbd->mpResultToPos[res];
+	asmove[cMove].cColor = pbd->mpResultToClr[res];
+    }
+    return 0;
+}
+
+
+/***    SpecFree - Free speculation work space
+ *
+ */
+VOID SpecFree(VOID)
+{
+    free(g.spec.aiCode);
+    free(g.spec.aiGuess);
+    free(g.spec.acPart);
+    free(g.spec.ares);
+    g.spec.aiCode = NULL;
+    g.spec.aiGuess = NULL;
+    g.spec.acPart = NULL;
+    g.spec.ares = NULL;
+    g.spec.iMove = -1;
+}
+
+
+/***    SpecStart - Start speculating on the guess in the play row
+ *
+ *      Exit
+ *          SpecThread started on g.spec, or run right here during replay
+ *          so every replay speculates the same.  If memory is short, no
+ *          speculation is done.
+ *
+ *      See "Performance Notes (16)" above.
+ */
+VOID SpecStart(VOID)
+{
+    DWORD   iBest;
+    unsigned idThread;
+    PSPEC   pspec = &g.spec;
+
+    SpecStop();                         // Row has changed
+
+    if (pspec->aiCode == NULL) {
+	pspec->aiCode = malloc(g.bd.cCode*sizeof(DWORD));
+	pspec->aiGuess = malloc(g.bd.cCode*sizeof(DWORD));
+	pspec->acPart = malloc(g.bd.cCode*g.bd.cResult*sizeof(DWORD));
+	pspec->ares = malloc(g.bd.cCode*sizeof(RESULT));
+	if ((pspec->aiCode == NULL) || (pspec->aiGuess == NULL) ||
+	    (pspec->acPart == NULL) || (pspec->ares == NULL)) {
+	    SpecFree();
+	    return;
+	}
+    }
+
+    // May use what was speculated for the last move
+    pspec->c = FitCodes(pspec->aiCode,&iBest);
+    pspec->iMove = GameMoves(pspec->asmove);
+    pspec->fGrouped = FALSE;
+    pspec->gen = g.genSpec;
+
+    if (g.fReplay) {
+	SpecThread(pspec);
+	return;
+    }
+    g.hthSpec = (HANDLE)_beginthreadex(NULL,0,SpecThread,pspec,0,&idThread);
+    if (g.hthSpec == NULL)
+	pspec->iMove = -1;              // Nothing speculated
+}
+
+
+/***    SpecStop - Stop speculating
+ *
+ *      Exit
+ *          SpecThread is gone.  g.spec keeps whatever it had finished.
+ */
+VOID SpecStop(VOID)
+{
+    InterlockedIncrement(&g.genSpec);
+    if (g.hthSpec != NULL) {            // Quits at its next check
+	WaitForSingleObject(g.hthSpec,INFINITE);
+	CloseHandle(g.hthSpec);
+	g.hthSpec = NULL;
+    }
+}
+
+
+/***    SpecThread - Work out every RESULT the play row could get
+ *
+ *      Entry
+ *          pv - g.spec, with codes that fit the moves so far
+ *
+ *      Exit
+ *          Returns 0.  Codes grouped by RESULT for the guess, and the best
+ *          next guess found for each RESULT, most likely first, until
+ *          SpecStop.
+ */
+unsigned __stdcall SpecThread(void *pv)
+{
+    CODE    code;
+    DWORD   iBest;
+    PACKED  pk;
+    PSMOVE  psmove;             // Play row
+    PSPEC   pspec = pv;
+    int     res;
+    int     resNext;
+
+    // Group codes by RESULT
+    psmove = &pspec->asmove[pspec->iMove];
+    memcpy(code.apeg,psmove->apeg,g.bd.cPeg);
+    PackCode(&g.bd,&code,&pk);
+    GroupCodes(&g.bd,pspec->aiCode,pspec->c,&pk,pspec->ares,pspec->aiFirst,
+	       pspec->ac);
+    for (res=0; res<g.bd.cResult; res++)
+	pspec->aiBest[res] = iCodeNone;
+    pspec->fGrouped = TRUE;
+
+    // Best next guess for each RESULT, biggest group first
+    while (pspec->gen == g.genSpec) {
+	resNext = -1;
+	for (res=0; res<g.bd.cResult; res++)
+	    if ((res != g.bd.resWin) && (pspec->ac[res] > 0) &&
+		(pspec->aiBest[res] == iCodeNone) &&
+		((resNext < 0) || (pspec->ac[res] > pspec->ac[resNext])))
+		resNext = res;
+	if (resNext < 0)                // All done
+	    break;
+	psmove->cPosition = g.bd.mpResultToPos[resNext];
+	psmove->cColor = g.bd.mpResultToClr[resNext];
+	iBest = BookGuess(&g.bk,&g.bd,pspec->asmove,pspec->iMove+1);
+	if (iBest == iCodeNone)         // Out of the Opening Book
+	    iBest = ChooseGuess(&g.bd,&pspec->aiCode[pspec->aiFirst[resNext]],
+				pspec->ac[resNext],pspec->aiGuess,
+				pspec->acPart);
+	pspec->aiBest[resNext] = iBest;
+    }
+    return 0;
+}
+
+
+/***    StaticBoard - Find fewest guesses for one board
+ *
+ *      Entry
+ *          pbsz - board size
+ *          psz  - receives a report line
+ *
+ *      Exit
+ *          Returns characters written to psz.  The line gives the board,
+ *          how many codes it has, the fewest guesses found and whether
+ *          the search finished (so none fewer will do), the ms taken,
+ *          sets of guesses tried, and the guesses.
+ *
+ *      Starts from a greedy set of guesses, then searches on threads for
+ *      smaller ones.  See "Performance Notes (25)" above.
+ */
+int StaticBoard(PBOARDSIZE pbsz, char *psz)
+{
+    HANDLE  ahThread[maxStaticThread];
+    BOARD   bd;
+    DWORD   c;
+    DWORD   cClass;
+    DWORD   cThread;
+    DWORD   cTry;
+    int     i;
+    unsigned idThread;
+    DWORD   iCode;
+    int     iPeg;
+    DWORD   ms;
+    char   *pszStart = psz;
+    STATICJOB stj;
+    STATICWORK sw;
+    SYSTEM_INFO si;
+
+    psz += sprintf(psz,"%dx%d%s\t",pbsz->cColor,pbsz->cPeg,
+		   pbsz->fDup ? "" : "u");
+    memset(&stj,0,sizeof(STATICJOB));
+    memset(&sw,0,sizeof(STATICWORK));
+    if (!BoardBegin(&bd,pbsz->cPeg,pbsz->cColor,pbsz->fDup,TRUE))
+	return sprintf(psz,"-\tbad board\n") + (psz - pszStart);
+    if ((bd.acode == NULL) || (bd.cCode > maxCodeTable) ||
+	!BoardTable(&bd) || (bd.presTable == NULL)) {
+	psz += sprintf(psz,"%lu\ttoo many codes\n",(unsigned long)bd.cCode);
+	goto Done;
+    }
+    stj.pbd = &bd;
+    stj.msStart = GetTickCount();
+
+    // First guesses: one code for each way of repeating colors
+    stj.aiFirst = malloc(bd.cCode*sizeof(DWORD));
+    if (!StaticWorkBegin(&stj,&sw) || (stj.aiFirst == NULL)) {
+	psz += sprintf(psz,"%lu\tout of memory\n",(unsigned long)bd.cCode);
+	goto Done;
+    }
+    for (iCode=0; iCode<bd.cCode; iCode++)
+	if (StaticCanonical(&bd,&bd.acode[iCode]))
+	    stj.aiFirst[stj.cFirst++] = iCode;
+
+    // Greedy: add the guess making the most classes until all are one code
+    cClass = 1;
+    memset(sw.aaiClass,0,bd.cCode*sizeof(DWORD));
+    while ((cClass < bd.cCode) && (stj.cBest < maxStaticGuess)) {
+	for (iCode=0, c=0; iCode<bd.cCode; iCode++)
+	    if ((cTry = StaticRefine(&sw,stj.cBest,iCode,FALSE)) > c) {
+		c = cTry;
+		stj.aiBest[stj.cBest] = iCode;
+	    }
+	StaticRefine(&sw,stj.cBest,stj.aiBest[stj.cBest],FALSE);
+	cClass = c;
+	stj.cBest++;
+    }
+    if (cClass < bd.cCode) {            // Some codes alike for any guess
+	psz += sprintf(psz,"%lu\tno set tells codes apart\n",
+		       (unsigned long)bd.cCode);
+	goto Done;
+    }
+
+    // Then search for fewer, a thread per processor
+    InitializeCriticalSection(&stj.cs);
+    GetSystemInfo(&si);
+    for (cThread=0;
+	 (cThread < si.dwNumberOfProcessors-1) &&
+	 (cThread < maxStaticThread);
+	 cThread++) {
+	ahThread[cThread] = (HANDLE)_beginthreadex(NULL,0,StaticThread,
+						   &stj,0,&idThread);
+	if (ahThread[cThread] == NULL)
+	    break;
+    }
+    StaticThread(&stj);                 // This thread helps too
+    if (cThread != 0) {
+	WaitForMultipleObjects(cThread,ahThread,TRUE,INFINITE);
+	while (cThread-- > 0)
+	    CloseHandle(ahThread[cThread]);
+    }
+    ms = GetTickCount() - stj.msStart;
+
+    psz += sprintf(psz,"%lu\t%d\t%s\t%lu\t%.0f\t",(unsigned long)bd.cCode,
+		   stj.cBest,stj.fAbort ? "no" : "yes",(unsigned long)ms,
+		   stj.cNode);
+    for (i=0; i<stj.cBest; i++) {
+	for (iPeg=0; iPeg<bd.cPeg; iPeg++)
+	    *psz++ = "0123456789ABCDEF"[bd.acode[stj.aiBest[i]].apeg[iPeg]];
+	*psz++ = (i < stj.cBest-1) ? ' ' : '\n';
+    }
+    *psz = '\0';
+    DeleteCriticalSection(&stj.cs);
+
+Done:
+    StaticWorkEnd(&sw);
+    free(stj.aiFirst);
+    BoardEnd(&bd);
+    return psz - pszStart;
+}
+
+
+/***    StaticCanonical - See if a code is the one first guesses stand for
+ *
+ *      Entry
+ *          pbd   - board
+ *          pcode - code
+ *
+ *      Exit
+ *          Returns TRUE if the pegs are in color order, and each color
+ *          is used no less than the next one.
+ *
+ *      Changing colors or moving pegs maps any set of guesses that tells
+ *      codes apart to another that does, so some set of fewest guesses
+ *      holds one of these codes.
+ */
+BOOL StaticCanonical(PBOARD pbd, PCCODE pcode)
+{
+    BYTE    acClr[maxColorBoard];
+    int     iClr;
+    int     iPeg;
+
+    memset(acClr,0,sizeof(acClr));
+    for (iPeg=0; iPeg<pbd->cPeg; iPeg++) {
+	if ((iPeg > 0) && (pcode->apeg[iPeg] < pcode->apeg[iPeg-1]))
+	    return FALSE;
+	acClr[pcode->apeg[iPeg]]++;
+    }
+    for (iClr=1; iClr<pbd->cColor; iClr++)
+	if (acClr[iClr] > acClr[iClr-1])
+	    return FALSE;
+    return TRUE;
+}
+
+
+/***    StaticFound - Keep a set of guesses that tells every code apart
+ *
+ *      Entry
+ *          psw    - thread's work
+ *          cGuess - guesses in psw->aiGuess
+ *
+ *      Exit
+ *          If fewer than any set found so far, they are kept in aiBest
+ *          and cBest, so every thread looks only for fewer.
+ */
+VOID StaticFound(PSTATICWORK psw, int cGuess)
+{
+    PSTATICJOB pstj = psw->pstj;
+
+    EnterCriticalSection(&pstj->cs);
+    if (cGuess < pstj->cBest) {
+	memcpy(pstj->aiBest,psw->aiGuess,cGuess*sizeof(DWORD));
+	pstj->cBest = cGuess;
+    }
+    LeaveCriticalSection(&pstj->cs);
+}
+
+
+/***    StaticRefine - Split the classes of codes by one more guess
+ *
+ *      Entry
+ *          psw    - thread's work; classes after cGuess guesses in
+ *                   aaiClass[cGuess]
+ *          cGuess - guesses so far
+ *          iGuess - next guess
+ *          fAll   - TRUE => only a guess that tells every code apart
+ *                   will do
+ *
+ *      Exit
+ *          Returns count of classes after iGuess; aaiClass[cGuess+1]
+ *          holds each code's class, acSize the codes in each.
+ *          Returns 0 if fAll and two codes are still in one class.
+ *
+ *      Codes are in one class while every guess gets the same RESULT
+ *      from them.  A code's class and RESULT index a table directly, as
+ *      a hash with no collisions, giving its new class.  Stamps mark the
+ *      entries set for this call, so the table is never cleared.
+ */
+DWORD StaticRefine(PSTATICWORK psw, int cGuess, DWORD iGuess, BOOL fAll)
+{
+    DWORD  *aiClass;            // Classes before iGuess
+    DWORD  *aiClassNew;         // Classes after
+    PBOARD  pbd = psw->pstj->pbd;
+    DWORD   c = 0;
+    DWORD   iCode;
+    DWORD   iKey;
+    const RESULT *pres;
+
+    aiClass = &psw->aaiClass[cGuess*pbd->cCode];
+    aiClassNew = aiClass + pbd->cCode;
+    pres = &ScoreTable(pbd,iGuess,0);
+    psw->stamp++;
+    for (iCode=0; iCode<pbd->cCode; iCode++) {
+	iKey = aiClass[iCode]*pbd->cResult + pres[iCode];
+	if (psw->aStamp[iKey] != psw->stamp) { // New class
+	    psw->aStamp[iKey] = psw->stamp;
+	    psw->aiKeyClass[iKey] = c;
+	    psw->acSize[c++] = 0;
+	}
+	else if (fAll)                  // Two codes still alike
+	    return 0;
+	aiClassNew[iCode] = psw->aiKeyClass[iKey];
+	psw->acSize[aiClassNew[iCode]]++;
+    }
+    return c;
+}
+
+
+/***    StaticSearch - Look for fewer guesses that tell every code apart
+ *
+ *      Entry
+ *          psw       - thread's work; aiGuess[0..cGuess-1] guessed, and
+ *                      their classes in aaiClass[cGuess]
+ *          cGuess    - guesses so far
+ *          iGuessMin - lowest code to guess next
+ *
+ *      Exit
+ *          Every set of guesses from aiGuess, adding codes from
+ *          iGuessMin on in order, has been tried, or pruned since it
+ *          cannot beat cBest; or time ran out (fAbort).
+ *
+ *      A guess that splits no class is never needed.  With r guesses
+ *      left, a class of m codes becomes at most min(m,cResult^r), so if
+ *      that sum over classes is short of every code, none will do.
+ */
+VOID StaticSearch(PSTATICWORK psw, int cGuess, DWORD iGuessMin)
+{
+    DWORD   c;
+    DWORD   cCan;               // Most classes the guesses left can make
+    DWORD   cClass;
+    DWORD   cSplit;             // cResult^r, or more than any class
+    DWORD   iClass;
+    DWORD   iGuess;
+    int     r;
+    PSTATICJOB pstj = psw->pstj;
+    PBOARD  pbd = pstj->pbd;
+
+    cClass = psw->acClass[cGuess];
+    for (iGuess=iGuessMin; iGuess<pbd->cCode; iGuess++) {
+	if ((cGuess+1 >= pstj->cBest) || pstj->fAbort) // Cannot do better
+	    return;
+	if (iGuess == psw->aiGuess[0])
+	    continue;
+	if ((++psw->cNode % cNodeStatic == 0) &&
+	    (GetTickCount() - pstj->msStart >= msStaticBudget))
+	    pstj->fAbort = TRUE;
+
+	r = pstj->cBest-1 - (cGuess+1); // Guesses left after this one
+	c = StaticRefine(psw,cGuess,iGuess,r == 0);
+	if (c <= cClass)                // Splits nothing, or not enough
+	    continue;
+	psw->aiGuess[cGuess] = iGuess;
+	if (c == pbd->cCode) {
+	    StaticFound(psw,cGuess+1);
+	    return;                     // Siblings are no fewer
+	}
+	if (r == 0)
+	    continue;
+
+	for (cSplit=1; (r > 0) && (cSplit < pbd->cCode); r--)
+	    cSplit *= pbd->cResult;
+	for (iClass=0, cCan=0; iClass<c; iClass++)
+	    cCan += min(psw->acSize[iClass],cSplit);
+	if (cCan < pbd->cCode)
+	    continue;
+	psw->acClass[cGuess+1] = c;
+	StaticSearch(psw,cGuess+1,iGuess+1);
+    }
+}
+
+
+/***    StaticSolve - Find fewest guesses that tell every code apart
+ *
+ *      Entry
+ *          g.bszStatic - board; cPeg 0 => each board in abszStatic
+ *          g.pszStaticReport - report file, NULL => message box
+ *
+ *      Exit
+ *          Returns TRUE; report written, a line for each board.
+ *          Returns FALSE if report file could not be written.
+ *
+ *      See "Performance Notes (25)" above.
+ */
+BOOL StaticSolve(VOID)
+{
+    char    ach[(nBoardStatic+2)*cchStaticLine];
+    DWORD   cbWritten;
+    HANDLE  hcon;
+    int     i;
+    FILE   *pfile;
+    char   *psz;
+    char   *pszLine;
+
+    AllocConsole();                     // Fails harmlessly if we have one
+    hcon = GetStdHandle(STD_OUTPUT_HANDLE);
+    psz = ach;
+    psz += sprintf(psz,"Board\tCodes\tSize\tMinimal\tms\tSets\t"
+		       "Guesses\n");
+    for (i=0; i<nBoardStatic; i++) {
+	pszLine = psz;
+	if (g.bszStatic.cPeg != 0)
+	    psz += StaticBoard(&g.bszStatic,psz);
+	else
+	    psz += StaticBoard(&abszStatic[i],psz);
+	WriteFile(hcon,pszLine,strlen(pszLine),&cbWritten,NULL);
+	if (g.bszStatic.cPeg != 0)      // Just the board asked for
+	    break;
+    }
+
+    if (g.pszStaticReport == NULL) {
+	MessageBox(NULL,ach,"MasterMind Static",MB_OK);
+	return TRUE;
+    }
+    pfile = fopen(g.pszStaticReport,"w");
+    if (pfile == NULL) {
+	MessageBox(NULL,"Cannot create report file.","MasterMind",
+		   MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+    fputs(ach,pfile);
+    fclose(pfile);
+    return TRUE;
+}
+
+
+/***    StaticThread - Search sets of guesses until none are left
+ *
+ *      Entry
+ *          pv - STATICJOB
+ *
+ *      Exit
+ *          Returns 0; every first and second guess this thread took has
+ *          been searched.
+ *
+ *      Takes a first guess (from aiFirst) and a second (any other code)
+ *      at a time from a shared counter, and searches the rest in order
+ *      from the second on.  See "Performance Notes (25)" above.
+ */
+unsigned __stdcall StaticThread(void *pv)
+{
+    DWORD   c;
+    DWORD   iFirst = iCodeNone;         // aiFirst index of aiGuess[0]
+    DWORD   iJob;
+    PSTATICJOB pstj = pv;
+    PBOARD  pbd = pstj->pbd;
+    STATICWORK sw;
+
+    memset(&sw,0,sizeof(STATICWORK));
+    if (!StaticWorkBegin(pstj,&sw))
+	return 0;
+    memset(sw.aaiClass,0,pbd->cCode*sizeof(DWORD));
+    sw.acClass[0] = 1;
+    while (!pstj->fAbort && (pstj->cBest > 2) &&
+	   ((iJob = (DWORD)InterlockedIncrement(&pstj->iJobNext) - 1) <
+	    pstj->cFirst*pbd->cCode)) {
+	if (iJob / pbd->cCode != iFirst) {
+	    iFirst = iJob / pbd->cCode;
+	    sw.aiGuess[0] = pstj->aiFirst[iFirst];
+	    sw.acClass[1] = StaticRefine(&sw,0,sw.aiGuess[0],FALSE);
+	}
+	sw.aiGuess[1] = iJob % pbd->cCode;
+	if (sw.aiGuess[1] == sw.aiGuess[0])
+	    continue;
+	sw.cNode++;
+	c = StaticRefine(&sw,1,sw.aiGuess[1],pstj->cBest == 3);
+	if (c == pbd->cCode)
+	    StaticFound(&sw,2);
+	else if (c > sw.acClass[1]) {
+	    sw.acClass[2] = c;
+	    StaticSearch(&sw,2,sw.aiGuess[1]+1);
+	}
+    }
+    EnterCriticalSection(&pstj->cs);
+    pstj->cNode += sw.cNode;
+    LeaveCriticalSection(&pstj->cs);
+    StaticWorkEnd(&sw);
+    return 0;
+}
+
+
+/***    StaticWorkBegin - Get a thread's room to search in
+ *
+ *      Entry
+ *          pstj - job; board has codes listed
+ *          psw  - zeroed
+ *
+ *      Exit
+ *          Returns TRUE; psw ready for StaticRefine.
+ *          Returns FALSE if out of memory; psw freed.
+ */
+BOOL StaticWorkBegin(PSTATICJOB pstj, PSTATICWORK psw)
+{
+    DWORD   cCode = pstj->pbd->cCode;
+    DWORD   cKey = cCode*pstj->pbd->cResult;
+
+    psw->pstj = pstj;
+    psw->aaiClass = malloc((maxStaticGuess+1)*cCode*sizeof(DWORD));
+    psw->acSize = malloc(cCode*sizeof(DWORD));
+    psw->aiKeyClass = malloc(cKey*sizeof(DWORD));
+    psw->aStamp = calloc(cKey,sizeof(DWORD));
+    if ((psw->aaiClass == NULL) || (psw->acSize == NULL) ||
+	(psw->aiKeyClass == NULL) || (psw->aStamp == NULL)) {
+	StaticWorkEnd(psw);
+	return FALSE;
+    }
+    return TRUE;
+}
+
+
+/***    StaticWorkEnd - Free a thread's room to search in
+ *
+ */
+VOID StaticWorkEnd(PSTATICWORK psw)
+{
+    free(psw->aaiClass);
+    free(psw->acSize);
+    free(psw->aiKeyClass);
+    free(psw->aStamp);
+    memset(psw,0,sizeof(STATICWORK));
+}
+
+
+/***    StrategyLoad - Find the functions of a strategy
+ *
+ *      Entry
+ *          pstrat->pszName - plugin file, or name of a built-in strategy
+ *
+ *      Exit
+ *          Returns TRUE; pfnBegin, pfnGuess, pfnEnd filled in, and hmod
+ *              if it is a plugin.
+ *          Returns FALSE if plugin could not be loaded; user has been told.
+ */
+BOOL StrategyLoad(PSTRATEGY pstrat)
+{
+    char    ach[cbMaxPath+32];
+
+    if (strcmp(pstrat->pszName,"first") == 0) {
+	pstrat->pfnBegin = StratFirstBegin;
+	pstrat->pfnGuess = StratFirstGuess;
+	pstrat->pfnEnd = StratFirstEnd;
+	return TRUE;
+    }
+    if (strcmp(pstrat->pszName,"minimax") == 0) {
+	pstrat->pfnBegin = StratMinimaxBegin;
+	pstrat->pfnGuess = StratFirstGuess;
+	pstrat->pfnEnd = StratFirstEnd;
+	return TRUE;
+    }
+    if (strcmp(pstrat->pszName,"propagate") == 0) {
+	pstrat->pfnBegin = StratPropBegin;
+	pstrat->pfnGuess = StratPropGuess;
+	pstrat->pfnEnd = StratPropEnd;
+	return TRUE;
+    }
+    if (strcmp(pstrat->pszName,"genetic") == 0) {
+	pstrat->pfnBegin = StratGeneticBegin;
+	pstrat->pfnGuess = StratGeneticGuess;
+	pstrat->pfnEnd = StratGeneticEnd;
+	return TRUE;
+    }
+
+    pstrat->hmod = LoadLibrary(pstrat->pszName);
+    if (pstrat->hmod != NULL) {
+	pstrat->pfnBegin = (PFNSTRATBEGIN)GetProcAddress(pstrat->hmod,
+							 "StratBegin");
+	pstrat->pfnGuess = (PFNSTRATGUESS)GetProcAddress(pstrat->hmod,
+							 "StratGuess");
+	pstrat->pfnEnd = (PFNSTRATEND)GetProcAddress(pstrat->hmod,"StratEnd");
+    }
+    if ((pstrat->pfnBegin == NULL) || (pstrat->pfnGuess == NULL) ||
+	(pstrat->pfnEnd == NULL)) {
+	sprintf(ach,"Cannot load strategy %s.",pstrat->pszName);
+	MessageBox(NULL,ach,"MasterMind",MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+    return TRUE;
+}
+
+
+/***    StratFirstBegin - Start built-in strategy "first"
+ *
+ *      Entry
+ *          cPeg, cColor, fDup - board
+ *
+ *      Exit
+ *          Returns strategy state, or NULL if board is too big.
+ *
+ *      Boards with too many codes to list, but few enough to index,
+ *      keep the codes still consistent in a CODESET instead; see
+ *      StratFirstGuessSet.  See MMSTRAT.H.
+ */
+void * WINAPI StratFirstBegin(int cPeg, int cColor, BOOL fDup)
+{
+    PFIRSTSTATE pfs;
+
+    pfs = malloc(sizeof(FIRSTSTATE));
+    if (pfs == NULL)
+	return NULL;
+    memset(pfs,0,sizeof(FIRSTSTATE));
+    if ((g.tny.bd.acode != NULL) && (g.tny.bd.cPeg == cPeg) &&
+	(g.tny.bd.cColor == cColor) && (g.tny.bd.fDup == fDup))
+	BoardShare(&pfs->bd,&g.tny.bd); // Tournament board has it all
+    else if (!BoardBegin(&pfs->bd,cPeg,cColor,fDup,TRUE)) {
+	free(pfs);
+	return NULL;
+    }
+    if ((pfs->bd.acode == NULL) && (pfs->bd.cCode != 0)) {
+	pfs->fSet = TRUE;               // Too many to list; keep a CODESET
+	return pfs;
+    }
+    BoardTable(&pfs->bd);               // Use Feedback Table, if we can
+    if (g.tny.fSliced)                  // Score bit-sliced, if asked
+	BoardSlice(&pfs->bd);
+    pfs->aiCode = malloc(pfs->bd.cCode*sizeof(DWORD));
+    if ((pfs->bd.acode == NULL) || (pfs->aiCode == NULL)) {
+	StratFirstEnd(pfs);
+	return NULL;
+    }
+    return pfs;
+}
+
+
+/***    StratFirstEnd - End built-in strategy "first"
+ *
+ */
+VOID WINAPI StratFirstEnd(void *pv)
+{
+    PFIRSTSTATE pfs = pv;
+    int     res;
+
+    if (pfs->acsOpen != NULL)
+	for (res=0; res<pfs->bd.cResult; res++)
+	    SetEnd(&pfs->acsOpen[res]);
+    free(pfs->acsOpen);
+    SetEnd(&pfs->cs);
+    BoardEnd(&pfs->bd);
+    BookEnd(&pfs->bk);
+    free(pfs->aiCode);
+    free(pfs->aiGuessWork);
+    free(pfs->acPart);
+    free(pfs);
+}
+
+
+/***    StratFirstGuess - Guess first code still consistent with feedback
+ *
+ *      Entry
+ *          pv        - state from StratFirstBegin or StratMinimaxBegin
+ *          asmove    - moves so far this game
+ *          cMove     - count of moves so far
+ *          apegGuess - receives guess
+ *
+ *      Exit
+ *          Returns TRUE; guess filled in.
+ *          Returns FALSE if no code fits the feedback.
+ *
+ *      Filters only by moves not seen before, so a game costs about as
+ *      much as SolveCode.  RankCode finds each move's guess in the
+ *      Feedback Table, whoever chose it.  Also plays "minimax" (see
+ *      StratMinimaxBegin), guessing what the Opening Book or ChooseGuess
+ *      picks instead of the first code.
+ */
+BOOL WINAPI StratFirstGuess(void *pv, PSMOVE asmove, int cMove,
+			    BYTE *apegGuess)
+{
+    CODE    code;
+    int     i;
+    DWORD   iGuess;
+    PFIRSTSTATE pfs = pv;
+    PACKED  pk;
+    RESULT  res;
+
+    if (pfs->fSet)                      // Too many codes to list
+	return StratFirstGuessSet(pfs,asmove,cMove,apegGuess);
+
+    if ((cMove == 0) || (cMove < pfs->cMove)) { // New game
+	for (pfs->c=0; pfs->c<pfs->bd.cCode; pfs->c++)
+	    pfs->aiCode[pfs->c] = pfs->c;
+	pfs->cMove = 0;
+    }
+
+    for (; pfs->cMove<cMove; pfs->cMove++) {
+	for (i=0; i<pfs->bd.cPeg; i++)
+	    code.apeg[i] = asmove[pfs->cMove].apeg[i];
+	res = pfs->bd.mpPosClrToResult[asmove[pfs->cMove].cPosition]
+				      [asmove[pfs->cMove].cColor];
+	iGuess = RankCode(&pfs->bd,&code);
+	if (iGuess == iCodeNone) {
+	    PackCode(&pfs->bd,&code,&pk); // Not a code here; score it anyway
+	    pfs->c = FilterCodes(&pfs->bd,pfs->aiCode,pfs->c,&pk,res);
+	}
+	else if (pfs->bd.presTable != NULL)
+	    pfs->c = FilterCodesTable(&pfs->bd,pfs->aiCode,pfs->c,iGuess,res);
+	else if (pfs->bd.pff != NULL)
+	    pfs->c = FilterCodesFeed(&pfs->bd,pfs->aiCode,pfs->c,iGuess,res);
+	else if (pfs->bd.aqwSlice != NULL)
+	    pfs->c = FilterCodesSliced(&pfs->bd,pfs->aiCode,pfs->c,
+				       &pfs->bd.apacked[iGuess],res);
+	else
+	    pfs->c = FilterCodes(&pfs->bd,pfs->aiCode,pfs->c,
+				 &pfs->bd.apacked[iGuess],res);
+    }
+
+    if (pfs->c == 0)                    // Feedback contradicts itself
+	return FALSE;
+    if (!pfs->fMinimax)
+	iGuess = pfs->aiCode[0];
+    else if ((cMove == 0) && (pfs->iGuessFirst != iCodeNone))
+	iGuess = pfs->iGuessFirst;      // Every game opens the same way
+    else {
+	iGuess = BookGuess(&pfs->bk,&pfs->bd,asmove,cMove);
+	if (iGuess == iCodeNone)        // Out of the Opening Book
+	    iGuess = ChooseGuess(&pfs->bd,pfs->aiCode,pfs->c,
+				 pfs->aiGuessWork,pfs->acPart);
+	if (cMove == 0)
+	    pfs->iGuessFirst = iGuess;
+    }
+    memcpy(apegGuess,pfs->bd.acode[iGuess].apeg,pfs->bd.cPeg);
+    return TRUE;
+}
+
+
+/***    StratFirstGuessSet - StratFirstGuess, keeping codes in a CODESET
+ *
+ *      Entry
+ *          pfs       - state from StratFirstBegin, fSet TRUE
+ *          asmove    - moves so far this game
+ *          cMove     - count of moves so far
+ *          apegGuess - receives guess
+ *
+ *      Exit
+ *          Returns TRUE; guess filled in.
+ *          Returns FALSE if no code fits the feedback, or out of memory.
+ *
+ *      The first game splits every code by its first guess, once, with
+ *      SetPartition, and keeps the parts: every game after it opens with
+ *      the same guess, so takes the part for its RESULT with SetAnd
+ *      instead of scoring every code again.  Later moves use SetFilter.
+ *      See "Performance Notes (21)" above.
+ */
+BOOL StratFirstGuessSet(PFIRSTSTATE pfs, PSMOVE asmove, int cMove,
+			BYTE *apegGuess)
+{
+    CODE    code;
+    BOOL    fOK;
+    int     i;
+    DWORD   iGuess;
+    PACKED  pk;
+    RESULT  res;
+
+    if ((cMove == 0) || (cMove < pfs->cMove)) { // New game
+	SetEnd(&pfs->cs);
+	if (!SetBegin(&pfs->cs,&pfs->bd))
+	    return FALSE;
+	pfs->cMove = 0;
+    }
+
+    for (; pfs->cMove<cMove; pfs->cMove++) {
+	for (i=0; i<pfs->bd.cPeg; i++)
+	    code.apeg[i] = asmove[pfs->cMove].apeg[i];
+	res = pfs->bd.mpPosClrToResult[asmove[pfs->cMove].cPosition]
+				      [asmove[pfs->cMove].cColor];
+	PackCode(&pfs->bd,&code,&pk);
+	if ((pfs->acsOpen == NULL) && (pfs->cs.c == pfs->bd.cCode)) {
+	    pfs->acsOpen = malloc(pfs->bd.cResult*sizeof(CODESET));
+	    if ((pfs->acsOpen != NULL) &&
+		SetPartition(&pfs->cs,&pfs->bd,&pk,pfs->acsOpen))
+		pfs->codeOpen = code;
+	    else {                      // Filter this game's codes instead
+		free(pfs->acsOpen);
+		pfs->acsOpen = NULL;
+	    }
+	}
+	if ((pfs->acsOpen != NULL) && (pfs->cs.c == pfs->bd.cCode) &&
+	    (memcmp(code.apeg,pfs->codeOpen.apeg,pfs->bd.cPeg) == 0))
+	    fOK = SetAnd(&pfs->cs,&pfs->acsOpen[res]);
+	else
+	    fOK = SetFilter(&pfs->cs,&pfs->bd,&pk,res);
+	if (!fOK)
+	    return FALSE;
+    }
+
+    iGuess = SetFirst(&pfs->cs);
+    if (iGuess == iCodeNone)            // Feedback contradicts itself
+	return FALSE;
+    UnrankCode(&pfs->bd,iGuess,&code);
+    memcpy(apegGuess,code.apeg,pfs->bd.cPeg);
+    return TRUE;
+}
+
+
+/***    StratGeneticBegin - Start built-in strategy "genetic"
+ *
+ *      Entry
+ *          cPeg, cColor, fDup - board
+ *
+ *      Exit
+ *          Returns strategy state, or NULL if board is bad.
+ *
+ *      "genetic" evolves an island of codes on each processor until one
+ *      fits every move, and guesses it.  Like "propagate", it never
+ *      lists codes.  See MMSTRAT.H, and "Performance Notes (24)" above.
+ */
+void * WINAPI StratGeneticBegin(int cPeg, int cColor, BOOL fDup)
+{
+    int     i;
+    unsigned idThread;
+    PGENEISLAND pgi;
+    PGENESTATE pgs;
+    SYSTEM_INFO si;
+
+    pgs = malloc(sizeof(GENESTATE));
+    if (pgs == NULL)
+	return NULL;
+    memset(pgs,0,sizeof(GENESTATE));
+    if (!BoardBegin(&pgs->bd,cPeg,cColor,fDup,FALSE)) {
+	free(pgs);
+	return NULL;
+    }
+
+    // An island per processor, but two at least, so migrants go somewhere
+    GetSystemInfo(&si);
+    pgs->cIsland = max(2,min(maxGeneIsland,(int)si.dwNumberOfProcessors));
+    for (i=0; i<pgs->cIsland; i++) {
+	pgs->agi[i].seed = ((DWORD)rand() << 15) ^ (DWORD)rand();
+	pgs->agi[i].pgs = pgs;
+    }
+    InitializeCriticalSection(&pgs->cs);
+
+    // A thread for each island but the first, which the guesser evolves;
+    // an island left without one is the guesser's too
+    for (i=1; i<pgs->cIsland; i++) {
+	pgi = &pgs->agi[i];
+	pgi->hevGo = CreateEvent(NULL,FALSE,FALSE,NULL);
+	pgi->hevDone = CreateEvent(NULL,FALSE,FALSE,NULL);
+	if ((pgi->hevGo != NULL) && (pgi->hevDone != NULL))
+	    pgi->hThread = (HANDLE)_beginthreadex(NULL,0,GeneThread,pgi,0,
+						  &idThread);
+    }
+    return pgs;
+}
+
+
+/***    StratGeneticEnd - End built-in strategy "genetic"
+ *
+ */
+VOID WINAPI StratGeneticEnd(void *pv)
+{
+    int     i;
+    PGENEISLAND pgi;
+    PGENESTATE pgs = pv;
+
+    pgs->fQuit = TRUE;
+    for (i=0; i<pgs->cIsland; i++) {
+	pgi = &pgs->agi[i];
+	if (pgi->hThread != NULL) {
+	    SetEvent(pgi->hevGo);       // Sees fQuit and exits
+	    WaitForSingleObject(pgi->hThread,INFINITE);
+	    CloseHandle(pgi->hThread);
+	}
+	if (pgi->hevGo != NULL)
+	    CloseHandle(pgi->hevGo);
+	if (pgi->hevDone != NULL)
+	    CloseHandle(pgi->hevDone);
+    }
+    DeleteCriticalSection(&pgs->cs);
+    BoardEnd(&pgs->bd);
+    free(pgs);
+}
+
+
+/***    StratGeneticGuess - Guess a code evolved to fit the feedback
+ *
+ *      Entry
+ *          pv        - state from StratGeneticBegin
+ *          asmove    - moves so far this game
+ *          cMove     - count of moves so far
+ *          apegGuess - receives guess
+ *
+ *      Exit
+ *          Returns TRUE; guess filled in.  It fits every move, unless no
+ *          island found one that does in cGeneMax generations; then it
+ *          is the closest found.  pgs->cGuess, cFit, cEval and cGen say
+ *          how it has gone, for /bench.
+ *
+ *      Islands keep their codes from one guess to the next in a game.
+ */
+BOOL WINAPI StratGeneticGuess(void *pv, PSMOVE asmove, int cMove,
+			      BYTE *apegGuess)
+{
+    HANDLE  ahevDone[maxGeneIsland];
+    CODE    code;
+    DWORD   cThread = 0;
+    int     i;
+    int     iCode;
+    int     iMatch;
+    int     iMatchRes;
+    int     iPos;
+    int     iPosRes;
+    PGENEISLAND pgi;
+    PGENEMOVE pgm;
+    PGENESTATE pgs = pv;
+    int     res;
+
+    if ((cMove == 0) || (cMove < pgs->cMove)) { // New game
+	pgs->cMove = 0;
+	for (i=0; i<pgs->cIsland; i++) {
+	    pgi = &pgs->agi[i];
+	    pgi->fMigrant = FALSE;
+	    for (iCode=0; iCode<cGenePop; iCode++) {
+		for (iPos=0; iPos<pgs->bd.cPeg; iPos++)
+		    pgi->acode[iCode].apeg[iPos] =
+			(BYTE)GeneRandom(&pgi->seed,pgs->bd.cColor);
+		GeneRepair(&pgs->bd,&pgi->acode[iCode],&pgi->seed);
+	    }
+	}
+    }
+
+    // How far each RESULT is from what each new move got
+    for (; pgs->cMove < cMove; pgs->cMove++) {
+	pgm = &pgs->agm[pgs->cMove];
+	memcpy(code.apeg,asmove[pgs->cMove].apeg,pgs->bd.cPeg);
+	PackCode(&pgs->bd,&code,&pgm->pk);
+	iPos = asmove[pgs->cMove].cPosition;
+	iMatch = iPos + asmove[pgs->cMove].cColor;
+	for (res=0; res<pgs->bd.cResult; res++) {
+	    iPosRes = pgs->bd.mpResultToPos[res];
+	    iMatchRes = iPosRes + pgs->bd.mpResultToClr[res];
+	    pgm->acDist[res] = (BYTE)(abs(iPosRes - iPos) +
+				      abs(iMatchRes - iMatch));
+	}
+    }
+
+    pgs->fFound = FALSE;
+    pgs->fitBest = 0xFFFF;              // Worse than any code
+    for (i=0; i<pgs->cIsland; i++) {
+	pgs->agi[i].cEval = 0;
+	pgs->agi[i].cGen = 0;
+    }
+    for (i=0; i<pgs->cIsland; i++)
+	if (pgs->agi[i].hThread != NULL) {
+	    SetEvent(pgs->agi[i].hevGo);
+	    ahevDone[cThread++] = pgs->agi[i].hevDone;
+	}
+    for (i=0; i<pgs->cIsland; i++)     // This thread takes the rest
+	if (pgs->agi[i].hThread == NULL)
+	    GeneEvolve(pgs,&pgs->agi[i]);
+    if (cThread != 0)
+	WaitForMultipleObjects(cThread,ahevDone,TRUE,INFINITE);
+
+    for (i=0; i<pgs->cIsland; i++) {
+	pgs->cEval += pgs->agi[i].cEval;
+	pgs->cGen += pgs->agi[i].cGen;
+    }
+    pgs->cGuess++;
+    if (pgs->fFound)
+	pgs->cFit++;
+    memcpy(apegGuess,pgs->codeBest.apeg,pgs->bd.cPeg);
+    return TRUE;
+}
+
+
+/***    StratMinimaxBegin - Start built-in strategy "minimax"
+ *
+ *      Entry
+ *          cPeg, cColor, fDup - board
+ *
+ *      Exit
+ *          Returns strategy state, or NULL if board is too big.
+ *
+ *      "minimax" is "first", except each guess is the one ChooseGuess
+ *      picks, or the Opening Book has for it.  See MMSTRAT.H.
+ */
+void * WINAPI StratMinimaxBegin(int cPeg, int cColor, BOOL fDup)
+{
+    PFIRSTSTATE pfs;
+
+    pfs = StratFirstBegin(cPeg,cColor,fDup);
+    if (pfs == NULL)
+	return NULL;
+    if (pfs->fSet) {                    // ChooseGuess needs codes listed
+	StratFirstEnd(pfs);
+	return NULL;
+    }
+    pfs->fMinimax = TRUE;
+    pfs->iGuessFirst = iCodeNone;
+    BookBegin(&pfs->bk,&pfs->bd,"minimax"); // Use book, if there is one
+    pfs->aiGuessWork = malloc(pfs->bd.cCode*sizeof(DWORD));
+    pfs->acPart = malloc(pfs->bd.cCode*pfs->bd.cResult*sizeof(DWORD));
+    if ((pfs->aiGuessWork == NULL) || (pfs->acPart == NULL)) {
+	StratFirstEnd(pfs);
+	return NULL;
+    }
+    return pfs;
+}
+
+
+/***    StratPropBegin - Start built-in strategy "propagate"
+ *
+ *      Entry
+ *          cPeg, cColor, fDup - board
+ *
+ *      Exit
+ *          Returns strategy state, or NULL if board is bad.
+ *
+ *      "propagate" guesses a code that fits every move, as "first"
+ *      does, but finds it by search instead of keeping every code that
+ *      fits, so it plays boards with far too many codes to list.
+ *      See MMSTRAT.H, and "Performance Notes (23)" above.
+ */
+void * WINAPI StratPropBegin(int cPeg, int cColor, BOOL fDup)
+{
+    PPROPSTATE pprs;
+
+    pprs = malloc(sizeof(PROPSTATE));
+    if (pprs == NULL)
+	return NULL;
+    memset(pprs,0,sizeof(PROPSTATE));
+    if (!BoardBegin(&pprs->bd,cPeg,cColor,fDup,FALSE)) {
+	free(pprs);
+	return NULL;
+    }
+    return pprs;
+}
+
+
+/***    StratPropEnd - End built-in strategy "propagate"
+ *
+ */
+VOID WINAPI StratPropEnd(void *pv)
+{
+    PPROPSTATE pprs = pv;
+
+    BoardEnd(&pprs->bd);
+    free(pprs);
+}
+
+
+/***    StratPropGuess - Guess a code consistent with feedback
+ *
+ *      Entry
+ *          pv        - state from StratPropBegin
+ *          asmove    - moves so far this game
+ *          cMove     - count of moves so far
+ *          apegGuess - receives guess
+ *
+ *      Exit
+ *          Returns TRUE; guess filled in.
+ *          Returns FALSE if no code fits the feedback.
+ *
+ *      Takes in only moves not seen before, as StratFirstGuess does.
+ *      If PropSearch runs out of nodes before finding a code that fits,
+ *      guesses the code PropFill makes of where it got furthest.
+ */
+BOOL WINAPI StratPropGuess(void *pv, PSMOVE asmove, int cMove,
+			   BYTE *apegGuess)
+{
+    int     i;
+    PPROPSTATE pprs = pv;
+
+    if ((cMove == 0) || (cMove < pprs->cMove)) { // New game
+	pprs->cMove = 0;
+	for (i=0; i<pprs->bd.cPeg; i++)
+	    pprs->afRoot[i] = (WORD)((1L << pprs->bd.cColor) - 1);
+	for (i=0; i<pprs->bd.cColor; i++) {
+	    pprs->acMin[i] = 0;
+	    pprs->acMax[i] = (BYTE)(pprs->bd.fDup ? pprs->bd.cPeg : 1);
+	}
+    }
+    while (pprs->cMove < cMove)
+	PropMove(pprs,&asmove[pprs->cMove]);
+
+    pprs->cNode = 0;
+    pprs->cPegBest = -1;
+    if (!PropSearch(pprs,pprs->afRoot,pprs->acMin,pprs->acMax)) {
+	if ((pprs->cNode < maxPropNode) || (pprs->cPegBest < 0))
+	    return FALSE;               // Feedback contradicts itself
+	PropFill(pprs);                 // Out of time; best we have
+    }
+    memcpy(apegGuess,pprs->code.apeg,pprs->bd.cPeg);
+    return TRUE;
+}
+
+
+/***    StreamCodes - Pass every code that fits some moves to a consumer
+ *
+ *      Entry
+ *          pbd    - board; codes need not be listed
+ *          asmove - moves codes must fit
+ *          cMove  - count of moves (0..maxMove)
+ *          pfn    - gets the codes that fit, a block at a time
+ *          pv     - passed to pfn
+ *
+ *      Exit
+ *          Returns count of codes passed to pfn; 0 if none fit, or the
+ *          board has too many codes to index.  Codes are in order within
+ *          a call of pfn, but blocks come in any order, and pfn is never
+ *          called by two threads at once.  Once pfn returns FALSE, no
+ *          more blocks are started.
+ *
+ *      Big jobs are split among threads, one per processor.
+ *      See "Performance Notes (22)" above.
+ */
+DWORD StreamCodes(PBOARD pbd, PSMOVE asmove, int cMove, PFNSTREAM pfn,
+		  void *pv)
+{
+    HANDLE  ahThread[maxStreamThread];
+    CODE    code;
+    DWORD   cThread = 0;
+    int     i;
+    unsigned idThread;
+    STREAMJOB sj;
+    SYSTEM_INFO si;
+
+    if (pbd->cCode == 0)                // Too many codes to index
+	return 0;
+    memset(&sj,0,sizeof(STREAMJOB));
+    sj.pbd = pbd;
+    sj.cMove = cMove;
+    for (i=0; i<cMove; i++) {
+	memcpy(code.apeg,asmove[i].apeg,pbd->cPeg);
+	PackCode(pbd,&code,&sj.apkGuess[i]);
+	sj.ares[i] = pbd->mpPosClrToResult[asmove[i].cPosition]
+					  [asmove[i].cColor];
+	if (sj.ares[i] == RESULT_NONE)  // No code gets that
+	    return 0;
+    }
+    sj.pfn = pfn;
+    sj.pv = pv;
+    InitializeCriticalSection(&sj.cs);
+
+    if ((double)max(cMove,1)*pbd->cCode >= cPairThread) {
+	GetSystemInfo(&si);
+	for (cThread=0;
+	     (cThread < si.dwNumberOfProcessors-1) &&
+	     (cThread < maxStreamThread) &&
+	     ((cThread+1)*cStreamCode < pbd->cCode);
+	     cThread++) {
+	    ahThread[cThread] = (HANDLE)_beginthreadex(NULL,0,StreamThread,
+						       &sj,0,&idThread);
+	    if (ahThread[cThread] == NULL)
+		break;
+	}
+    }
+    StreamThread(&sj);                  // This thread helps too
+    if (cThread != 0) {
+	WaitForMultipleObjects(cThread,ahThread,TRUE,INFINITE);
+	while (cThread-- > 0)
+	    CloseHandle(ahThread[cThread]);
+    }
+    DeleteCriticalSection(&sj.cs);
+    return sj.c;
+}
+
+
+/***    StreamFirst - PFNSTREAM that keeps the lowest code
+ *
+ *      Entry
+ *          pv     - DWORD, lowest code so far; iCodeNone before any
+ *          aiCode - codes, in order
+ *          c      - count of codes, never 0
+ *
+ *      Exit
+ *          Returns TRUE; lowest code kept in *pv.
+ */
+BOOL StreamFirst(void *pv, DWORD *aiCode, DWORD c)
+{
+    DWORD  *piFirst = pv;
+
+    if (aiCode[0] < *piFirst)
+	*piFirst = aiCode[0];
+    return TRUE;
+}
+
+
+/***    StreamThread - Pass codes that fit, a block at a time
+ *
+ *      Entry
+ *          pv - STREAMJOB
+ *
+ *      Exit
+ *          Returns 0; every block this thread took has been streamed.
+ *
+ *      Takes cStreamCode codes at a time, making each from the one
+ *      before, slices them a tile of cCodeBlock at a time, and scores
+ *      each move against only the lanes every move before it kept.
+ *      Mostly only the last peg changes from one code to the next, so
+ *      the other pegs' planes get a whole run of lanes at once.
+ *      See "Performance Notes (22)" above.
+ */
+unsigned __stdcall StreamThread(void *pv)
+{
+    DWORD   aiCode[cStreamCode];        // Codes in this block that fit
+    ULONGLONG aqwRes[maxResult];        // Lanes getting each RESULT
+    ULONGLONG aqwTile[cCodeBlock/cLaneSlice*maxPegBoard*maxColorBoard];
+					// Codes in this tile, sliced
+    DWORD   c;
+    DWORD   cBlock;
+    CODE    code;
+    int     cqw;
+    DWORD   cTile;
+    WORD    fPrefix;            // Colors of all but last peg, if no repeats
+    DWORD   i;
+    DWORD   iCode;
+    DWORD   iCodeFirst;
+    int     iMove;
+    int     iPeg;
+    int     iPegLast;
+    int     peg;
+    PSTREAMJOB psj = pv;
+    PBOARD  pbd = psj->pbd;
+    ULONGLONG *pqw;             // Slice for code i
+    ULONGLONG qw;               // Lanes that fit every move so far
+    ULONGLONG qwBit;
+    ULONGLONG qwRun;            // Lanes since all but last peg changed
+
+    cqw = cqwSlice(pbd);
+    iPegLast = pbd->cPeg - 1;
+    while (!psj->fStop &&
+	   ((iCodeFirst = (DWORD)InterlockedExchangeAdd(&psj->iCodeNext,
+							cStreamCode)) <
+	    pbd->cCode)) {
+	cBlock = min(cStreamCode,pbd->cCode - iCodeFirst);
+	c = 0;
+	UnrankCode(pbd,iCodeFirst,&code);
+	fPrefix = 0;
+	if (!pbd->fDup)
+	    for (iPeg=0; iPeg<iPegLast; iPeg++)
+		fPrefix |= 1 << code.apeg[iPeg];
+	for (iCode=iCodeFirst; iCode<iCodeFirst+cBlock; iCode+=cTile) {
+	    cTile = min(cCodeBlock,iCodeFirst+cBlock - iCode);
+	    memset(aqwTile,0,
+		   (cTile+cLaneSlice-1)/cLaneSlice*cqw*sizeof(ULONGLONG));
+	    qwRun = 0;
+	    for (i=0; i<cTile; i++) {
+		pqw = &aqwTile[i/cLaneSlice*cqw];
+		qwBit = (ULONGLONG)1 << (i % cLaneSlice);
+		pqw[iPegLast*pbd->cColor + code.apeg[iPegLast]] |= qwBit;
+		qwRun |= qwBit;
+		for (peg=code.apeg[iPegLast]+1;
+		     (peg < pbd->cColor) && (fPrefix & (1 << peg)); peg++)
+		    ;
+		if ((peg < pbd->cColor) && (i % cLaneSlice != cLaneSlice-1) &&
+		    (i != cTile-1)) {   // Only the last peg changes
+		    code.apeg[iPegLast] = (BYTE)peg;
+		    continue;
+		}
+		for (iPeg=0; iPeg<iPegLast; iPeg++) // End of run or slice
+		    pqw[iPeg*pbd->cColor + code.apeg[iPeg]] |= qwRun;
+		qwRun = 0;
+		if (peg < pbd->cColor)
+		    code.apeg[iPegLast] = (BYTE)peg;
+		else {
+		    NextCode(pbd,&code);
+		    fPrefix = 0;
+		    if (!pbd->fDup)
+			for (iPeg=0; iPeg<iPegLast; iPeg++)
+			    fPrefix |= 1 << code.apeg[iPeg];
+		}
+	    }
+	    for (i=0; i<cTile; i+=cLaneSlice) {
+		qw = (cTile-i < cLaneSlice) ?
+			 ((ULONGLONG)1 << (cTile-i)) - 1 : ~(ULONGLONG)0;
+		for (iMove=0; (iMove < psj->cMove) && (qw != 0); iMove++) {
+		    ScoreSliced(pbd,&psj->apkGuess[iMove],
+				&aqwTile[i/cLaneSlice*cqw],qw,aqwRes);
+		    qw = aqwRes[psj->ares[iMove]];
+		}
+		for (; qw != 0; qw ^= qwBit) {
+		    qwBit = qw & (~qw+1);       // Lowest lane left
+		    aiCode[c++] = iCode + i + CountLanes(qwBit-1);
+		}
+	    }
+	}
+	if (c == 0)
+	    continue;
+	EnterCriticalSection(&psj->cs);
+	if (!psj->fStop) {
+	    psj->c += c;
+	    if (!(*psj->pfn)(psj->pv,aiCode,c))
+		psj->fStop = TRUE;
+	}
+	LeaveCriticalSection(&psj->cs);
+    }
+    return 0;
+}
+
+
+/***    TestGuess - Test player guess against code
+ *
+ *      Entry   g.iMove = move index
+ *              g.amove(g.iMove) = player guess
+ *              g.guessCode = code
+ *
+ *      Exit    returns TRUE if guess matches code
+ *              else returns FALSE
+ *
+ *              g.amove[g.iMove].cPosition filled in.
+ *              g.amove[g.iMove].cColor filled in.
+ */
+BOOL TestGuess(VOID)
+{
+    CODE    code;               // The code
+    CODE    codeGuess;          // Player guess
+    int     i;
+    int     n = g.iMove;        // Current move index
+    PACKED  pk;
+    RESULT  res;
+
+    // Convert guess and code for Solver Engine
+    for (i=0; i<nPeg; i++) {
+	codeGuess.apeg[i] = (BYTE)g.amove[n].guess[i];
+	code.apeg[i] = (BYTE)g.guessCode[i];
+    }
+
+    if (g.fAdvGame) {   // Adversary answers, then picks a code to fit
+	PackCode(&g.bd,&codeGuess,&pk);
+	res = AdversaryAnswer(&g.bd,g.aiAdv,&g.cAdv,&pk,g.aresAdv);
+	for (i=0; i<nPeg; i++)
+	    g.guessCode[i] = g.bd.acode[g.aiAdv[0]].apeg[i];
+    }
+    else
+	res = ScoreCode(&g.bd,&codeGuess,&code);
+
+    // Store findings
+    g.amove[n].cPosition = g.bd.mpResultToPos[res];
+    g.amove[n].cColor    = g.bd.mpResultToClr[res];
+
+    // If correct postions same as number of pegs, we have a winner
+    return (res == g.bd.resWin);
+}
+
+
+#ifdef TIMING
+/***    TimingDump - Show latency report
+ *
+ *      Entry
+ *          hwnd - main window
+ */
+VOID TimingDump(HWND hwnd)
+{
+    char    ach[nEvent*64+64];
+
+    TimingReport(ach);
+    MessageBox(hwnd,ach,"Latency (microseconds)",MB_OK);
+}
+
+
+/***    TimingRecord - Add one latency to histogram for an event type
+ *
+ *      Entry
+ *          ev       - Event type
+ *          pliStart - Performance counter when event started
+ *
+ *      Exit
+ *          ev histogram updated.  See "Performance Notes (5)" above.
+ */
+VOID TimingRecord(EVENT ev, LARGE_INTEGER *pliStart)
+{
+    int         iBucket;
+    int         iLog;
+    LARGE_INTEGER li;
+    PHISTOGRAM  phist;
+    DWORD       us;
+
+    QueryPerformanceCounter(&li);
+    if (g.liFreq.QuadPart == 0)         // No performance counter
+	return;
+    us = (DWORD)(((li.QuadPart - pliStart->QuadPart) * 1000000) /
+		 g.liFreq.QuadPart);
+
+    // Bucket is 4*(log2(us)-1) plus next 2 bits of us; 0..3 are exact
+    if (us < 4)
+	iBucket = us;
+    else {
+	for (iLog=2; (us >> (iLog+1)) != 0; iLog++)
+	    ;
+	iBucket = 4*(iLog-1) + ((us >> (iLog-2)) & 3);
+    }
+
+    phist = &g.ahist[ev];
+    phist->cSample++;
+    phist->acBucket[iBucket]++;
+    if (us > phist->usMax)
+	phist->usMax = us;
+}
+
+
+/***    TimingReport - Format latency report
+ *
+ *      Entry
+ *          psz - buffer for at least nEvent*64+64 characters
+ *
+ *      Exit
+ *          psz filled with one line per event type that was seen:
+ *              name count p50 p99 max
+ *          Percentiles are the top of the bucket they fall in.
+ */
+VOID TimingReport(char *psz)
+{
+    DWORD       c;
+    DWORD       c50,c99;
+    int         ev;
+    int         i;
+    PHISTOGRAM  phist;
+    DWORD       us;
+    DWORD       us50,us99;
+
+    psz += wsprintf(psz,"Event\tCount\tp50\tp99\tMax\n");
+    for (ev=0; ev<nEvent; ev++) {
+	phist = &g.ahist[ev];
+	if (phist->cSample == 0)        // Never happened
+	    continue;
+
+	c50 = (phist->cSample+1)/2;     // Events at or below p50
+	c99 = phist->cSample - phist->cSample/100; // Events at or below p99
+	us50 = us99 = 0;
+	c = 0;
+	for (i=0; i<nBucket; i++) {
+	    if (phist->acBucket[i] == 0)
+		continue;
+	    c += phist->acBucket[i];
+
+	    // Top of bucket i; the last one's is 2^32-1, too big for int
+	    if (i < 4)
+		us = i;
+	    else
+		us = (DWORD)(((ULONGLONG)(4+(i&3)+1) << (i/4-1)) - 1);
+
+	    if ((c - phist->acBucket[i] < c50) && (c >= c50))
+		us50 = us;              // p50 falls in this bucket
+	    if (c >= c99) {
+		us99 = us;
+		break;
+	    }
+	}
+	us50 = min(us50,phist->usMax);  // Bucket top may be past max
+	us99 = min(us99,phist->usMax);
+
+	psz += wsprintf(psz,"%s\t%lu\t%lu\t%lu\t%lu\n",
+			apszEvent[ev],phist->cSample,us50,us99,phist->usMax);
+    }
+}
+
+
+/***    TimingSave - Write latency report to file named by MM_TIMING
+ *
+ */
+VOID TimingSave(VOID)
+{
+    char    ach[nEvent*64+64];
+    FILE   *pfile;
+    char   *pszFile;
+
+    pszFile = getenv("MM_TIMING");
+    if (pszFile == NULL)                // Not asked for
+	return;
+
+    pfile = fopen(pszFile,"w");
+    if (pfile == NULL)
+	return;
+    TimingReport(ach);
+    fputs(ach,pfile);
+    fclose(pfile);
+}
+#endif // TIMING
+
+
+/***    Tournament - Rank codebreaker strategies
+ *
+ *      Entry
+ *          g.tny has board, sample, report file, and plugin names.
+ *
+ *      Exit
+ *          Returns TRUE; report written.
+ *          Returns FALSE if tournament could not run; user has been told.
+ *
+ *      See "Performance Notes (9)" above.
+ */
+BOOL Tournament(VOID)
+{
+    char    ach[(maxStrategy+4)*128];
+    HANDLE  ahThread[maxStrategy];
+    FILETIME ftCreate;
+    FILETIME ftExit;
+    FILETIME ftKernel;
+    FILETIME ftUser;
+    CODE    code;
+    BOOL    fOK = FALSE;
+    int     i;
+    DWORD   iSecret;
+    unsigned idThread;
+    LARGE_INTEGER li;
+    double  ns;
+    FILE   *pfile;
+    PBOARD  pbd = &g.tny.bd;
+    char   *psz;
+    PSTRATEGY pstrat;
+
+    if (!TournamentLoad())
+	goto Done;
+
+    // Pick the codes to play
+    g.tny.cSecret = pbd->cCode;
+    if ((g.tny.cSample != 0) &&
+	((pbd->acode == NULL) || (g.tny.cSample < pbd->cCode)))
+	g.tny.cSecret = g.tny.cSample;
+    else if (g.tny.fAdversary)          // Every Adversary game is alike
+	g.tny.cSecret = 1;
+    srand(g.tny.seed);
+    if (pbd->acode == NULL) {           // Too many to list; make codes
+	g.tny.apkSecret = malloc(g.tny.cSecret*sizeof(PACKED));
+	if (g.tny.apkSecret == NULL)
+	    goto Done;
+	for (iSecret=0; iSecret<g.tny.cSecret; iSecret++) {
+	    RandomCode(pbd,&code);
+	    PackCode(pbd,&code,&g.tny.apkSecret[iSecret]);
+	}
+    }
+    else {
+	g.tny.aiSecret = malloc(g.tny.cSecret*sizeof(DWORD));
+	if (g.tny.aiSecret == NULL)
+	    goto Done;
+	for (iSecret=0; iSecret<g.tny.cSecret; iSecret++)
+	    if (g.tny.cSecret == pbd->cCode)    // Every code
+		g.tny.aiSecret[iSecret] = iSecret;
+	    else                                // rand() may give only 15 bits
+		g.tny.aiSecret[iSecret] = (((DWORD)rand() << 15) ^ rand()) %
+					  pbd->cCode;
+    }
+
+    // Play every strategy at once, then wait for all of them
+    QueryPerformanceCounter(&li);
+    for (i=0; i<g.tny.cStrat; i++) {
+	pstrat = &g.tny.astrat[i];
+	pstrat->hThread = (HANDLE)_beginthreadex(NULL,0,TournamentThread,
+						 pstrat,0,&idThread);
+	if (pstrat->hThread == NULL) {
+	    g.tny.cStrat = i;           // Only wait for ones started
+	    break;
+	}
+	ahThread[i] = pstrat->hThread;
+    }
+    WaitForMultipleObjects(g.tny.cStrat,ahThread,TRUE,INFINITE);
+    ns = BenchElapsed(&li);
+
+    for (i=0; i<g.tny.cStrat; i++) {
+	pstrat = &g.tny.astrat[i];
+	if (GetThreadTimes(pstrat->hThread,&ftCreate,&ftExit,
+			   &ftKernel,&ftUser))
+	    pstrat->cpu = ((LONGLONG)ftKernel.dwHighDateTime << 32) +
+			  ftKernel.dwLowDateTime +
+			  ((LONGLONG)ftUser.dwHighDateTime << 32) +
+			  ftUser.dwLowDateTime;
+    }
+
+    // Rank and report
+    qsort(g.tny.astrat,g.tny.cStrat,sizeof(STRATEGY),CompareStrategy);
+
+    psz = ach;
+    psz += sprintf(psz,"Tournament on %dx%d%s, %lu %s, %.0f ms\n",
+		   pbd->cColor,pbd->cPeg,pbd->fDup ? "" : "u",g.tny.cSecret,
+		   g.tny.fAdversary ? "games against Adversary" : "codes",
+		   ns/1e6);
+    psz += sprintf(psz,"Rank\tAverage\tWorst\tLost\tus/move\tStrategy\n");
+    for (i=0; i<g.tny.cStrat; i++) {
+	pstrat = &g.tny.astrat[i];
+	psz += sprintf(psz,"%d\t%.3f\t%d\t%lu\t%.2f\t%s\n",i+1,
+		       pstrat->cWin ? (double)pstrat->cMove/pstrat->cWin : 0.0,
+		       pstrat->cMoveMax,pstrat->cLose,
+		       pstrat->cMove ? pstrat->cpu/(10.0*pstrat->cMove) : 0.0,
+		       pstrat->pszName);
+    }
+
+    pfile = g.tny.pszReport ? fopen(g.tny.pszReport,"w") : NULL;
+    if (pfile != NULL) {
+	fputs(ach,pfile);
+	fclose(pfile);
+    }
+    else
+	MessageBox(NULL,ach,"MasterMind Tournament",MB_OK);
+    fOK = TRUE;
+
+Done:
+    TournamentFree();
+    return fOK;
+}
+
+
+/***    TournamentFree - Free what TournamentLoad and Tournament got
+ *
+ *      Entry
+ *          g.tny as left by TournamentLoad, in whole or in part
+ *
+ *      Exit
+ *          Threads closed, plugins unloaded, board freed.
+ */
+VOID TournamentFree(VOID)
+{
+    int     i;
+    PSTRATEGY pstrat;
+
+    for (i=0; i<g.tny.cStrat; i++) {
+	pstrat = &g.tny.astrat[i];
+	if (pstrat->hThread != NULL)
+	    CloseHandle(pstrat->hThread);
+	if (pstrat->hmod != NULL)
+	    FreeLibrary(pstrat->hmod);
+    }
+    free(g.tny.aiSecret);
+    free(g.tny.apkSecret);
+    BoardEnd(&g.tny.bd);
+}
+
+
+/***    TournamentLoad - Load strategies and list board codes
+ *
+ *      Entry
+ *          g.tny has board and plugin names.
+ *
+ *      Exit
+ *          Returns TRUE; plugins loaded, built-ins added, g.tny.bd set up
+ *          (and listed, with its Feedback Table and slices, unless a
+ *          /tournament only plays a sample).
+ *          Returns FALSE if something could not be loaded; user has been
+ *          told.  Either way, call TournamentFree when done.
+ */
+BOOL TournamentLoad(VOID)
+{
+    int     i;
+    PSTRATEGY pstrat;
+
+    // Load plugins
+    for (i=0; i<g.tny.cStrat; i++)
+	if (!StrategyLoad(&g.tny.astrat[i]))
+	    return FALSE;
+
+    // Built-in strategies always play, but for "genetic", which plays
+    // only when named: which code it guesses depends on its threads
+    pstrat = &g.tny.astrat[g.tny.cStrat++];
+    pstrat->pszName = "first";
+    StrategyLoad(pstrat);
+    pstrat = &g.tny.astrat[g.tny.cStrat++];
+    pstrat->pszName = "minimax";
+    StrategyLoad(pstrat);
+    pstrat = &g.tny.astrat[g.tny.cStrat++];
+    pstrat->pszName = "propagate";
+    StrategyLoad(pstrat);
+
+    // List board codes; a sample of random codes will do without them
+    if (!BoardBegin(&g.tny.bd,g.tny.cPeg,g.tny.cColor,g.tny.fDup,TRUE) ||
+	((g.tny.bd.acode == NULL) &&
+	 (g.fAnalyze || g.tny.fAdversary || (g.tny.cSample == 0)))) {
+	MessageBox(NULL,"Board is too big to list every code; "
+			"use /tournament /sample n.","MasterMind",
+		   MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+
+    // Build what built-in strategies share (see BoardShare) before any
+    // of them start; a Feedback File is opened by each of them instead
+    if ((g.tny.bd.acode != NULL) &&
+	(((g.tny.bd.cCode <= maxCodeTable) && !BoardTable(&g.tny.bd)) ||
+	 (g.tny.fSliced && !BoardSlice(&g.tny.bd)))) {
+	MessageBox(NULL,"Not enough memory to play this board.","MasterMind",
+		   MB_ICONEXCLAMATION | MB_OK);
+	return FALSE;
+    }
+    return TRUE;
+}
+
+
+/***    TournamentThread - Play one strategy against every tournament code
+ *
+ *      Entry
+ *          pv - STRATEGY to play
+ *
+ *      Exit
+ *          Returns 0; strategy's results filled in.
+ */
+unsigned __stdcall TournamentThread(void *pv)
+{
+    DWORD  *aiAdv = NULL;       // Adversary's codes, if playing Adversary
+    RESULT *aresAdv = NULL;     // Room for Adversary's RESULTs
+    int     cMove;
+    DWORD   iSecret;
+    PBOARD  pbd = &g.tny.bd;
+    PSTRATEGY pstrat = pv;
+    void   *pvStrat;
+
+    if (g.tny.fAdversary) {
+	aiAdv = malloc(pbd->cCode*sizeof(DWORD));
+	aresAdv = malloc(pbd->cCode*sizeof(RESULT));
+    }
+    pvStrat = (*pstrat->pfnBegin)(pbd->cPeg,pbd->cColor,pbd->fDup);
+    if ((pvStrat == NULL) ||            // Strategy cannot play this board
+	(g.tny.fAdversary && ((aiAdv == NULL) || (aresAdv == NULL)))) {
+	pstrat->cLose = g.tny.cSecret;
+	goto Done;
+    }
+
+    for (iSecret=0; iSecret<g.tny.cSecret; iSecret++) {
+	if (g.tny.fAdversary)
+	    cMove = PlayGame(pbd,pstrat,pvStrat,NULL,aiAdv,aresAdv);
+	else if (g.tny.apkSecret != NULL)
+	    cMove = PlayGame(pbd,pstrat,pvStrat,&g.tny.apkSecret[iSecret],
+			     NULL,NULL);
+	else
+	    cMove = PlayGame(pbd,pstrat,pvStrat,
+			     &pbd->apacked[g.tny.aiSecret[iSecret]],NULL,NULL);
+	if (cMove != 0) {
+	    pstrat->cWin++;
+	    pstrat->cMove += cMove;
+	    pstrat->cMoveMax = max(pstrat->cMoveMax,cMove);
+	}
+	else
+	    pstrat->cLose++;
+    }
+
+    (*pstrat->pfnEnd)(pvStrat);
+
+Done:
+    free(aiAdv);
+    free(aresAdv);
+    return 0;
+}
+
+
+/***    UnrankCode - Get code from its index
+ *
+ *      Entry
+ *          pbd   - board; codes need not be listed
+ *          iCode - index of code, less than pbd->cCode
+ *          pcode - receives code
+ *
+ *      Exit
+ *          *pcode is the code RankCode gives iCode for.  If the codes are
+ *          listed, it is just copied from pbd->acode.
+ */
+VOID UnrankCode(PBOARD pbd, DWORD iCode, PCODE pcode)
+{
+    DWORD   d;                  // This peg's digit of iCode
+    WORD    fUsed = 0;          // Bit for each color used so far
+    int     i;
+    int     peg;
+
+    if (pbd->acode != NULL) {
+	*pcode = pbd->acode[iCode];
+	return;
+    }
+    for (i=0; i<pbd->cPeg; i++) {
+	d = iCode / pbd->aiPlace[i];
+	iCode %= pbd->aiPlace[i];
+	if (pbd->fDup)
+	    peg = (int)d;
+	else {                          // d'th color not used before
+	    for (peg=0; (fUsed & (1 << peg)) || (d-- != 0); peg++)
+		;
+	    fUsed |= 1 << peg;
+	}
+	pcode->apeg[i] = (BYTE)peg;
+    }
+}
+
+
+/***    WndProc - Main Window Procedure
+ *
+ */
+long FAR PASCAL WndProc(HWND hwnd,UINT msg,UINT wParam,LONG lParam)
+    {
+    BOOL        f;
+    HDC         hdc;
+    PAINTSTRUCT ps;
+#ifdef TIMING
+    LARGE_INTEGER liStart;              // Time message handling started
+#endif
+
+    // Record input for replay, if asked
+    if (g.pfileRecord)
+	RecordMessage(msg,wParam,lParam);
+
+    switch(msg) {
+	case WM_CREATE:
+	    CreateButtons(hwnd);
+	    NewGame();  // Start a new game
+#ifdef TIMING
+	    AppendMenu(GetSubMenu(GetMenu(hwnd),1),MF_STRING, // Help menu
+		       IDM_TIMING,"&Timing...");
+#endif
+	    return 0;
+
+	case WM_KEYDOWN:
+	    switch (wParam) {
+		case VK_RETURN:
+		    // See if guess is allowed
+		    if (g.fGuessAllowed) {
+			// Simulate push of Guess button
+			TimingStart(liStart);
+			DoCommand(hwnd,IDC_GUESS,0L);
+			TimingStop(EV_KEY,liStart);
+			return 0;
+		    }
+		    break;
+	    }
+	    break;
+
+	case WM_COMMAND:
+	    TimingStart(liStart);
+	    DoCommand(hwnd,wParam,lParam);
+	    TimingStop(EV_COMMAND,liStart);
+	    return 0;
+
+	case WM_RBUTTONDBLCLK:
+	case WM_RBUTTONUP:
+	    // See if guess is allowed
+	    if (g.fGuessAllowed) {
+		// Simulate push of Guess button
+		TimingStart(liStart);
+		DoCommand(hwnd,IDC_GUESS,0L);
+		TimingStop(EV_BUTTONUP,liStart);
+		return 0;
+	    }
+	    break;
+
+	case WM_LBUTTONDBLCLK:
+	case WM_LBUTTONDOWN:
+	case WM_LBUTTONUP:
+	case WM_MOUSEMOVE:
+
+	    // If game is over, do not process mouse
+	    if (g.fGameOver)
+		break;	// Let Windows handle the message
+
+	    TimingStart(liStart);
+	    f = DoMouse(hwnd,msg,wParam,lParam);
+	    TimingStop((msg == WM_MOUSEMOVE)   ? EV_MOUSEMOVE  :
+		       (msg == WM_LBUTTONDOWN) ? EV_BUTTONDOWN :
+		       (msg == WM_LBUTTONUP)   ? EV_BUTTONUP   : EV_DBLCLK,
+		       liStart);
+	    if (f)      // We handled it
+		return TRUE;    // Get out of here
+	    break;  // Let Windows handle the message
+
+	case WM_TIMER:
+	    TimingStart(liStart);
+	    AnimateTick(hwnd);
+	    TimingStop(EV_FRAME,liStart);
+	    return 0;
+
+	case MSG_HINT:
+	    HintShow(hwnd,(LONG)wParam,(DWORD)lParam);
+	    return 0;
+
+	case WM_PAINT:
+	    TimingStart(liStart);
+	    hdc = BeginPaint(hwnd, &ps);
+	    PaintBoard(hdc);
+	    EndPaint(hwnd,&ps);
+	    TimingStop(EV_PAINT,liStart);
+	    return 0;
+
+	case WM_DESTROY:
+	    DestroyButtons();
+	    PostQuitMessage(0);
+	    return 0;
+    }
+    return DefWindowProc(hwnd,msg,wParam,lParam);
+}